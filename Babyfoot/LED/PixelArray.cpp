@@ -4,8 +4,12 @@ PixelArray::PixelArray(int size)
 {
     pbufsize = size;
     pbuf = new int[pbufsize];
-    SetAll(0x0); // initialise memory to zeros
-    
+    // initialise memory to zeros, every pixel has to be sent once
+    for (int i=0 ; i < pbufsize; i++) {
+        pbuf[i] = 0;
+    }
+    ClearDirty();
+    MarkDirty(0, pbufsize - 1);
 }
 
 PixelArray::~PixelArray()
@@ -15,49 +19,73 @@ PixelArray::~PixelArray()
 
 void PixelArray::SetAll(unsigned int value)
 {
-    // for each pixel
-    for (int i=0 ; i < pbufsize; i++) {
-        __set_pixel(i,value);
-    }
+    SetRange(0, pbufsize - 1, value);
 }
 
 
 void PixelArray::SetAllI(unsigned char value)
 {
-    // for each pixel
-    for (int i=0 ; i < pbufsize; i++) {
-        __set_pixel_component(i,3,value);
-    }
+    __set_all_component(3,value);
 }
 
 
 
 void PixelArray::SetAllR(unsigned char value)
 {
-    // for each pixel
-    for (int i=0 ; i < pbufsize; i++) {
-        __set_pixel_component(i,2,value);
-    }
+    __set_all_component(2,value);
 }
 
 void PixelArray::SetAllG(unsigned char value)
 {
-    // for each pixel
-    for (int i=0 ; i < pbufsize; i++) {
-        __set_pixel_component(i,1,value);
-    }
+    __set_all_component(1,value);
 }
 
 void PixelArray::SetAllB(unsigned char value)
 {
-    // for each pixel
-    for (int i=0 ; i < pbufsize; i++) {
-        __set_pixel_component(i,0,value);
-    }
+    __set_all_component(0,value);
 }
 
 
+void PixelArray::SetRange(int first, int last, unsigned int value)
+{
+    if (first < 0) first = 0;
+    if (last >= pbufsize) last = pbufsize - 1;
+
+    // Whole words, only the pixels that change are marked
+    int changedFirst = pbufsize, changedLast = -1;
+    for (int i = first; i <= last; i++) {
+        if (pbuf[i] != (int)value) {
+            pbuf[i] = value;
+            if (changedFirst > i) changedFirst = i;
+            changedLast = i;
+        }
+    }
+    MarkDirty(changedFirst, changedLast);
+}
+
 
+void PixelArray::SetGradient(int first, int last, unsigned int from, unsigned int to)
+{
+    int span = last - first;
+    int changedFirst = pbufsize, changedLast = -1;
+
+    for (int i = (first < 0) ? 0 : first; (i <= last) && (i < pbufsize); i++) {
+        unsigned int value = 0;
+        // Each of the I, R, G, B bytes goes linearly from 'from' to 'to'
+        for (int shift = 0; shift < 32; shift += 8) {
+            int a = (from >> shift) & 0xFF;
+            int b = (to >> shift) & 0xFF;
+            int c = span ? a + ((b - a) * (i - first)) / span : a;
+            value |= (unsigned int)c << shift;
+        }
+        if (pbuf[i] != (int)value) {
+            pbuf[i] = value;
+            if (changedFirst > i) changedFirst = i;
+            changedLast = i;
+        }
+    }
+    MarkDirty(changedFirst, changedLast);
+}
 
 
 void PixelArray::Set(int i, unsigned int value)
@@ -105,21 +133,69 @@ int* PixelArray::getBuf()
 }
 
 
+int PixelArray::Size()
+{
+    return pbufsize;
+}
+
+
+void PixelArray::MarkDirty(int first, int last)
+{
+    if (first < 0) first = 0;
+    if (last >= pbufsize) last = pbufsize - 1;
+    if (first > last) {
+        return;
+    }
+    if (__dirtyFirst > first) __dirtyFirst = first;
+    if (__dirtyLast < last) __dirtyLast = last;
+}
+
+
+void PixelArray::ClearDirty()
+{
+    __dirtyFirst = pbufsize;
+    __dirtyLast = -1;
+}
+
+
 // set either the I,R,G,B value of specific pixel channel
 void PixelArray::__set_pixel_component(int index, int channel, int value)
 {
+    // AND with 0x00 shifted to the right location to clear the bits, then set the bits with an OR
+    int pixel = (pbuf[index] & ~(0xFFu << (8 * channel))) | ((unsigned int)value << (8 * channel));
+
+    if (pbuf[index] != pixel) {
+        pbuf[index] = pixel;
+        MarkDirty(index, index);
+    }
+}
 
-    // AND with 0x00 shifted to the right location to clear the bits
-    pbuf[index] &= ~(0xFF << (8 * channel));
 
-    // Set the bits with an OR
-    pbuf[index] |= (value << (8 * channel));
+// set either the I,R,G,B value of every pixel
+void PixelArray::__set_all_component(int channel, int value)
+{
+    // Mask and bits computed once for the whole array
+    int mask = ~(0xFFu << (8 * channel));
+    int bits = (unsigned int)value << (8 * channel);
+    int changedFirst = pbufsize, changedLast = -1;
+
+    for (int i=0 ; i < pbufsize; i++) {
+        int pixel = (pbuf[i] & mask) | bits;
+        if (pbuf[i] != pixel) {
+            pbuf[i] = pixel;
+            if (changedFirst > i) changedFirst = i;
+            changedLast = i;
+        }
+    }
+    MarkDirty(changedFirst, changedLast);
 }
 
 
-// set either the I,R,G,B value of specific pixel channel
+// set the whole IIRRGGBB word of specific pixel
 void PixelArray::__set_pixel(int index, int value)
 {
-    // AND with 0x00 shifted to the right location to clear the bits
-    pbuf[index] = value;
+    if (pbuf[index] != value) {
+        pbuf[index] = value;
+        MarkDirty(index, index);
+    }
 }
\ No newline at end of file
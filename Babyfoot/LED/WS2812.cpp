@@ -2,20 +2,35 @@
 
 WS2812::WS2812(PinName pin, int size, int zeroHigh, int zeroLow, int oneHigh, int oneLow) : __gpo(pin)
 {
-    __size = size;
-    __transmitBuf = new bool[size * FRAME_SIZE];
-    __use_II = OFF;
-    __II = 0xFF; // set global intensity to full
+    __init(size);
     __outPin = pin;
     
     // Default values designed for K64f. Assumes GPIO toggle takes ~0.4us
     setDelays(zeroHigh, zeroLow, oneHigh, oneLow);
 }
 
+WS2812::WS2812(int size) : __gpo(NC)
+{
+    __init(size);
+    __outPin = NC;
+    setDelays(0, 0, 0, 0);
+}
+
+void WS2812::__init(int size)
+{
+    __size = size;
+    __transmitBuf = new unsigned char[size * FRAME_BYTES];
+    __lastColor = new int[size];
+    __use_II = OFF;
+    __II = 0xFF; // set global intensity to full
+    __loadPattern();
+}
+
 
 WS2812::~WS2812()
 {
     delete[] __transmitBuf;
+    delete[] __lastColor;
 }
 
 void WS2812::setDelays(int zeroHigh, int zeroLow, int oneHigh, int oneLow) {
@@ -25,51 +40,114 @@ void WS2812::setDelays(int zeroHigh, int zeroLow, int oneHigh, int oneLow) {
     __oneLow = oneLow;
 }
 
-void WS2812::__loadBuf(int buf[],int r_offset, int g_offset, int b_offset) {
+void WS2812::__loadPattern() {
+    unsigned char sf; // scaling factor for  II
+
+    // set the intensity scaling factor (global, none), per pixel is applied in __loadBuf
+    if (__use_II == GLOBAL) {
+        sf = __II;
+    } else {
+        sf = 0xFF;
+    }
+
+    // One entry per colour byte instead of a multiply per component and pixel
+    for (int c = 0; c < 256; c++) {
+        __pattern[c] = (c * sf) >> 8;
+    }
+
+    // Every pixel has to be encoded again
+    __encoded = false;
+    __aligned = false;
+}
+
+int WS2812::__loadBuf(int buf[],int r_offset, int g_offset, int b_offset) {
+    int encoded = 0;
+
+    // Wrap the offsets once, then step them along with the pixel index
+    int r = r_offset % __size;
+    int g = g_offset % __size;
+    int b = b_offset % __size;
+    __aligned = (r == 0) && (g == 0) && (b == 0);
+
     for (int i = 0; i < __size; i++) {
         int color = 0;
-               
-        color |= ((buf[(i+g_offset)%__size] & 0x0000FF00));
-        color |= ((buf[(i+r_offset)%__size] & 0x00FF0000));
-        color |=  (buf[(i+b_offset)%__size] & 0x000000FF);
+
+        color |= ((buf[g] & 0x0000FF00));
+        color |= ((buf[r] & 0x00FF0000));
+        color |=  (buf[b] & 0x000000FF);
         color |= (buf[i] & 0xFF000000);
-        
-        // Outut format : GGRRBB
-        // Inout format : IIRRGGBB
-        unsigned char agrb[4] = {0x0, 0x0, 0x0, 0x0};
-    
-        unsigned char sf; // scaling factor for  II
-    
-        // extract colour fields from incoming
-        // 0 = green, 1 = red, 2 = blue, 3 = brightness        
-        agrb[0] = (color & 0x0000FF00) >> 8;
-        agrb[1] = (color & 0x00FF0000) >> 16;
-        agrb[2] = color  & 0x000000FF;
-        agrb[3] = (color & 0xFF000000) >> 24;
-    
-        // set the intensity scaling factor (global, per pixel, none)
-        if (__use_II == GLOBAL) {
-            sf = __II;
-        } else if (__use_II == PER_PIXEL) {
-            sf = agrb[3];
-        } else {
-            sf = 0xFF;
+
+        if (++r == __size) r = 0;
+        if (++g == __size) g = 0;
+        if (++b == __size) b = 0;
+
+        // Same colour as in the transmit buffer, nothing to encode
+        if (__encoded && (color == __lastColor[i])) {
+            continue;
         }
-        
-        // Apply the scaling factor to each othe colour components
-        for (int clr = 0; clr < 3; clr++) {
-            agrb[clr] = ((agrb[clr] * sf) >> 8);
-            
-            for (int j = 0; j < 8; j++) {
-                if (((agrb[clr] << j) & 0x80) == 0x80) {
-                    // Bit is set (checks MSB fist)
-                    __transmitBuf[(i * FRAME_SIZE) + (clr * 8) + j] = 1;
-                } else {
-                    // Bit is clear
-                    __transmitBuf[(i * FRAME_SIZE) + (clr * 8) + j] = 0;
-                }
-            }
+        __encodePixel(i, color);
+        encoded++;
+    }
+
+    __encoded = true;
+    return encoded;
+}
+
+bool WS2812::__loadArray(PixelArray &px, int &first, int &last) {
+    int *buf = px.getBuf();
+
+    // First frame, new brightness or offsets: the whole strip
+    if (!__encoded || !__aligned) {
+        __loadBuf(buf, 0, 0, 0);
+        px.ClearDirty();
+        first = 0;
+        last = __size - 1;
+        return true;
+    }
+
+    // Nothing set since the last frame
+    if (!px.IsDirty()) {
+        return false;
+    }
+
+    int dirtyFirst = px.DirtyFirst();
+    int dirtyLast = (px.DirtyLast() < __size) ? px.DirtyLast() : __size - 1;
+    px.ClearDirty();
+
+    // Without offsets each LED only depends on its own pixel
+    first = __size;
+    last = -1;
+    for (int i = dirtyFirst; i <= dirtyLast; i++) {
+        if (buf[i] == __lastColor[i]) {
+            continue;
         }
+        __encodePixel(i, buf[i]);
+        if (first > i) first = i;
+        last = i;
+    }
+    return (last >= 0);
+}
+
+void WS2812::__encodePixel(int i, int color) {
+    unsigned char *out = __transmitBuf + i * FRAME_BYTES;
+
+    __lastColor[i] = color;
+
+    // Outut format : GGRRBB
+    // Inout format : IIRRGGBB
+    unsigned char green = (color & 0x0000FF00) >> 8;
+    unsigned char red = (color & 0x00FF0000) >> 16;
+    unsigned char blue = color & 0x000000FF;
+
+    if (__use_II == PER_PIXEL) {
+        unsigned char sf = (color & 0xFF000000) >> 24;
+        out[0] = (green * sf) >> 8;
+        out[1] = (red * sf) >> 8;
+        out[2] = (blue * sf) >> 8;
+    } else {
+        out[0] = __pattern[green];
+        out[1] = __pattern[red];
+        out[2] = __pattern[blue];
     }
 }
 
@@ -77,39 +155,55 @@ void WS2812::write(int buf[]) {
     write_offsets(buf, 0, 0, 0);
 }
 
+void WS2812::write(PixelArray &px) {
+    int first, last;
+
+    if (__loadArray(px, first, last)) {
+        __sendBuf(last + 1);
+    }
+}
+
 void WS2812::write_offsets (int buf[],int r_offset, int g_offset, int b_offset) {
-    int i, j;
-    
     // Load the transmit buffer
     __loadBuf(buf, r_offset, g_offset, b_offset);
+    __sendBuf(__size);
+}
+
+void WS2812::__sendBuf(int leds) {
+    int i, j;
+    unsigned char byte, mask;
 
     // Entering timing critical section, so disabling interrupts
     __disable_irq();
     
     // Begin bit-banging
-    for (i = 0; i < FRAME_SIZE * __size; i++) {
-        j = 0;
-        if (__transmitBuf[i]){
-            __gpo = 1;
-            for (; j < __oneHigh; j++) {
-                //__nop();
-                wait_us(1);
-            }
-            __gpo = 0;
-            for (; j < __oneLow; j++) {
-                //__nop();
-                wait_us(1);
-            }
-        } else {
-            __gpo = 1;
-            for (; j < __zeroHigh; j++) {
-                //__nop();
-                wait_us(1);
-            }
-            __gpo = 0;
-            for (; j < __zeroLow; j++) {
-                //__nop();
-                wait_us(1);
+    for (i = 0; i < FRAME_BYTES * leds; i++) {
+        byte = __transmitBuf[i];
+        // MSB first
+        for (mask = 0x80; mask; mask >>= 1) {
+            j = 0;
+            if (byte & mask){
+                __gpo = 1;
+                for (; j < __oneHigh; j++) {
+                    //__nop();
+                    wait_us(1);
+                }
+                __gpo = 0;
+                for (; j < __oneLow; j++) {
+                    //__nop();
+                    wait_us(1);
+                }
+            } else {
+                __gpo = 1;
+                for (; j < __zeroHigh; j++) {
+                    //__nop();
+                    wait_us(1);
+                }
+                __gpo = 0;
+                for (; j < __zeroLow; j++) {
+                    //__nop();
+                    wait_us(1);
+                }
             }
         }
     }
@@ -126,9 +220,11 @@ void WS2812::useII(BrightnessControl bc)
     } else {
         __use_II = OFF;
     }
+    __loadPattern();
 }
 
 void WS2812::setII(unsigned char II)
 {
     __II = II;
+    __loadPattern();
 }
\ No newline at end of file
@@ -0,0 +1,168 @@
+/* Copyright (c) 2012 cstyles, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef WS2812_H
+#define WS2812_H
+
+#include "mbed.h"
+#include "PixelArray.h"
+
+#define FRAME_SIZE 24 // Bits per LED
+#define FRAME_BYTES (FRAME_SIZE / 8) // Bytes per LED in the transmit buffer
+
+//!Library for the WS2812 RGB LED with integrated controller
+/*!
+The WS2812 is controller that is built into a range of LEDs
+*/
+class WS2812
+{
+public:
+    enum BrightnessControl { OFF, GLOBAL, PER_PIXEL };
+
+    /**
+    *   Constructor
+    *
+    * @param pin Output pin. Connect to "Din" on the first WS2812 in the strip
+    * @param size Number of LEDs in your strip
+    * @param zeroHigh How many NOPs to insert to ensure TOH is properly generated. See library description for more information.
+    * @param zeroLow How many NOPs to insert to ensure TOL is properly generated. See library description for more information.
+    * @param oneHigh How many NOPs to insert to ensure T1H is properly generated. See library description for more information.
+    * @param oneLow How many NOPs to insert to ensure T1L is properly generated. See library description for more information.
+    *
+    */
+    WS2812(PinName pin, int size, int zeroHigh, int zeroLow, int oneHigh, int oneLow);
+
+    /*!
+    Destroys instance.
+    */
+    ~WS2812();
+
+    /**
+    *   Sets the timing parameters for the bit-banged signal
+    *
+    * @param zeroHigh How many NOPs to insert to ensure TOH is properly generated. See library description for more information.
+    * @param zeroLow How many NOPs to insert to ensure TOL is properly generated. See library description for more information.
+    * @param oneHigh How many NOPs to insert to ensure T1H is properly generated. See library description for more information.
+    * @param oneLow How many NOPs to insert to ensure T1L is properly generated. See library description for more information.
+    *
+    */
+    void setDelays(int zeroHigh, int zeroLow, int oneHigh, int oneLow);
+
+    /**
+    *   Writes the given buffer to the LED strip with the given offsets.
+    *   NOTE: This function is timing critical, therefore interrupts are disabled during the transmission section.
+    *
+    * @param buf Pointer to the PixelArray buffer
+    * @param r_offset The offset where each each pixel pulls its red component. Wraps to beginning if end is reached.
+    * @param g_offset The offset where each each pixel pulls its green component. Wraps to beginning if end is reached.
+    * @param b_offset The offset where each each pixel pulls its blue component. Wraps to beginning if end is reached.
+    *
+    */
+    void write_offsets(int buf[], int r_offset = 0, int g_offset = 0, int b_offset = 0);
+
+    /**
+    *   Writes the given buffer to the LED strip
+    *   NOTE: This function is timing critical, therefore interrupts are disabled during the transmission section.
+    *
+    * @param buf Pointer to the PixelArray buffer
+    *
+    */
+    void write(int buf[]);
+
+    /**
+    *   Writes the pixels changed since the last write of the PixelArray.
+    *   Nothing is sent when no pixel changed, and the frame stops after the last changed LED:
+    *   the LEDs after it keep their colour.
+    *   NOTE: This function is timing critical, therefore interrupts are disabled during the transmission section.
+    *
+    * @param px The PixelArray, its dirty range is cleared
+    *
+    */
+    void write(PixelArray &px);
+
+    /**
+    *   Sets the brightness mode
+    *
+    * @param bc The brightness control. Defaults to OFF. Possible values include OFF, GLOBAL, and PER_PIXEL
+    *
+    */
+    void useII(BrightnessControl bc);
+
+    /**
+    *   Sets the global brightness level.
+    *
+    * @param II The brightness level. Possible values include 0 - 255 (0x00 - 0xFF).
+    *
+    */
+    void setII(unsigned char II);
+
+protected:
+    /**
+    *   Constructor for output back ends that do not bit-bang a GPIO, e.g. WS2812_SPI
+    *
+    * @param size Number of LEDs in your strip
+    *
+    */
+    WS2812(int size);
+
+    /**
+    *   Encodes the pixels that changed since the last call into the transmit buffer
+    *
+    * @param buf Pointer to the PixelArray buffer
+    * @param r_offset, g_offset, b_offset As for write_offsets()
+    * @returns The number of pixels encoded
+    *
+    */
+    int __loadBuf(int buf[], int r_offset = 0, int g_offset = 0, int b_offset = 0);
+
+    /**
+    *   Encodes the dirty pixels of a PixelArray that changed since the last call into the transmit buffer
+    *
+    * @param px The PixelArray, its dirty range is cleared
+    * @param first Set to the first LED encoded
+    * @param last Set to the last LED encoded
+    * @returns false if no LED changed, nothing has to be sent
+    *
+    */
+    bool __loadArray(PixelArray &px, int &first, int &last);
+
+    int __size;
+    // Packed GRB bytes, MSB first, FRAME_BYTES per LED
+    unsigned char *__transmitBuf;
+
+private:
+    void __init(int size);
+    void __loadPattern();
+    void __encodePixel(int i, int color);
+    void __sendBuf(int leds);
+
+    int __zeroHigh, __zeroLow, __oneHigh, __oneLow;
+    unsigned char __II;
+    BrightnessControl __use_II;
+    // Transmitted byte of each colour byte for the OFF and GLOBAL scalings
+    unsigned char __pattern[256];
+    // Colour each pixel was last encoded from, valid when __encoded is set
+    int *__lastColor;
+    bool __encoded;
+    // The last __loadBuf() had no offsets, so each LED is encoded from its own pixel
+    bool __aligned;
+    PinName __outPin;
+    DigitalOut __gpo;
+};
+
+#endif
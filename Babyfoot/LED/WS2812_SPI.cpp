@@ -0,0 +1,96 @@
+#include "WS2812_SPI.h"
+
+// Two WS2812 bits, MSB first: 0 -> 1000, 1 -> 1100
+const unsigned char WS2812_SPI::__spiPattern[4] = {0x88, 0x8C, 0xC8, 0xCC};
+
+WS2812_SPI::WS2812_SPI(SPI &spi, int size, int frequency)
+    : WS2812(size), __spi(spi)
+{
+    __spi.format(8, 0);
+    __spi.frequency(frequency);
+
+    // The reset time is sent as low bytes after the frame
+    __resetBytes = (int)(((long long)WS2812_SPI_RESET_US * frequency + 7999999) / 8000000);
+    __spiSize = 1 + size * FRAME_BYTES * 4 + __resetBytes;
+    __spiBuf = new unsigned char[__spiSize];
+    memset(__spiBuf, 0, __spiSize);
+    __spiLeds = 0;
+    __busy = false;
+}
+
+WS2812_SPI::~WS2812_SPI()
+{
+    while (__busy) {
+        sleep();
+    }
+    delete[] __spiBuf;
+}
+
+void WS2812_SPI::__encodeSpi(int first, int leds) {
+    // Leading byte low, so the line is low before the first bit whatever the MOSI idle level
+    unsigned char *out = __spiBuf + 1 + first * FRAME_BYTES * 4;
+
+    for (int i = first * FRAME_BYTES; i < leds * FRAME_BYTES; i++) {
+        unsigned char byte = __transmitBuf[i];
+        *out++ = __spiPattern[byte >> 6];
+        *out++ = __spiPattern[(byte >> 4) & 0x3];
+        *out++ = __spiPattern[(byte >> 2) & 0x3];
+        *out++ = __spiPattern[byte & 0x3];
+    }
+}
+
+void WS2812_SPI::write(int buf[]) {
+    write_offsets(buf, 0, 0, 0);
+}
+
+void WS2812_SPI::write(PixelArray &px) {
+    int first, last;
+
+    // The SPI buffer is still being sent
+    while (__busy) {
+        sleep();
+    }
+
+    if (__loadArray(px, first, last)) {
+        __send(first, last + 1);
+    }
+}
+
+void WS2812_SPI::write_offsets (int buf[],int r_offset, int g_offset, int b_offset) {
+    // The SPI buffer is still being sent
+    while (__busy) {
+        sleep();
+    }
+
+    __loadBuf(buf, r_offset, g_offset, b_offset);
+    __send(0, __size);
+}
+
+void WS2812_SPI::__send(int first, int leds) {
+    // The LEDs a shorter frame overwrote with its reset time are expanded again
+    if (first > __spiLeds) {
+        first = __spiLeds;
+    }
+    __encodeSpi(first, leds);
+    __spiLeds = leds;
+
+    // The reset time follows the last LED sent
+    int length = 1 + leds * FRAME_BYTES * 4 + __resetBytes;
+    memset(__spiBuf + length - __resetBytes, 0, __resetBytes);
+
+#if DEVICE_SPI_ASYNCH
+    __busy = true;
+    __spi.transfer<unsigned char>(__spiBuf, length, NULL, 0,
+                                  callback(this, &WS2812_SPI::__transferDone),
+                                  SPI_EVENT_COMPLETE);
+#else
+    __spi.write((const char *)__spiBuf, length, NULL, 0);
+#endif
+}
+
+#if DEVICE_SPI_ASYNCH
+void WS2812_SPI::__transferDone(int event)
+{
+    __busy = false;
+}
+#endif
@@ -0,0 +1,113 @@
+/* Copyright (c) 2012 cstyles, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef WS2812_SPI_H
+#define WS2812_SPI_H
+
+#include "mbed.h"
+#include "WS2812.h"
+
+#define WS2812_SPI_FREQUENCY 2500000 // Hz, 4 SPI bits per WS2812 bit
+#define WS2812_SPI_RESET_US 50 // Low time latching the frame
+
+//!WS2812 output on the MOSI pin of an SPI bus
+/*!
+Each WS2812 bit is sent as 4 SPI bits, 1000 for a 0 and 1100 for a 1, so the
+timings come from the SPI clock instead of delay loops, and interrupts stay
+enabled. At 2.5MHz T0H is 0.4us, T1H 0.8us and a bit 1.6us; T0H and T1H stay
+in the datasheet ranges from 2.4 to 3.6MHz, the longer low times are
+tolerated as long as they are well below the 50us reset.
+
+Every SPI byte holds two whole WS2812 bits and ends low, so a pause between
+bytes only stretches a low time. With DEVICE_SPI_ASYNCH the frame is sent in
+the background (DMA or interrupts) and write() returns at once.
+*/
+class WS2812_SPI : public WS2812
+{
+public:
+    /**
+    *   Constructor
+    *
+    * @param spi SPI bus. Connect its MOSI pin to "Din" on the first WS2812 in the strip
+    * @param size Number of LEDs in your strip
+    * @param frequency SPI clock, Hz
+    *
+    */
+    WS2812_SPI(SPI &spi, int size, int frequency = WS2812_SPI_FREQUENCY);
+
+    /*!
+    Destroys instance.
+    */
+    ~WS2812_SPI();
+
+    /**
+    *   Writes the given buffer to the LED strip with the given offsets.
+    *   Waits for the previous frame to be sent, interrupts stay enabled.
+    *
+    * @param buf Pointer to the PixelArray buffer
+    * @param r_offset The offset where each each pixel pulls its red component. Wraps to beginning if end is reached.
+    * @param g_offset The offset where each each pixel pulls its green component. Wraps to beginning if end is reached.
+    * @param b_offset The offset where each each pixel pulls its blue component. Wraps to beginning if end is reached.
+    *
+    */
+    void write_offsets(int buf[], int r_offset = 0, int g_offset = 0, int b_offset = 0);
+
+    /**
+    *   Writes the given buffer to the LED strip
+    *
+    * @param buf Pointer to the PixelArray buffer
+    *
+    */
+    void write(int buf[]);
+
+    /**
+    *   Writes the pixels changed since the last write of the PixelArray.
+    *   Nothing is sent when no pixel changed, and the frame stops after the last changed LED.
+    *   Waits for the previous frame to be sent, interrupts stay enabled.
+    *
+    * @param px The PixelArray, its dirty range is cleared
+    *
+    */
+    void write(PixelArray &px);
+
+    /**
+    *   True while a frame is being sent
+    */
+    bool busy() const { return __busy; }
+
+private:
+    void __encodeSpi(int first, int leds);
+    void __send(int first, int leds);
+#if DEVICE_SPI_ASYNCH
+    void __transferDone(int event);
+#endif
+
+    // SPI byte of each pair of WS2812 bits
+    static const unsigned char __spiPattern[4];
+
+    SPI &__spi;
+    // Leading low byte, 4 SPI bytes per transmit buffer byte, then the reset time
+    unsigned char *__spiBuf;
+    int __spiSize;
+    int __resetBytes;
+    // LEDs expanded in the SPI buffer from the transmit buffer
+    int __spiLeds;
+    volatile bool __busy;
+};
+
+#endif
@@ -0,0 +1,201 @@
+/**
+*******************************************************************************
+* @file   pixel_bench.cpp
+* @brief  Host benchmark of score update frames with PixelArray dirty tracking
+*******************************************************************************
+* Plays a match on a 60 LED score strip: every frame the application redraws
+* both score bars, and a goal is scored every GOAL_FRAMES frames. Sends the
+* frames through WS2812_SPI twice, as the whole buffer with write(getBuf())
+* and as the changed pixels with write(PixelArray &), and reports the CPU time,
+* SPI bytes and line time per frame. Decodes the SPI bytes into the colours
+* latched by a simulated strip and checks that both ways show the same frames,
+* then checks the PixelArray range and dirty tracking functions.
+*
+* Build from Babyfoot/LED:
+*   g++ -O2 -std=c++11 -I../../Common/host -I. host/pixel_bench.cpp PixelArray.cpp WS2812_SPI.cpp WS2812.cpp -o pixel_bench
+* Usage: pixel_bench
+* Exits with the number of mismatches.
+*******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "WS2812_SPI.h"
+#include "PixelArray.h"
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+/* Defines -------------------------------------------------------------------*/
+#define PIXELS 60
+#define FRAMES 5000
+#define GOAL_FRAMES 250 /* A goal every 5s at 50 frames per second */
+#define TEAM_LEDS (PIXELS / 2)
+#define GOAL_LEDS 3
+#define RESET_BYTES 16 /* 50us at 2.5MHz */
+
+/* Variables -----------------------------------------------------------------*/
+static uint32_t errors = 0;
+
+/* Functions definition ------------------------------------------------------*/
+/* Score bars: red from the start of the strip, blue from the middle */
+static void draw_scores(PixelArray &px, int frame)
+{
+	int goals = frame / GOAL_FRAMES;
+	int red = ((goals + 1) / 2 * GOAL_LEDS) % (TEAM_LEDS + 1);
+	int blue = (goals / 2 * GOAL_LEDS) % (TEAM_LEDS + 1);
+	px.SetRange(0, red - 1, 0xFF2F0000);
+	px.SetRange(red, TEAM_LEDS - 1, 0xFF000000);
+	px.SetRange(TEAM_LEDS, TEAM_LEDS + blue - 1, 0xFF00002F);
+	px.SetRange(TEAM_LEDS + blue, PIXELS - 1, 0xFF000000);
+}
+
+/* Former way of drawing, one pixel at a time */
+static void draw_scores_pixels(PixelArray &px, int frame)
+{
+	int goals = frame / GOAL_FRAMES;
+	int red = ((goals + 1) / 2 * GOAL_LEDS) % (TEAM_LEDS + 1);
+	int blue = (goals / 2 * GOAL_LEDS) % (TEAM_LEDS + 1);
+	for (int i = 0; i < TEAM_LEDS; i++) {
+		px.Set(i, (i < red) ? 0xFF2F0000 : 0xFF000000);
+		px.Set(TEAM_LEDS + i, (i < blue) ? 0xFF00002F : 0xFF000000);
+	}
+}
+
+/* Latches the SPI bytes of one frame into the strip, GRB per LED */
+static void latch(std::vector<uint8_t> &strip, const std::vector<uint8_t> &sent)
+{
+	if (sent.empty()) {
+		return;
+	}
+	int leds = ((int)sent.size() - 1 - RESET_BYTES) / (FRAME_BYTES * 4);
+	for (int i = 0; i < leds * FRAME_BYTES; i++) {
+		uint8_t byte = 0;
+		for (int j = 0; j < 4; j++) {
+			uint8_t spi = sent[1 + i * 4 + j];
+			byte = (byte << 2) | ((spi & 0x40) ? 2 : 0) | ((spi & 0x04) ? 1 : 0);
+		}
+		strip[i] = byte;
+	}
+}
+
+/* Colours the strip shows for the pixels */
+static std::vector<uint8_t> expected(PixelArray &px)
+{
+	std::vector<uint8_t> grb(px.Size() * FRAME_BYTES);
+	for (int i = 0; i < px.Size(); i++) {
+		unsigned int color = px.getBuf()[i];
+		unsigned int sf = color >> 24;
+		grb[i * 3] = (((color >> 8) & 0xFF) * sf) >> 8;
+		grb[i * 3 + 1] = (((color >> 16) & 0xFF) * sf) >> 8;
+		grb[i * 3 + 2] = ((color & 0xFF) * sf) >> 8;
+	}
+	return grb;
+}
+
+static void check_frames(bool dirty)
+{
+	SPI spi(0, NC, NC);
+	WS2812_SPI ws(spi, PIXELS);
+	PixelArray px(PIXELS);
+	std::vector<uint8_t> strip(PIXELS * FRAME_BYTES, 0);
+	ws.useII(WS2812::PER_PIXEL);
+
+	for (int frame = 0; frame < 2 * GOAL_FRAMES * (2 * TEAM_LEDS / GOAL_LEDS + 2); frame += GOAL_FRAMES / 5) {
+		spi.sent.clear();
+		if (dirty) {
+			draw_scores(px, frame);
+			ws.write(px);
+		} else {
+			draw_scores_pixels(px, frame);
+			ws.write(px.getBuf());
+		}
+		latch(strip, spi.sent);
+		if (strip != expected(px)) {
+			printf("FAIL %s frame %d: strip differs from the pixels\n", dirty ? "dirty" : "full", frame);
+			errors++;
+			return;
+		}
+	}
+}
+
+static void check_pixel_array(void)
+{
+	PixelArray px(10);
+	if (!px.IsDirty() || (px.DirtyFirst() != 0) || (px.DirtyLast() != 9)) {
+		printf("FAIL new array: not dirty\n");
+		errors++;
+	}
+	px.ClearDirty();
+	px.SetRange(-3, 2, 0);
+	px.Set(12, 0x123456);
+	if (px.IsDirty()) {
+		printf("FAIL unchanged pixels: marked dirty\n");
+		errors++;
+	}
+	px.SetRange(7, 15, 0x00FF00);
+	px.SetB(3, 0x80);
+	if ((px.DirtyFirst() != 3) || (px.DirtyLast() != 9) || (px.getBuf()[9] != 0x00FF00) || (px.getBuf()[6] != 0)) {
+		printf("FAIL SetRange: dirty %d to %d\n", px.DirtyFirst(), px.DirtyLast());
+		errors++;
+	}
+	px.ClearDirty();
+	px.SetGradient(0, 4, 0xFF000000, 0x7F0000FF);
+	const int *buf = px.getBuf();
+	if ((buf[0] != (int)0xFF000000) || (buf[4] != 0x7F0000FF) || (buf[2] != (int)((0xBF << 24) | 0x7F))) {
+		printf("FAIL SetGradient: 0x%08X 0x%08X 0x%08X\n", buf[0], buf[2], buf[4]);
+		errors++;
+	}
+	if ((px.DirtyFirst() != 0) || (px.DirtyLast() != 4)) {
+		printf("FAIL SetGradient: dirty %d to %d\n", px.DirtyFirst(), px.DirtyLast());
+		errors++;
+	}
+	px.ClearDirty();
+	px.SetAllI(0x7F);
+	if ((px.DirtyFirst() != 0) || (px.DirtyLast() != 9) || (px.getBuf()[4] != 0x7F0000FF)) {
+		printf("FAIL SetAllI: dirty %d to %d\n", px.DirtyFirst(), px.DirtyLast());
+		errors++;
+	}
+}
+
+static void bench(bool dirty)
+{
+	SPI spi(0, NC, NC);
+	WS2812_SPI ws(spi, PIXELS);
+	PixelArray px(PIXELS);
+	ws.useII(WS2812::PER_PIXEL);
+	long long bytes = 0;
+	int sent = 0;
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int frame = 0; frame < FRAMES; frame++) {
+		if (dirty) {
+			draw_scores(px, frame);
+			ws.write(px);
+		} else {
+			draw_scores_pixels(px, frame);
+			ws.write(px.getBuf());
+		}
+		if (!spi.sent.empty()) {
+			bytes += spi.sent.size();
+			sent++;
+			spi.sent.clear();
+		}
+	}
+	double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+	printf("%-6s %7.2f us CPU, %7.1f SPI bytes, %7.1f us on the line per frame, %d of %d frames sent\n",
+	       dirty ? "after" : "before", us / FRAMES, (double)bytes / FRAMES,
+	       bytes * 8e6 / WS2812_SPI_FREQUENCY / FRAMES, sent, FRAMES);
+}
+
+int main()
+{
+	check_pixel_array();
+	check_frames(false);
+	check_frames(true);
+	printf("%d LEDs, both score bars redrawn every frame, a goal every %d frames\n", PIXELS, GOAL_FRAMES);
+	bench(false);
+	bench(true);
+	printf("%s: %u mismatches\n", errors ? "FAIL" : "PASS", errors);
+	return errors;
+}
@@ -0,0 +1,189 @@
+/**
+*******************************************************************************
+* @file   ws2812_check.cpp
+* @brief  Host check of the WS2812 transmit buffer encoding
+*******************************************************************************
+* Encodes random pixel arrays, offsets and brightness modes with WS2812 and
+* with the former bit per bool encoder, and compares the transmitted bit
+* streams. Then changes a few pixels per frame and checks that only those
+* are encoded again. Times both encoders on a score sized strip.
+*
+* Build from Babyfoot/LED:
+*   g++ -O2 -std=c++11 -I../../Common/host -I. host/ws2812_check.cpp WS2812.cpp PixelArray.cpp -o ws2812_check
+* Usage: ws2812_check
+* Exits with the number of mismatches.
+*******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "WS2812.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+/* Defines -------------------------------------------------------------------*/
+#define PIXELS 60
+#define FRAMES 2000
+
+/* Objects -------------------------------------------------------------------*/
+/* Exposes the transmit buffer of WS2812 */
+class WS2812Probe : public WS2812
+{
+public:
+	WS2812Probe(int size) : WS2812(0, size, 0, 5, 5, 0) {}
+
+	int load(int buf[], int r_offset, int g_offset, int b_offset)
+	{
+		return __loadBuf(buf, r_offset, g_offset, b_offset);
+	}
+
+	bool bit(int i) const
+	{
+		return (__transmitBuf[i / 8] >> (7 - (i % 8))) & 1;
+	}
+};
+
+/* Variables -----------------------------------------------------------------*/
+static uint32_t errors = 0;
+
+/* Functions definition ------------------------------------------------------*/
+/* Former WS2812::__loadBuf(), one bool per transmitted bit */
+static void reference_load(bool *out, int buf[], int size, WS2812::BrightnessControl use_II,
+                           unsigned char II, int r_offset, int g_offset, int b_offset)
+{
+	for (int i = 0; i < size; i++) {
+		int color = 0;
+		color |= ((buf[(i + g_offset) % size] & 0x0000FF00));
+		color |= ((buf[(i + r_offset) % size] & 0x00FF0000));
+		color |= (buf[(i + b_offset) % size] & 0x000000FF);
+		color |= (buf[i] & 0xFF000000);
+		unsigned char agrb[4];
+		agrb[0] = (color & 0x0000FF00) >> 8;
+		agrb[1] = (color & 0x00FF0000) >> 16;
+		agrb[2] = color & 0x000000FF;
+		agrb[3] = (color & 0xFF000000) >> 24;
+		unsigned char sf;
+		if (use_II == WS2812::GLOBAL) {
+			sf = II;
+		} else if (use_II == WS2812::PER_PIXEL) {
+			sf = agrb[3];
+		} else {
+			sf = 0xFF;
+		}
+		for (int clr = 0; clr < 3; clr++) {
+			agrb[clr] = ((agrb[clr] * sf) >> 8);
+			for (int j = 0; j < 8; j++) {
+				out[(i * FRAME_SIZE) + (clr * 8) + j] = (((agrb[clr] << j) & 0x80) == 0x80);
+			}
+		}
+	}
+}
+
+static void compare(const char *step, WS2812Probe &ws, const bool *expected, int size)
+{
+	for (int i = 0; i < size * FRAME_SIZE; i++) {
+		if (ws.bit(i) != expected[i]) {
+			printf("FAIL %-24s bit %d of LED %d\n", step, i % FRAME_SIZE, i / FRAME_SIZE);
+			errors++;
+			return;
+		}
+	}
+}
+
+static void check_random(void)
+{
+	const WS2812::BrightnessControl modes[3] = {WS2812::OFF, WS2812::GLOBAL, WS2812::PER_PIXEL};
+	for (int round = 0; round < 300; round++) {
+		int size = 1 + rand() % PIXELS;
+		std::vector<int> buf(size);
+		std::vector<char> expected(size * FRAME_SIZE);
+		for (int i = 0; i < size; i++) {
+			buf[i] = (rand() << 16) ^ rand();
+		}
+		WS2812::BrightnessControl mode = modes[round % 3];
+		unsigned char II = rand() & 0xFF;
+		int r_offset = rand() % (2 * size);
+		int g_offset = rand() % (2 * size);
+		int b_offset = rand() % (2 * size);
+		WS2812Probe ws(size);
+		ws.useII(mode);
+		ws.setII(II);
+		reference_load((bool *)&expected[0], &buf[0], size, mode, II, r_offset, g_offset, b_offset);
+		if (ws.load(&buf[0], r_offset, g_offset, b_offset) != size) {
+			printf("FAIL random: first frame not fully encoded\n");
+			errors++;
+		}
+		compare("random", ws, (bool *)&expected[0], size);
+
+		/* A few pixels change: only the LEDs taking a component from them are encoded */
+		std::vector<int> before(buf);
+		int changes = 1 + rand() % 3;
+		for (int k = 0; k < changes; k++) {
+			buf[rand() % size] ^= 1 << (rand() % 32);
+		}
+		std::vector<char> previous(expected);
+		reference_load((bool *)&expected[0], &buf[0], size, mode, II, r_offset, g_offset, b_offset);
+		int changed = 0;
+		for (int i = 0; i < size; i++) {
+			int now = (buf[(i + g_offset) % size] & 0x0000FF00) | (buf[(i + r_offset) % size] & 0x00FF0000) |
+			          (buf[(i + b_offset) % size] & 0x000000FF) | (buf[i] & 0xFF000000);
+			int was = (before[(i + g_offset) % size] & 0x0000FF00) | (before[(i + r_offset) % size] & 0x00FF0000) |
+			          (before[(i + b_offset) % size] & 0x000000FF) | (before[i] & 0xFF000000);
+			changed += (now != was);
+		}
+		int encoded = ws.load(&buf[0], r_offset, g_offset, b_offset);
+		if (encoded != changed) {
+			printf("FAIL changed: %d LEDs encoded, expected %d\n", encoded, changed);
+			errors++;
+		}
+		compare("changed", ws, (bool *)&expected[0], size);
+
+		/* A new global brightness encodes every LED again */
+		ws.setII(II ^ 0x55);
+		reference_load((bool *)&expected[0], &buf[0], size, mode, II ^ 0x55, r_offset, g_offset, b_offset);
+		if (ws.load(&buf[0], r_offset, g_offset, b_offset) != size) {
+			printf("FAIL brightness: not fully encoded\n");
+			errors++;
+		}
+		compare("brightness", ws, (bool *)&expected[0], size);
+	}
+}
+
+static void time_encoders(void)
+{
+	std::vector<int> buf(PIXELS);
+	for (int i = 0; i < PIXELS; i++) {
+		buf[i] = (rand() << 16) ^ rand();
+	}
+	static bool reference[PIXELS * FRAME_SIZE];
+	WS2812Probe ws(PIXELS);
+	ws.useII(WS2812::PER_PIXEL);
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int frame = 0; frame < FRAMES; frame++) {
+		buf[frame % PIXELS] ^= 0x010101;
+		reference_load(reference, &buf[0], PIXELS, WS2812::PER_PIXEL, 0xFF, 0, 0, 0);
+	}
+	double before = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+	start = std::chrono::steady_clock::now();
+	for (int frame = 0; frame < FRAMES; frame++) {
+		buf[frame % PIXELS] ^= 0x010101;
+		ws.load(&buf[0], 0, 0, 0);
+	}
+	double after = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+	printf("%d LEDs, one changed per frame: %.2f us per frame before, %.2f us after\n",
+	       PIXELS, before / FRAMES, after / FRAMES);
+	printf("transmit buffer %d bytes before, %d after\n", PIXELS * FRAME_SIZE, PIXELS * FRAME_BYTES);
+}
+
+int main()
+{
+	srand(1);
+	check_random();
+	time_encoders();
+	printf("%s: %u mismatches\n", errors ? "FAIL" : "PASS", errors);
+	return errors;
+}
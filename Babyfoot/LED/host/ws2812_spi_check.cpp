@@ -0,0 +1,170 @@
+/**
+*******************************************************************************
+* @file   ws2812_spi_check.cpp
+* @brief  Host check of the WS2812 SPI bit stream
+*******************************************************************************
+* Compares the SPI bytes of WS2812_SPI with golden frames, then rebuilds the
+* line waveform of random frames from the SPI bytes and checks it: high
+* times within the WS2812 datasheet ranges, one bit every 4 SPI bits, low
+* before the first bit, reset time after the last one, and the decoded bits
+* equal to the transmitted colours.
+*
+* Build from Babyfoot/LED:
+*   g++ -O2 -std=c++11 -I../../Common/host -I. host/ws2812_spi_check.cpp WS2812_SPI.cpp WS2812.cpp PixelArray.cpp -o ws2812_spi_check
+* Usage: ws2812_spi_check
+* Exits with the number of mismatches.
+*******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "WS2812_SPI.h"
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+/* Defines -------------------------------------------------------------------*/
+#define PIXELS 60
+#define T0H_MIN_NS 200 /* WS2812 datasheet, 0.35us +-150ns */
+#define T0H_MAX_NS 500
+#define T1H_MIN_NS 550 /* 0.7us +-150ns */
+#define T1H_MAX_NS 850
+#define RESET_NS 50000
+
+/* Variables -----------------------------------------------------------------*/
+static uint32_t errors = 0;
+
+/* Functions definition ------------------------------------------------------*/
+static void check_golden(void)
+{
+	SPI spi(0, NC, NC);
+	WS2812_SPI ws(spi, 2);
+	/* Red at full brightness, a 0xFF component is sent as 0xFE, then green at half brightness */
+	int buf[2] = {(int)0xFFFF0000, (int)0x80008000};
+	ws.useII(WS2812::PER_PIXEL);
+	ws.write(buf);
+
+	std::vector<uint8_t> golden;
+	golden.push_back(0x00);
+	/* LED 0: G 0x00, R 0xFE, B 0x00 */
+	const uint8_t led0[12] = {0x88, 0x88, 0x88, 0x88, 0xCC, 0xCC, 0xCC, 0xC8, 0x88, 0x88, 0x88, 0x88};
+	/* LED 1: G (0x80 * 0x80) >> 8 = 0x40, R 0x00, B 0x00 */
+	const uint8_t led1[12] = {0x8C, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88};
+	golden.insert(golden.end(), led0, led0 + 12);
+	golden.insert(golden.end(), led1, led1 + 12);
+	/* 50us at 2.5MHz */
+	golden.insert(golden.end(), 16, 0x00);
+
+	if (spi.sent != golden) {
+		printf("FAIL golden: %zu bytes, expected %zu\n", spi.sent.size(), golden.size());
+		for (size_t i = 0; i < spi.sent.size() && i < golden.size(); i++) {
+			if (spi.sent[i] != golden[i]) {
+				printf("FAIL golden: byte %zu is 0x%02X, expected 0x%02X\n", i, spi.sent[i], golden[i]);
+				break;
+			}
+		}
+		errors++;
+	}
+	if (spi.hz != WS2812_SPI_FREQUENCY) {
+		printf("FAIL golden: SPI at %d Hz\n", spi.hz);
+		errors++;
+	}
+}
+
+/* Decode the line waveform of one frame into bits, checking its timings */
+static std::vector<bool> decode(const std::vector<uint8_t> &bytes, int hz)
+{
+	double bit_ns = 1e9 / hz;
+	std::vector<bool> line;
+	for (size_t i = 0; i < bytes.size(); i++) {
+		for (int b = 7; b >= 0; b--) {
+			line.push_back((bytes[i] >> b) & 1);
+		}
+	}
+	std::vector<bool> bits;
+	size_t i = 0;
+	while ((i < line.size()) && !line[i]) {
+		i++;
+	}
+	if (i < 8) {
+		printf("FAIL waveform: %zu low SPI bits before the first WS2812 bit\n", i);
+		errors++;
+	}
+	while (i < line.size()) {
+		size_t high = 0;
+		size_t low = 0;
+		for (; (i < line.size()) && line[i]; i++) {
+			high++;
+		}
+		for (; (i < line.size()) && !line[i]; i++) {
+			low++;
+		}
+		double high_ns = high * bit_ns;
+		bool one = (high_ns >= T1H_MIN_NS);
+		if (one ? (high_ns > T1H_MAX_NS) : ((high_ns < T0H_MIN_NS) || (high_ns > T0H_MAX_NS))) {
+			printf("FAIL waveform: %.0f ns high\n", high_ns);
+			errors++;
+			return bits;
+		}
+		bits.push_back(one);
+		if (i == line.size()) {
+			if (low * bit_ns < RESET_NS) {
+				printf("FAIL waveform: %.0f ns low after the frame\n", low * bit_ns);
+				errors++;
+			}
+		} else if (high + low != 4) {
+			printf("FAIL waveform: bit %zu lasts %zu SPI bits\n", bits.size() - 1, high + low);
+			errors++;
+			return bits;
+		}
+	}
+	return bits;
+}
+
+static void check_waveform(int hz)
+{
+	for (int round = 0; round < 100; round++) {
+		int size = 1 + rand() % PIXELS;
+		std::vector<int> buf(size);
+		for (int i = 0; i < size; i++) {
+			buf[i] = (rand() << 16) ^ rand();
+		}
+		SPI spi(0, NC, NC);
+		WS2812_SPI ws(spi, size, hz);
+		ws.useII(WS2812::PER_PIXEL);
+		ws.write(&buf[0]);
+		std::vector<bool> bits = decode(spi.sent, hz);
+		if ((int)bits.size() != size * FRAME_SIZE) {
+			printf("FAIL waveform at %d Hz: %zu bits, expected %d\n", hz, bits.size(), size * FRAME_SIZE);
+			errors++;
+			continue;
+		}
+		for (int i = 0; i < size; i++) {
+			unsigned char sf = (buf[i] >> 24) & 0xFF;
+			unsigned char grb[3] = {(unsigned char)((((buf[i] >> 8) & 0xFF) * sf) >> 8),
+			                        (unsigned char)((((buf[i] >> 16) & 0xFF) * sf) >> 8),
+			                        (unsigned char)(((buf[i] & 0xFF) * sf) >> 8)};
+			for (int j = 0; j < FRAME_SIZE; j++) {
+				if (bits[i * FRAME_SIZE + j] != (((grb[j / 8] << (j % 8)) & 0x80) != 0)) {
+					printf("FAIL waveform at %d Hz: LED %d bit %d\n", hz, i, j);
+					errors++;
+					i = size;
+					break;
+				}
+			}
+		}
+	}
+}
+
+int main()
+{
+	srand(1);
+	check_golden();
+	check_waveform(WS2812_SPI_FREQUENCY);
+	check_waveform(2400000);
+	check_waveform(3600000);
+	printf("%d LEDs: %d SPI bytes, %.0f us per frame at %d Hz\n", PIXELS,
+	       1 + PIXELS * FRAME_BYTES * 4 + 16, (1 + PIXELS * FRAME_BYTES * 4 + 16) * 8e6 / WS2812_SPI_FREQUENCY,
+	       WS2812_SPI_FREQUENCY);
+	printf("%s: %u mismatches\n", errors ? "FAIL" : "PASS", errors);
+	return errors;
+}
@@ -3,6 +3,9 @@
 #include "mbed.h"
 #include "WS2812.h"
 #include "PixelArray.h"
+#ifdef LED_SPI
+#include "WS2812_SPI.h"
+#endif
 
 /* Defines -------------------------------------------------------------------*/
 #define NUM_COLORS 		3
@@ -12,7 +15,13 @@
 Serial pc (USBTX, USBRX, 115200);
 PixelArray px_b(WS2812_BUF);
 // PixelArray px_r(WS2812_BUF);
+#ifdef LED_SPI
+/* -DLED_SPI: the strip is sent by the SPI peripheral, interrupts stay enabled */
+SPI spi_b(D11, NC, D13); /* Din on MOSI, the clock is not used by the strip */
+WS2812_SPI ws_b(spi_b, WS2812_BUF);
+#else
 WS2812 ws_b(D10, WS2812_BUF, 0, 5, 5, 0);
+#endif
 // WS2812 ws_r(D9, WS2812_BUF, 0, 5, 5, 0);
 
 
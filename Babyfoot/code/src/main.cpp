@@ -1,8 +1,22 @@
 /* Includes ------------------------------------------------------------------*/
 #include "mbed.h"
 #include "bmi160.h"
+#include "acc_acquisition.h"
+#include "perf_stats.h"
+#include "window.h"
+#ifdef NEAI_LIB
+#include "event_report.h"
+#include "command_parser.h"
+#ifdef LEARN_UPLOAD
+#include "learn_upload.h"
+#endif
+#endif
 #ifndef DATA_LOGGING
 #include "NanoEdgeAI.h"
+#include "learn_phase.h"
+#endif
+#ifdef LOG_BINARY
+#include "neai_stream.h"
 #endif
 #include <math.h>
 
@@ -11,57 +25,83 @@
 #define DATA_LOGGING
 #endif
 #ifdef DATA_LOGGING
-#define DATA_INPUT_USER 128
-#define AXIS_NUMBER 3
 #define LOG_NUMBER 25
-#else
-#define LEARNING_NUMBER 50 /* Number of learning signals */
+#endif
+#define PRE_TRIGGER 32 /* Samples before the shock in each window (20ms at 1600Hz) */
+#define TRIGGER_SLACK 32 /* Samples drained at most between two shock checks */
+#define LOG_THRESHOLD 4.0F /* Shock level starting a logging or learning window, g */
+#define PLAY_THRESHOLD 3.0F /* Shock level starting a goal window, g */
+#define GOAL_HOLDOFF_MS 2000 /* No new goal while the ball settles, LED on */
+#define LEARN_HOLDOFF_MS 3000 /* No new learning shock while the ball is taken back, from the window end */
+#ifdef SHOCK_WAKE
+/* -DSHOCK_WAKE: the MCU sleeps until a sensor any-motion or high-g interrupt */
+#define WAKE_SLOPE 0.5F /* Any-motion slope between two samples, g */
+#define WAKE_LEVEL 1.5F /* High-g level on any axis, g */
+#define WAKE_POLLS 30 /* FIFO polls after a wake-up without a goal shock */
+#endif
+
+/* Types ---------------------------------------------------------------------*/
+/* Samples and axes of every window, logged, learned or scored */
+typedef Window<128, 3, float> AccWindow;
+#ifndef DATA_LOGGING
+NEAI_WINDOW_CHECK(AccWindow);
 #endif
 
 /* Objects -------------------------------------------------------------------*/
-Serial pc(USBTX, USBRX);
-Serial bt(D5, D4, 9600);
+RawSerial pc(USBTX, USBRX); /* Both read in RX interrupts: no mutex, unlike Serial */
+RawSerial bt(D5, D4, 9600);
 Ticker toggle_led_ticker;
 DigitalOut myled(LED2);
 /* Blue player : */
 I2C i2c_b(D0, D1);
 BMI160_I2C imu_b(i2c_b, BMI160_I2C::I2C_ADRS_SDO_HI);
+InterruptIn imu_int_b(D2); /* BMI160 INT1 */
+AccAcquisition acq_b(imu_b, imu_int_b);
 /* Red player : */
 I2C i2c_r(D12, A6);
 BMI160_I2C imu_r(i2c_r, BMI160_I2C::I2C_ADRS_SDO_HI);
+InterruptIn imu_int_r(D3); /* BMI160 INT1 */
+AccAcquisition acq_r(imu_r, imu_int_r);
 
 BMI160::AccConfig accConfig;
-BMI160::SensorData accData;
+BMI160::FifoConfig fifoConfig;
+#ifdef LOG_BINARY
+NeaiStream log_stream(pc, bt);
+#endif
+#ifdef NEAI_LIB
+EventReport report(pc, bt); /* Score messages, the play loop never waits for the UARTs */
+Timer goal_timer;
+/* Score commands, one parser and queue per port (see command_parser.h) */
+CommandParser parser_pc;
+CommandParser parser_bt;
+CommandQueue commands_pc;
+CommandQueue commands_bt;
+#ifdef LEARN_UPLOAD
+/* -DLEARN_UPLOAD: learning windows sent by Common/tools/neai_learn_upload.py on Bluetooth */
+int16_t upload_storage[LearnUpload::SLOTS * AccWindow::VALUES];
+LearnUpload upload(bt, upload_storage, AccWindow::SAMPLES, AccWindow::AXES);
+#endif
+#endif
 
 /* Variables -----------------------------------------------------------------*/
-/* Blue player : */
-float acc_x_b = 0.F;
-float acc_y_b = 0.F;
-float acc_z_b = 0.F;
-float last_acc_x_b = 0.F;
-float last_acc_y_b = 0.F;
-float last_acc_z_b = 0.F;
-/* Red player : */
-float acc_x_r = 0.F;
-float acc_y_r = 0.F;
-float acc_z_r = 0.F;
-float last_acc_x_r = 0.F;
-float last_acc_y_r = 0.F;
-float last_acc_z_r = 0.F;
 #ifndef DATA_LOGGING
 uint8_t similarity_b = 0;
-uint16_t learn_cpt_b = 0;
 uint8_t similarity_r = 0;
-uint16_t learn_cpt_r = 0;
-volatile bool newData_cs = false ;
-volatile float inputs_cs[2];
-volatile bool newData_ln = false ;
-float inputs_ln[DATA_INPUT_USER * AXIS_NUMBER] = {0.F} ;
+/* 15 to 50 goals per player, a goal scored every 3, stop on 3 scores over the play threshold within 10 points */
+const LearnPhase::Config learn_config = {15, 50, 3, 3, 10, 90};
+#ifdef LEARN_UPLOAD
+AccWindow inputs_ln;
+#endif
 #endif
 
 /* Buffer with accelerometer values for x-, y- and z-axis --------------------*/
-float acc_buffer_b[DATA_INPUT_USER * AXIS_NUMBER] = {0.F};
-float acc_buffer_r[DATA_INPUT_USER * AXIS_NUMBER] = {0.F};
+/* Continuously filled rings, each window holds PRE_TRIGGER samples before the shock */
+float acc_ring_b[2 * (AccWindow::SAMPLES + TRIGGER_SLACK) * AccWindow::AXES] = {0.F};
+float acc_ring_r[2 * (AccWindow::SAMPLES + TRIGGER_SLACK) * AccWindow::AXES] = {0.F};
+TriggerWindow trigger_b(acc_ring_b, AccWindow::SAMPLES, TRIGGER_SLACK, AccWindow::AXES, PRE_TRIGGER);
+TriggerWindow trigger_r(acc_ring_r, AccWindow::SAMPLES, TRIGGER_SLACK, AccWindow::AXES, PRE_TRIGGER);
+float *acc_buffer_b = acc_ring_b; /* Latest window in acc_ring_b */
+float *acc_buffer_r = acc_ring_r; /* Latest window in acc_ring_r */
 
 /* Functions prototypes ------------------------------------------------------*/
 #ifdef DATA_LOGGING
@@ -69,8 +109,14 @@ void data_logging_mode(void);
 #endif
 #ifdef NEAI_LIB
 void neai_library_mode(void);
-void change_score(void);
+void change_score_pc(void);
+void change_score_bt(void);
+#ifdef LEARN_UPLOAD
 void learning_function(void);
+#else
+void learn_goal(LearnPhase &learn_phase, float *window);
+void learn_report(const LearnPhase &learn_phase);
+#endif
 #endif
 void init(void);
 void init_bmi160(void);
@@ -79,8 +125,6 @@ void fill_acc_buffer_b(void);
 void fill_acc_buffer_r(void);
 void fill_acc_buffer_print_b(void);
 void fill_acc_buffer_print_r(void);
-void get_acc_values_b(void);
-void get_acc_values_r(void);
 
 /* BEGIN CODE-----------------------------------------------------------------*/
 
@@ -110,8 +154,6 @@ int main()
 
 void data_logging_mode()
 {
-	float start_b = 0;
-	float start_r = 0;
 	int compteur_b = 0;
 	int compteur_r = 0;
 	while(1) 
@@ -120,29 +162,20 @@ void data_logging_mode()
 		bt.printf("Blue goal logging\n");
 		while(compteur_b < LOG_NUMBER) 
 		{
-			get_acc_values_b();
-			start_b = fabs(acc_x_b)+fabs(acc_y_b)+fabs(acc_z_b);
-
 			/* Waiting for the blue logging process start */
-			if (start_b >= 4.0)
-			{
-				/* Blink LED  during logging process */
-				toggle_led_ticker.attach(&toggle_led, 0.1);
-				
-				/* Logging process */
-				fill_acc_buffer_b();
+			/* Logging process: the window starts before the shock */
+			fill_acc_buffer_b();
 
-				/* Stop blink LED (end of logging process) */
-				toggle_led_ticker.detach();
-				myled = 0;
+			/* LED on while printing */
+			myled = 1;
 
-				/* Print logging process results */
-				fill_acc_buffer_print_b();
+			/* Print logging process results */
+			fill_acc_buffer_print_b();
 
-				compteur_b ++;
+			myled = 0;
+			compteur_b ++;
 
-				wait_ms(1000);
-			}
+			wait_ms(1000);
 		}
 
 		compteur_b =0;
@@ -151,29 +184,20 @@ void data_logging_mode()
 		bt.printf("Red goal logging\n");
 		while(compteur_r < LOG_NUMBER)
 		{
-			get_acc_values_r();
-			start_r = fabs(acc_x_r)+fabs(acc_y_r)+fabs(acc_z_r);
-
 			/* Waiting for the red logging process start */
-			if (start_r >= 4.0)
-			{
-				/* Blink LED  during logging process */
-				toggle_led_ticker.attach(&toggle_led, 0.1);
-				
-				/* Logging process */
-				fill_acc_buffer_r();
+			/* Logging process: the window starts before the shock */
+			fill_acc_buffer_r();
 
-				/* Stop blink LED (end of logging process) */
-				toggle_led_ticker.detach();
-				myled = 0;
+			/* LED on while printing */
+			myled = 1;
 
-				/* Print logging process results */
-				fill_acc_buffer_print_r();
+			/* Print logging process results */
+			fill_acc_buffer_print_r();
 
-				compteur_r ++;
+			myled = 0;
+			compteur_r ++;
 
-				wait_ms(1000);
-			}
+			wait_ms(1000);
 		}
 
 		compteur_r = 0;
@@ -186,141 +210,205 @@ void data_logging_mode()
 
 void neai_library_mode()
 {
-	
+#ifdef LEARN_UPLOAD
+	/* Learning process with uploaded windows */
+
+	pc.printf("Learning process : please launch 'neai_learn_upload.py' on the Bluetooth port to start the learning\n");
+	bt.attach(&learning_function);
+	while (!upload.finished())
+	{
+		uint8_t range;
+		const int16_t *window = upload.window(range);
+		if (!window)
+		{
+			/* Sleep until the RX interrupt has a frame or a reply for this loop */
+			upload.wait();
+			continue;
+		}
+		AccWindow::Of<int16_t>::toG(inputs_ln.values, window, BMI160::getAccScale((BMI160::AccRange)range));
+		/* The next frame is received in this slot while learning */
+		upload.release();
+		PERF_TIME(PERF_LEARN, NanoEdgeAI_learn(inputs_ln.values));
+		PERF_TIME(PERF_REPORT, pc.printf("%d windows learned\n", (int)upload.windows()));
+	}
+	pc.printf("Learning done : %d windows, %d frames with a CRC error\n", (int)upload.windows(), (int)upload.errors());
+#else
 	/* Learning process manual */
 
 	/* Learning process with the blue goal accelerometer */
 	
-	float start_b = 0;
-	pc.printf("Blue goal learning process");
-	bt.printf("Blue goal learning process");
-	while (learn_cpt_b < LEARNING_NUMBER)
+	/* Goals learned until the similarity of the goals not learned yet is stable (see learn_phase.h) */
+	LearnPhase learn_phase(learn_config);
+	report.printf("Blue goal learning process\n");
+	while (!learn_phase.done())
 	{
-		get_acc_values_b();
-		start_b = fabs(acc_x_b)+fabs(acc_y_b)+fabs(acc_z_b);
-
-		/* Waiting for the logging process start */
-		if (start_b >= 4.0)
+		/* Waiting for the logging process start, the window starts before the shock */
+		fill_acc_buffer_b();
+		goal_timer.reset();
+		goal_timer.start();
+
+		/* Blink LED  during logging process */
+		toggle_led_ticker.attach(&toggle_led, 0.1);
+		
+		/* Logging process */
+		learn_goal(learn_phase, acc_buffer_b);
+
+		/* Learning ran during the hold-off */
+		while (goal_timer.read_ms() < LEARN_HOLDOFF_MS)
 		{
-			/* Blink LED  during logging process */
-			toggle_led_ticker.attach(&toggle_led, 0.1);
-			
-			/* Logging process */
-			learn_cpt_b ++;
-
-			fill_acc_buffer_b();
-			NanoEdgeAI_learn(acc_buffer_b);
-			pc.printf("%d percent \n", (int)(learn_cpt_b * 100) / LEARNING_NUMBER);
-			bt.printf("%d percent \n", (int)(learn_cpt_b * 100) / LEARNING_NUMBER);
-
-			wait_ms(3000);
-
-			/* Stop blink LED (end of logging process) */
-			toggle_led_ticker.detach();
-			myled = 0;
+			wait_ms(AccAcquisition::FIFO_POLL_MS);
 		}
+
+		/* Stop blink LED (end of logging process) */
+		toggle_led_ticker.detach();
+		myled = 0;
 	}
-	float start_r = 0;
-	pc.printf("Red goal learning process");
-	bt.printf("Red goal learning process");
+	learn_report(learn_phase);
+	learn_phase.reset();
+	report.printf("Red goal learning process\n");
 	/* Learning process with the red player accelerometer */
-	while (learn_cpt_r < LEARNING_NUMBER)
+	while (!learn_phase.done())
 	{
-		get_acc_values_r();
-		start_r = fabs(acc_x_r)+fabs(acc_y_r)+fabs(acc_z_r);
-
-		/* Waiting for the logging process start */
-		if (start_r >= 4.0)
+		/* Waiting for the logging process start, the window starts before the shock */
+		fill_acc_buffer_r();
+		goal_timer.reset();
+		goal_timer.start();
+
+		/* Blink LED  during logging process */
+		toggle_led_ticker.attach(&toggle_led, 0.1);
+		
+		/* Logging process */
+		learn_goal(learn_phase, acc_buffer_r);
+
+		/* Learning ran during the hold-off */
+		while (goal_timer.read_ms() < LEARN_HOLDOFF_MS)
 		{
-			/* Blink LED  during logging process */
-			toggle_led_ticker.attach(&toggle_led, 0.1);
-			
-			/* Logging process */
-			learn_cpt_r ++;
-
-			fill_acc_buffer_r();
-			NanoEdgeAI_learn(acc_buffer_r);
-			pc.printf("%d percent \n", (int)(learn_cpt_r * 100) / LEARNING_NUMBER);
-			bt.printf("%d percent \n", (int)(learn_cpt_r * 100) / LEARNING_NUMBER);
-
-			wait_ms(3000);
-
-			/* Stop blink LED (end of logging process) */
-			toggle_led_ticker.detach();
-			myled = 0;
+			wait_ms(AccAcquisition::FIFO_POLL_MS);
 		}
-	}
-
-	/* Learning process auto*/
 
-// 	pc.printf("Learning process : please launch 'learning.py' to start the learning\n");
-// 	bt.printf("Learning process : please launch 'learning.py' to start the learning\n");
-	
-// 	bt.attach(&learning_function);
-
-// 	int learning_lines = 5;
-// 	int nb_lines = 0;
-
-//   	while(nb_lines < learning_lines)
-//   	{
-// 	    if (newData_ln)
-// 	    {
-// 	      	newData_ln =  false ;
-// 	      	pc.printf("Before learn\n");
-// 	      	NanoEdgeAI_learn(inputs_ln);
-// 	      	pc.printf("After learn\n");
-// 	      	for (int i = 0; i < DATA_INPUT_USER * AXIS_NUMBER; i++)
-// 	      	{
-// 	      		// pc.printf("%f \n\r", inputs_ln[i]);
-// 	      		inputs_ln[i] = 0;
-// 	      	}
-// 	      	nb_lines++;
-// 	      	pc.printf("%d percent \n", (int)(nb_lines * 100) / learning_lines);
-// 			bt.printf("%d percent \n", (int)(nb_lines * 100) / learning_lines);
-// 	    }
-// 	}
+		/* Stop blink LED (end of logging process) */
+		toggle_led_ticker.detach();
+		myled = 0;
+	}
+	learn_report(learn_phase);
+#endif
 
 	/* Play process */
 	int goals_b = 0;
 	int goals_r = 0;
 
-	pc.printf("\n Let's play ! To change the score, enter an instruction of the form 'B -1' or 'R +2' for example, then press Enter\n");
-	bt.printf("\n Let's play ! To change the score, enter an instruction of the form 'B -1' or 'R +2' for example, then press Enter\n");
+	pc.printf("\n Let's play ! To change the score, enter an instruction of the form 'B -1' or 'R +2' for example, 'RESET' or 'SENS 1.5', then press Enter\n");
+	bt.printf("\n Let's play ! To change the score, enter an instruction of the form 'B -1' or 'R +2' for example, 'RESET' or 'SENS 1.5', then press Enter\n");
 	
-	pc.attach(&change_score);
+	pc.attach(&change_score_pc);
+	bt.attach(&change_score_bt);
+	/* Both rings run until a shock on either goal */
+	acq_r.armTrigger(trigger_r);
+	acq_b.armTrigger(trigger_b);
+	bool holdoff = false;
+#ifdef SHOCK_WAKE
+	int wake_polls = 0;
+#endif
 	while(1)
 	{
-		if (newData_cs)
+		Command command;
+		while (commands_pc.pop(command) || commands_bt.pop(command))
 		{
-		    newData_cs =  false ;
-		    if (inputs_cs[0] == 'B')
-		    {
-		    	goals_r += inputs_cs[1];
-		    	pc.printf("New score is : Blue player : %d | Red player : %d \n", goals_r, goals_b);
-		    	bt.printf("New score is : Blue player : %d | Red player : %d \n", goals_r, goals_b);
-		    }
-		   	else if (inputs_cs[0] == 'R')
-		   	{
-		   		goals_b += inputs_cs[1];
-		   		pc.printf("New score is : Blue player : %d | Red player : %d \n", goals_r, goals_b);
-		    	bt.printf("New score is : Blue player : %d | Red player : %d \n", goals_r, goals_b);		   	
-		   	}
-		  	else
-		   	{
-		   		pc.printf("You entered an incorrect formulation\n");
-		   		bt.printf("You entered an incorrect formulation\n");
-		   	}
+			switch (command.type)
+			{
+			case CMD_SCORE:
+				if (command.target == 'B')
+				{
+					goals_r += command.value;
+				}
+				else
+				{
+					goals_b += command.value;
+				}
+				report.printf("New score is : Blue player : %d | Red player : %d \n", goals_r, goals_b);
+				break;
+			case CMD_RESET:
+				goals_r = 0;
+				goals_b = 0;
+				report.printf("New score is : Blue player : %d | Red player : %d \n", goals_r, goals_b);
+				break;
+			case CMD_SENSITIVITY:
+				NanoEdgeAI_set_sensitivity(command.value / 1000.F);
+				report.printf("Sensitivity : %d.%03d\n", (int)(command.value / 1000), (int)(command.value % 1000));
+				break;
+			case CMD_MODE:
+				/* Play is the only mode once learning is done */
+				report.printf("Mode %d not available\n", (int)command.value);
+				break;
+			case CMD_STATS:
+#ifdef PERF_STATS
+				/* Statistics since the previous STATS, then a new period */
+				PerfStats::dump(pc);
+				PerfStats::reset();
+#else
+				report.printf("Statistics not built, see -DPERF_STATS\n");
+#endif
+				break;
+			default:
+				report.printf("You entered an incorrect formulation\n");
+				break;
+			}
 		}
-		get_acc_values_r();
-		get_acc_values_b();
-		start_r = fabs(acc_x_r)+fabs(acc_y_r)+fabs(acc_z_r);
-		start_b = fabs(acc_x_b)+fabs(acc_y_b)+fabs(acc_z_b);
-		if (start_b >= 3.0 || start_r >= 3.0) 
+		if (holdoff)
 		{
-			fill_acc_buffer_r();
-			fill_acc_buffer_b();
-			similarity_r = NanoEdgeAI_detect(acc_buffer_r);
-			similarity_b = NanoEdgeAI_detect(acc_buffer_b);
+			/* Score commands are still served while the ball settles */
+			if (goal_timer.read_ms() < GOAL_HOLDOFF_MS)
+			{
+				wait_ms(AccAcquisition::FIFO_POLL_MS);
+				continue;
+			}
+			holdoff = false;
+			myled = 0;
+			acq_r.armTrigger(trigger_r);
+			acq_b.armTrigger(trigger_b);
+#ifdef SHOCK_WAKE
+			acq_r.clearMotion();
+			acq_b.clearMotion();
+			wake_polls = 0;
+#endif
+		}
+#ifdef SHOCK_WAKE
+		if (wake_polls == 0)
+		{
+			/* Nothing on the table: sleep until a shock or a score command */
+			if (!acq_r.motion() && !acq_b.motion())
+			{
+				sleep();
+				continue;
+			}
+			acq_r.clearMotion();
+			acq_b.clearMotion();
+			/* The FIFOs kept sampling meanwhile, they hold the samples before the shock */
+			trigger_r.reset();
+			trigger_b.reset();
+			wake_polls = WAKE_POLLS;
+		}
+		wake_polls--;
+#endif
+		PERF_COUNT(PERF_SPINS, 1);
+		wait_ms(AccAcquisition::FIFO_POLL_MS);
+		AccAcquisition::pollTriggers(acq_r, trigger_r, acq_b, trigger_b, PLAY_THRESHOLD);
+#ifdef SHOCK_WAKE
+		if (trigger_r.triggered())
+		{
+			/* Keep polling until the goal windows are ready */
+			wake_polls = 1;
+		}
+#endif
+		if (trigger_r.ready() && trigger_b.ready()) 
+		{
+			/* Both goals over the same time span, shock levels at the same sample */
+			float start_r = acq_r.triggerLevel(trigger_r);
+			float start_b = acq_b.triggerLevel(trigger_b);
+			acc_buffer_r = trigger_r.window();
+			acc_buffer_b = trigger_b.window();
+			PERF_TIME(PERF_DETECT, similarity_r = NanoEdgeAI_detect(acc_buffer_r));
+			PERF_TIME(PERF_DETECT, similarity_b = NanoEdgeAI_detect(acc_buffer_b));
 			//pc.printf("Similarity : %d blue_g and %d red_g \n", similarity_b, similarity_r);
 			//bt.printf("Similarity : %d blue_g and %d red_g \n", similarity_b, similarity_r);
 			if (similarity_b > 90 || similarity_r > 90)
@@ -334,105 +422,109 @@ void neai_library_mode()
 				{
 					goals_r++;
 				}
-				pc.printf("Blue player : %d | Red player : %d \n", goals_r, goals_b);
-				bt.printf("Blue player : %d | Red player : %d \n", goals_r, goals_b);
-				wait_ms(2000);
-				myled = 0;
+				PERF_TIME(PERF_REPORT, report.printf("Blue player : %d | Red player : %d \n", goals_r, goals_b));
+				/* Rings re-armed once the hold-off is over */
+				holdoff = true;
+				goal_timer.reset();
+				goal_timer.start();
+			}
+			else
+			{
+				acq_r.armTrigger(trigger_r);
+				acq_b.armTrigger(trigger_b);
+#ifdef SHOCK_WAKE
+				acq_r.clearMotion();
+				acq_b.clearMotion();
+				wake_polls = 0;
+#endif
 			}
 		}
 		if (goals_r >= 10)
 		{
-			pc.printf("End of the game ! Blue player won\n");
-			bt.printf("End of the game ! Blue player won\n");
+			report.printf("End of the game ! Blue player won\n");
 			goals_r = 0;
 			goals_b = 0;
 		}
 		if (goals_b >= 10)
 		{
-			pc.printf("End of the game ! Red player won\n");
-			bt.printf("End of the game ! Red player won\n");
+			report.printf("End of the game ! Red player won\n");
 			goals_r = 0;
 			goals_b = 0;
 		}
 	}
 }
 
-void change_score()
+void change_score_pc()
 {
-	static char serialInBuffer_cs[32];
-	static int serialCount_cs =  0;
+	/* RX interrupt: O(1) per byte, the main loop runs the commands */
+	Command command;
+	while (pc.readable())
+	{
+		if (parser_pc.feed(pc.getc(), command))
+		{
+			commands_pc.push(command);
+		}
+	}
+}
+
+void change_score_bt()
+{
+	/* RX interrupt: O(1) per byte, the main loop runs the commands */
+	Command command;
 	while (bt.readable())
 	{
-		char byteIn_cs = bt.getc();
-	    if ((byteIn_cs ==  0x0D) || (byteIn_cs == 0x0A))
-	    { // si une fin de ligne est trouvée
-	    	serialInBuffer_cs[serialCount_cs] ==  0 ;  // null met fin à l'entrée
-	    	int score;
-	    	char player;
-	     	if (sscanf(serialInBuffer_cs, "%c %d" , &player, &score) == 2)
-	     	{  // a réussi à lire les 3 valeurs
-	     		inputs_cs[0] = player;
-		      	inputs_cs[1] = score;
-		      	newData_cs = true;
-	    	}
-	    	serialCount_cs = 0; // réinitialise le tampon
-	   	}
-	   	else 
-	   	{
-	    	serialInBuffer_cs[serialCount_cs] = byteIn_cs; // stocke le caractère
-	     	if (serialCount_cs < 32) // augmente le compteur
-	      	{
-	      		serialCount_cs ++;
-	      	}
-	  	}
+		if (parser_bt.feed(bt.getc(), command))
+		{
+			commands_bt.push(command);
+		}
 	}
 }
 
-// void learning_function()
-// {
-// 	static char serialInBuffer_ln[32];
-// 	static int serialCount_ln =  0;
-// 	for (int i = 0; i < 384;)
-// 	{
-// 		while (bt.readable())
-// 		{
-// 			char byteIn_ln = bt.getc();
-// 		    if (byteIn_ln == 0x0A)
-// 		    { 
-// 		    	serialInBuffer_ln[serialCount_ln] == 0 ; 
-// 		    	float x;
-// 		     	if (sscanf(serialInBuffer_ln, "%f" , &x) == 1)
-// 		     	{
-// 		     		inputs_ln[i] = x;
-// 			      	newData_ln = true;
-// 			      	i++;
-// 			      	for (int isample = 0; isample < 32; isample ++)
-// 			      	{
-// 			      		serialInBuffer_ln[isample] = 0;
-// 			      	}
-// 		    	}
-// 		    	serialCount_ln = 0;
-// 		   	}
-// 		   	else 
-// 		   	{
-// 		   		serialInBuffer_ln [serialCount_ln] = byteIn_ln;
-// 		     	if (serialCount_ln < 32) 
-// 		      	{
-// 		      		serialCount_ln ++;
-// 		      	}
-// 		  	}
-// 		}
-// 	}
-// }
+#ifdef LEARN_UPLOAD
+void learning_function()
+{
+	/* RX interrupt: O(1) per byte, the main loop learns the windows and replies */
+	while (bt.readable())
+	{
+		upload.receive(bt.getc());
+	}
+}
+#else
+void learn_goal(LearnPhase &learn_phase, float *window)
+{
+	/* Scored before it is learned: the model has never seen this goal */
+	if (learn_phase.scoreNext())
+	{
+		PERF_TIME(PERF_DETECT, learn_phase.scored(NanoEdgeAI_detect(window)));
+		PERF_TIME(PERF_REPORT, report.printf("LEARN %u goals, similarity %u, spread %u\n",
+		                                     learn_phase.windows(), learn_phase.similarity(),
+		                                     learn_phase.spread()));
+	}
+	PERF_TIME(PERF_LEARN, NanoEdgeAI_learn(window));
+	learn_phase.learned();
+	PERF_TIME(PERF_REPORT, report.printf("%u percent \n", learn_phase.progress()));
+}
+
+void learn_report(const LearnPhase &learn_phase)
+{
+	report.printf("LEARN %s after %u goals\n",
+	              (learn_phase.state() == LearnPhase::CONVERGED) ? "converged" : "stopped",
+	              learn_phase.windows());
+}
+#endif
 
 #endif
 
 void init()
 {
 	pc.baud(115200);
+	#ifdef PERF_STATS
+		PerfStats::start();
+	#endif
 	init_bmi160();
 	#ifdef NEAI_LIB
 		NanoEdgeAI_initialize();
+		report.start();
 	#endif
 }
 
@@ -447,6 +539,20 @@ void init_bmi160()
 	accConfig.odr = BMI160::ACC_ODR_12; /* Accelerometer output data rate < 800Hz */
 	imu_r.setSensorConfig(accConfig);
 	imu_b.setSensorConfig(accConfig);
+	fifoConfig = BMI160::DEFAULT_FIFO_CONFIG; /* Headerless accelerometer frames */
+	imu_r.setFifoConfig(fifoConfig);
+	imu_b.setFifoConfig(fifoConfig);
+#ifdef SHOCK_WAKE
+	/* Any-motion and high-g interrupts on INT1, one pulse per shock */
+	BMI160::AnyMotionConfig anyMotion = {WAKE_SLOPE, 2};
+	BMI160::HighGConfig highG = {WAKE_LEVEL, 0.25F, 2.5F};
+	acq_r.startMotion(accConfig.range, BMI160::INT1, anyMotion, highG);
+	acq_b.startMotion(accConfig.range, BMI160::INT1, anyMotion, highG);
+#else
+	/* Data ready interrupt on INT1, one pulse per new sample */
+	acq_r.start(accConfig.range, BMI160::INT1);
+	acq_b.start(accConfig.range, BMI160::INT1);
+#endif
 	wait_ms(100);
 }
 
@@ -473,24 +579,16 @@ void toggle_led()
 
 void fill_acc_buffer_b()
 {
-	for (uint16_t i = 0; i < DATA_INPUT_USER; i++)
-	{
-		get_acc_values_b();
-		acc_buffer_b[AXIS_NUMBER * i] = acc_x_b;
-		acc_buffer_b[AXIS_NUMBER * i + 1] = acc_y_b;
-		acc_buffer_b[AXIS_NUMBER * i + 2] = acc_z_b;
-	}
+	/* FIFO method: the ring runs until a shock, the window keeps the samples before it */
+	acq_b.waitTrigger(trigger_b, LOG_THRESHOLD);
+	acc_buffer_b = trigger_b.window();
 }
 
 void fill_acc_buffer_r()
 {
-	for (uint16_t i = 0; i < DATA_INPUT_USER; i++)
-	{
-		get_acc_values_r();
-		acc_buffer_r[AXIS_NUMBER * i] = acc_x_r;
-		acc_buffer_r[AXIS_NUMBER * i + 1] = acc_y_r;
-		acc_buffer_r[AXIS_NUMBER * i + 2] = acc_z_r;
-	}
+	/* FIFO method: the ring runs until a shock, the window keeps the samples before it */
+	acq_r.waitTrigger(trigger_r, LOG_THRESHOLD);
+	acc_buffer_r = trigger_r.window();
 }
 
 // void fill_acc_buffer_print()
@@ -514,55 +612,34 @@ void fill_acc_buffer_r()
 
 void fill_acc_buffer_print_b()
 {
-	for (uint16_t isample = 0; isample < AXIS_NUMBER * DATA_INPUT_USER - 1; isample++)
+#ifdef LOG_BINARY
+	/* One binary frame per window, decoded by Common/tools/neai_stream_decode.py */
+	log_stream.writeWindow(acc_buffer_b, AccWindow::SAMPLES, AccWindow::AXES, accConfig);
+#else
+	for (uint16_t isample = 0; isample < AccWindow::VALUES - 1; isample++)
 	{
 		pc.printf("%.4f ", acc_buffer_b[isample]);
 		bt.printf("%.4f ", acc_buffer_b[isample]);
 	}
-	pc.printf("%.4f\n", acc_buffer_b[AXIS_NUMBER * DATA_INPUT_USER - 1]);
-	bt.printf("%.4f\n", acc_buffer_b[AXIS_NUMBER * DATA_INPUT_USER - 1]);
+	pc.printf("%.4f\n", acc_buffer_b[AccWindow::VALUES - 1]);
+	bt.printf("%.4f\n", acc_buffer_b[AccWindow::VALUES - 1]);
+#endif
 }
 
 void fill_acc_buffer_print_r()
 {
-	for (uint16_t isample = 0; isample < AXIS_NUMBER * DATA_INPUT_USER - 1; isample++)
+#ifdef LOG_BINARY
+	/* One binary frame per window, decoded by Common/tools/neai_stream_decode.py */
+	log_stream.writeWindow(acc_buffer_r, AccWindow::SAMPLES, AccWindow::AXES, accConfig);
+#else
+	for (uint16_t isample = 0; isample < AccWindow::VALUES - 1; isample++)
 	{
 		pc.printf("%.4f ", acc_buffer_r[isample]);
 		bt.printf("%.4f ", acc_buffer_r[isample]);
 	}
-	pc.printf("%.4f\n", acc_buffer_r[AXIS_NUMBER * DATA_INPUT_USER - 1]);
-	bt.printf("%.4f\n", acc_buffer_r[AXIS_NUMBER * DATA_INPUT_USER - 1]);
-}
-
-void get_acc_values_b()
-{
-	/* Polling method to get a complete buffer */
-	do {
-		imu_b.getSensorXYZ(accData, accConfig.range);
-		acc_x_b = accData.xAxis.scaled;
-		acc_y_b = accData.yAxis.scaled;
-		acc_z_b = accData.zAxis.scaled;
-	}
-	while (acc_x_b == last_acc_x_b && acc_y_b == last_acc_y_b && acc_z_b == last_acc_z_b);
-	
-	last_acc_x_b = acc_x_b;
-	last_acc_y_b = acc_y_b;
-	last_acc_z_b = acc_z_b;
+	pc.printf("%.4f\n", acc_buffer_r[AccWindow::VALUES - 1]);
+	bt.printf("%.4f\n", acc_buffer_r[AccWindow::VALUES - 1]);
+#endif
 }
 
-void get_acc_values_r()
-{
-	/* Polling method to get a complete buffer */
-	do {
-		imu_r.getSensorXYZ(accData, accConfig.range);
-		acc_x_r = accData.xAxis.scaled;
-		acc_y_r = accData.yAxis.scaled;
-		acc_z_r = accData.zAxis.scaled;
-	}
-	while (acc_x_r == last_acc_x_r && acc_y_r == last_acc_y_r && acc_z_r == last_acc_z_r);
-	
-	last_acc_x_r = acc_x_r;
-	last_acc_y_r = acc_y_r;
-	last_acc_z_r = acc_z_r;
-}
 /* END CODE------------------------------------------------------------------- */
\ No newline at end of file
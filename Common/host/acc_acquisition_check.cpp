@@ -0,0 +1,200 @@
+/**
+*******************************************************************************
+* @file   acc_acquisition_check.cpp
+* @brief  Host check of the data ready acquisition
+*******************************************************************************
+* Starts AccAcquisition on BMI160_Mock and checks the INT_OUT_CTRL,
+* INT_LATCH, INT_MAP_1 and INT_EN_1 bits for both pins, other bits left
+* untouched. Then reads samples while the mock raises one data ready edge per
+* ODR tick and checks that readSample() returns each sample exactly once:
+* the tick ending the sleep, an edge before the call, and an edge right after
+* the pin check, just before the sleep, non-latched and latched.
+* Last, checks the trigger windows: an event without its pre-trigger
+* samples is refused and a later one taken, and a shared event one ring
+* cannot take restarts both rings.
+*
+* Usage: acc_acquisition_check
+* Exits with the number of mismatches.
+*******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "acc_acquisition.h"
+#include "bmi160_mock.h"
+#include <cstdio>
+
+/* Defines -------------------------------------------------------------------*/
+#define SAMPLES 50
+#define TRIGGER_SAMPLES 16
+#define TRIGGER_SLACK 8
+#define TRIGGER_PRE 4
+#define TRIGGER_RAW 32000 /* About 2 g at SENS_2G */
+
+/* Variables -----------------------------------------------------------------*/
+static uint32_t errors = 0;
+
+/* Functions definition ------------------------------------------------------*/
+static void expect(const char *what, uint32_t value, uint32_t expected)
+{
+	if (value != expected) {
+		printf("FAIL %-40s 0x%02X, expected 0x%02X\n", what, value, expected);
+		errors++;
+	}
+}
+
+static void check_registers(BMI160::InterruptPin pin)
+{
+	BMI160_Mock imu;
+	InterruptIn irq(0);
+	AccAcquisition acq(imu, irq);
+	char what[64];
+	/* Other pin, input enables, FIFO interrupts and high-g enables must stay */
+	imu.setReg(BMI160::INT_OUT_CTRL, (pin == BMI160::INT1) ? 0x50 : 0x05);
+	imu.setReg(BMI160::INT_LATCH, 0x3F);
+	imu.setReg(BMI160::INT_MAP_1, 0x66);
+	imu.setReg(BMI160::INT_EN_1, 0x07);
+	acq.start(BMI160::SENS_2G, pin);
+	/* Push-pull active high output */
+	snprintf(what, sizeof(what), "INT_OUT_CTRL INT%u", pin + 1);
+	expect(what, imu.reg(BMI160::INT_OUT_CTRL), (pin == BMI160::INT1) ? 0x5A : 0xA5);
+	snprintf(what, sizeof(what), "INT_LATCH INT%u", pin + 1);
+	expect(what, imu.reg(BMI160::INT_LATCH), 0x30);
+	snprintf(what, sizeof(what), "INT_MAP_1 INT%u", pin + 1);
+	expect(what, imu.reg(BMI160::INT_MAP_1), (pin == BMI160::INT1) ? 0xE6 : 0x6E);
+	snprintf(what, sizeof(what), "INT_EN_1 INT%u", pin + 1);
+	expect(what, imu.reg(BMI160::INT_EN_1), 0x17);
+}
+
+/* Sample k has x = k, y = -k, z = 1000 + k */
+static void push_sample(BMI160_Mock &imu, int16_t &next)
+{
+	imu.newSample(next, -next, 1000 + next);
+	next++;
+}
+
+static void check_samples(BMI160::InterruptPin pin, bool latched, bool edgeAfterCheck)
+{
+	BMI160_Mock imu;
+	InterruptIn irq(0);
+	AccAcquisition acq(imu, irq);
+	imu.connectPin(pin, &irq);
+	acq.start(BMI160::SENS_2G, pin);
+	if (latched) {
+		imu.setInterruptLatch(BMI160::INT_LATCHED);
+	}
+	int16_t next = 0;
+	bool raiseAfterCheck = false;
+	/* The next ODR tick ends the sleep */
+	HostIrq::wfi() = [&]() { push_sample(imu, next); };
+	if (edgeAfterCheck) {
+		/* The tick comes between the pin check and the sleep */
+		irq.afterRead = [&]() {
+			if (raiseAfterCheck) {
+				raiseAfterCheck = false;
+				push_sample(imu, next);
+			}
+		};
+	}
+	uint32_t mismatches = 0;
+	HostIrq::sleeps() = 0;
+	for (int16_t k = 0; k < SAMPLES; k++) {
+		raiseAfterCheck = edgeAfterCheck;
+		if (k == SAMPLES / 2) {
+			/* Sample ready before the call */
+			push_sample(imu, next);
+		}
+		BMI160::SensorData data;
+		acq.readSample(data);
+		if ((data.xAxis.raw != k) || (data.yAxis.raw != -k) || (data.zAxis.raw != 1000 + k)) {
+			mismatches++;
+		}
+	}
+	/* One sleep per sample, none for the sample ready before the call */
+	if ((next != SAMPLES) || (HostIrq::sleeps() != SAMPLES - 1)) {
+		mismatches++;
+	}
+	HostIrq::wfi() = Callback<void()>();
+	if (mismatches > 0) {
+		printf("FAIL INT%u %s%s: %u mismatches, %d samples raised, %u sleeps\n", pin + 1,
+		       latched ? "latched" : "non-latched", edgeAfterCheck ? ", edge after check" : "", mismatches,
+		       next, HostIrq::sleeps());
+		errors += mismatches;
+	}
+}
+
+/* Quiet frames, over the 1 g threshold at the listed positions */
+static void push_frames(BMI160_Mock &imu, uint16_t frames, uint16_t event1, uint16_t event2)
+{
+	for (uint16_t i = 0; i < frames; i++) {
+		imu.pushFifoFrame(((i == event1) || (i == event2)) ? TRIGGER_RAW : 0, 0, 0);
+	}
+}
+
+/**
+ * @brief  Sensor, acquisition and armed trigger window
+ */
+struct TriggerBench
+{
+	TriggerBench() : irq(0), acq(imu, irq), ring(storage, TRIGGER_SAMPLES, TRIGGER_SLACK, 3, TRIGGER_PRE)
+	{
+		acq.armTrigger(ring);
+	}
+
+	BMI160_Mock imu;
+	InterruptIn irq;
+	AccAcquisition acq;
+	acc_sample_t storage[2 * (TRIGGER_SAMPLES + TRIGGER_SLACK) * 3];
+	TriggerWindow ring;
+};
+
+static void check_trigger(const char *what, const TriggerWindow &ring, bool triggered, uint16_t age)
+{
+	if ((ring.triggered() != triggered) || (triggered && (ring.eventAge() != age))) {
+		printf("FAIL %-40s triggered %d, event age %u, expected %d, %u\n", what, ring.triggered(),
+		       ring.eventAge(), triggered, age);
+		errors++;
+	}
+}
+
+static void check_triggers(void)
+{
+	/* Sample 1 has 1 sample before it, sample 6 is the event */
+	TriggerBench single;
+	push_frames(single.imu, TRIGGER_SLACK, 1, 6);
+	single.acq.pollTrigger(single.ring, 1.0f);
+	check_trigger("pollTrigger early event", single.ring, true, TRIGGER_SLACK - 1 - 6);
+
+	/* The second ring holds 2 samples, not the 4 before the event */
+	TriggerBench first;
+	TriggerBench second;
+	push_frames(first.imu, TRIGGER_SLACK, 6, 6);
+	push_frames(second.imu, 2, 2, 2);
+	AccAcquisition::pollTriggers(first.acq, first.ring, second.acq, second.ring, 1.0f);
+	check_trigger("pollTriggers refused, first ring", first.ring, false, 0);
+	check_trigger("pollTriggers refused, second ring", second.ring, false, 0);
+
+	/* Event of the second ring set on both */
+	push_frames(first.imu, TRIGGER_SLACK, TRIGGER_SLACK, TRIGGER_SLACK);
+	push_frames(second.imu, TRIGGER_SLACK, TRIGGER_SLACK, TRIGGER_SLACK);
+	AccAcquisition::pollTriggers(first.acq, first.ring, second.acq, second.ring, 1.0f);
+	push_frames(first.imu, TRIGGER_SLACK, TRIGGER_SLACK, TRIGGER_SLACK);
+	push_frames(second.imu, TRIGGER_SLACK, 3, 3);
+	AccAcquisition::pollTriggers(first.acq, first.ring, second.acq, second.ring, 1.0f);
+	check_trigger("pollTriggers shared, first ring", first.ring, true, TRIGGER_SLACK - 1 - 3);
+	check_trigger("pollTriggers shared, second ring", second.ring, true, TRIGGER_SLACK - 1 - 3);
+}
+
+int main()
+{
+	check_registers(BMI160::INT1);
+	check_registers(BMI160::INT2);
+	for (uint8_t pin = BMI160::INT1; pin <= BMI160::INT2; pin++) {
+		for (uint8_t latched = 0; latched < 2; latched++) {
+			check_samples((BMI160::InterruptPin)pin, latched, false);
+			check_samples((BMI160::InterruptPin)pin, latched, true);
+		}
+	}
+	check_triggers();
+	printf("%s: %u mismatches\n", errors ? "FAIL" : "PASS", errors);
+	return errors;
+}
@@ -0,0 +1,273 @@
+/**
+*******************************************************************************
+* @file   bmi160_bench.cpp
+* @brief  Host benchmark of the BMI160 driver over a mock bus
+*******************************************************************************
+* Runs the window acquisition paths of the applications against BMI160_Mock,
+* checks the decoded samples and reports, per path:
+* - host CPU time per sample spent in the driver
+* - bus transactions and bytes per window
+* - the bus time this traffic would take on I2C at 400kHz and SPI at 10MHz
+* The 6-axis paths read the gyroscope with the accelerometer: two register
+* reads per sample, one burst per sample, or 12 byte FIFO frames.
+*
+* Usage: bmi160_bench [window samples] [iterations]
+*******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "bmi160_mock.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+/* Defines -------------------------------------------------------------------*/
+#define AXIS_NUMBER 3
+#define IMU_AXIS_NUMBER 6 /* Accelerometer and gyroscope */
+#define WATERMARK_FRAMES (BMI160::DEFAULT_FIFO_CONFIG.watermark / BMI160::FIFO_ACC_FRAME_SIZE)
+#define IMU_WATERMARK_FRAMES (BMI160::DEFAULT_FIFO_CONFIG.watermark / BMI160::FIFO_GYRO_ACC_FRAME_SIZE)
+#define I2C_BITS_PER_BYTE 9.0 /* 8 data bits and ACK */
+#define I2C_HZ 400000.0
+#define SPI_HZ 10000000.0
+#define LSB_PER_G 16384.0F /* SENS_2G */
+
+typedef std::chrono::steady_clock Clock;
+
+/* Variables -----------------------------------------------------------------*/
+static uint32_t errors = 0;
+
+/* Functions definition ------------------------------------------------------*/
+static int16_t sample_value(uint32_t sample, uint8_t axis)
+{
+	return (int16_t)((sample * 37 + axis * 1000) % 32768 - 16384);
+}
+
+static void check(const float *window, uint32_t first, uint16_t samples, uint8_t axes = AXIS_NUMBER)
+{
+	float gyro_scale = BMI160::getGyroScale(BMI160::DPS_2000);
+	for (uint16_t i = 0; i < samples; i++) {
+		for (uint8_t axis = 0; axis < axes; axis++) {
+			/* Accelerometer then gyroscope */
+			float expected = (axis < 3) ? sample_value(first + i, axis) / LSB_PER_G
+			                            : sample_value(first + i, axis) * gyro_scale;
+			if (fabsf(window[axes * i + axis] - expected) > 1e-6F * (1.F + fabsf(expected))) {
+				errors++;
+			}
+		}
+	}
+}
+
+static void report(const char *name, BMI160_Mock &imu, double seconds, uint32_t windows, uint16_t samples)
+{
+	double transactions = (double)imu.transactions() / windows;
+	double bytes = (double)imu.busBytes() / windows;
+	printf("%-22s %8.1f ns/sample %8.1f transactions/window %9.1f bytes/window"
+		"  bus ms/window: I2C %6.2f SPI %5.2f\n",
+		name, seconds * 1e9 / ((double)windows * samples), transactions, bytes,
+		1e3 * bytes * I2C_BITS_PER_BYTE / I2C_HZ, 1e3 * bytes * 8. / SPI_HZ);
+}
+
+int main(int argc, char *argv[])
+{
+	uint16_t samples = (argc > 1) ? atoi(argv[1]) : 512;
+	uint32_t iterations = (argc > 2) ? atoi(argv[2]) : 2000;
+	std::vector<float> window(AXIS_NUMBER * samples);
+	BMI160_Mock imu;
+	uint16_t frames;
+	double seconds;
+
+	printf("window: %u samples, %u iterations\n", samples, iterations);
+
+	/* FIFO drained at every watermark, as AccCapture does */
+	imu.resetCounters();
+	seconds = 0.;
+	for (uint32_t it = 0; it < iterations; it++) {
+		uint16_t filled = 0;
+		while (filled < samples) {
+			uint16_t burst = samples - filled;
+			if (burst > WATERMARK_FRAMES) {
+				burst = WATERMARK_FRAMES;
+			}
+			for (uint16_t i = 0; i < burst; i++) {
+				imu.pushFifoFrame(sample_value(filled + i, 0), sample_value(filled + i, 1), sample_value(filled + i, 2));
+			}
+			Clock::time_point start = Clock::now();
+			imu.getFifoAccXYZ(&window[AXIS_NUMBER * filled], samples - filled, frames, BMI160::SENS_2G);
+			seconds += std::chrono::duration<double>(Clock::now() - start).count();
+			filled += frames;
+		}
+		check(&window[0], 0, samples);
+	}
+	report("FIFO at watermark", imu, seconds, iterations, samples);
+
+	/* Raw int16 windows, as stored with -DWINDOW_INT16 */
+	std::vector<int16_t> raw_window(AXIS_NUMBER * samples);
+	imu.resetCounters();
+	seconds = 0.;
+	for (uint32_t it = 0; it < iterations; it++) {
+		uint16_t filled = 0;
+		while (filled < samples) {
+			uint16_t burst = samples - filled;
+			if (burst > WATERMARK_FRAMES) {
+				burst = WATERMARK_FRAMES;
+			}
+			for (uint16_t i = 0; i < burst; i++) {
+				imu.pushFifoFrame(sample_value(filled + i, 0), sample_value(filled + i, 1), sample_value(filled + i, 2));
+			}
+			Clock::time_point start = Clock::now();
+			imu.getFifoAccXYZ(&raw_window[AXIS_NUMBER * filled], samples - filled, frames);
+			seconds += std::chrono::duration<double>(Clock::now() - start).count();
+			filled += frames;
+		}
+		BMI160::scaleRaw(&raw_window[0], &window[0], AXIS_NUMBER * samples, BMI160::getAccScale(BMI160::SENS_2G));
+		check(&window[0], 0, samples);
+	}
+	report("FIFO raw at watermark", imu, seconds, iterations, samples);
+
+	/* FIFO drained every 10ms at 800Hz, as AccAcquisition::fillWindow does */
+	imu.resetCounters();
+	seconds = 0.;
+	for (uint32_t it = 0; it < iterations; it++) {
+		uint16_t filled = 0;
+		while (filled < samples) {
+			for (uint16_t i = 0; i < 8 && filled + i < samples; i++) {
+				imu.pushFifoFrame(sample_value(filled + i, 0), sample_value(filled + i, 1), sample_value(filled + i, 2));
+			}
+			Clock::time_point start = Clock::now();
+			imu.getFifoAccXYZ(&window[AXIS_NUMBER * filled], samples - filled, frames, BMI160::SENS_2G);
+			seconds += std::chrono::duration<double>(Clock::now() - start).count();
+			filled += frames;
+		}
+		check(&window[0], 0, samples);
+	}
+	report("FIFO polled 10ms", imu, seconds, iterations, samples);
+
+	/* One data register read per sample, as before the FIFO */
+	BMI160::SensorData data;
+	imu.resetCounters();
+	seconds = 0.;
+	for (uint32_t it = 0; it < iterations; it++) {
+		for (uint16_t i = 0; i < samples; i++) {
+			imu.setAccData(sample_value(i, 0), sample_value(i, 1), sample_value(i, 2));
+			Clock::time_point start = Clock::now();
+			imu.getSensorXYZ(data, BMI160::SENS_2G);
+			seconds += std::chrono::duration<double>(Clock::now() - start).count();
+			window[AXIS_NUMBER * i] = data.xAxis.scaled;
+			window[AXIS_NUMBER * i + 1] = data.yAxis.scaled;
+			window[AXIS_NUMBER * i + 2] = data.zAxis.scaled;
+		}
+		check(&window[0], 0, samples);
+	}
+	report("data registers", imu, seconds, iterations, samples);
+
+	/* 6 axes, accelerometer and gyroscope data registers read one after the other */
+	std::vector<float> imu_window(IMU_AXIS_NUMBER * samples);
+	BMI160::SensorData gyro;
+	BMI160::SensorTime time;
+	imu.resetCounters();
+	seconds = 0.;
+	for (uint32_t it = 0; it < iterations; it++) {
+		for (uint16_t i = 0; i < samples; i++) {
+			imu.setAccData(sample_value(i, 0), sample_value(i, 1), sample_value(i, 2));
+			imu.setGyroData(sample_value(i, 3), sample_value(i, 4), sample_value(i, 5));
+			Clock::time_point start = Clock::now();
+			imu.getSensorXYZ(data, BMI160::SENS_2G);
+			imu.getSensorXYZ(gyro, BMI160::DPS_2000);
+			seconds += std::chrono::duration<double>(Clock::now() - start).count();
+			imu_window[IMU_AXIS_NUMBER * i] = data.xAxis.scaled;
+			imu_window[IMU_AXIS_NUMBER * i + 1] = data.yAxis.scaled;
+			imu_window[IMU_AXIS_NUMBER * i + 2] = data.zAxis.scaled;
+			imu_window[IMU_AXIS_NUMBER * i + 3] = gyro.xAxis.scaled;
+			imu_window[IMU_AXIS_NUMBER * i + 4] = gyro.yAxis.scaled;
+			imu_window[IMU_AXIS_NUMBER * i + 5] = gyro.zAxis.scaled;
+		}
+		check(&imu_window[0], 0, samples, IMU_AXIS_NUMBER);
+	}
+	report("6-axis two reads", imu, seconds, iterations, samples);
+
+	/* 6 axes and sensor time in one burst per sample, AccAcquisition::readSample */
+	imu.resetCounters();
+	seconds = 0.;
+	for (uint32_t it = 0; it < iterations; it++) {
+		for (uint16_t i = 0; i < samples; i++) {
+			imu.setAccData(sample_value(i, 0), sample_value(i, 1), sample_value(i, 2));
+			imu.setGyroData(sample_value(i, 3), sample_value(i, 4), sample_value(i, 5));
+			Clock::time_point start = Clock::now();
+			imu.getGyroAccXYZandSensorTime(data, gyro, time, BMI160::SENS_2G, BMI160::DPS_2000);
+			seconds += std::chrono::duration<double>(Clock::now() - start).count();
+			imu_window[IMU_AXIS_NUMBER * i] = data.xAxis.scaled;
+			imu_window[IMU_AXIS_NUMBER * i + 1] = data.yAxis.scaled;
+			imu_window[IMU_AXIS_NUMBER * i + 2] = data.zAxis.scaled;
+			imu_window[IMU_AXIS_NUMBER * i + 3] = gyro.xAxis.scaled;
+			imu_window[IMU_AXIS_NUMBER * i + 4] = gyro.yAxis.scaled;
+			imu_window[IMU_AXIS_NUMBER * i + 5] = gyro.zAxis.scaled;
+		}
+		check(&imu_window[0], 0, samples, IMU_AXIS_NUMBER);
+	}
+	report("6-axis burst", imu, seconds, iterations, samples);
+
+	/* 6 axes from 12 byte FIFO frames drained at every watermark */
+	imu.resetCounters();
+	seconds = 0.;
+	for (uint32_t it = 0; it < iterations; it++) {
+		uint16_t filled = 0;
+		while (filled < samples) {
+			uint16_t burst = samples - filled;
+			if (burst > IMU_WATERMARK_FRAMES) {
+				burst = IMU_WATERMARK_FRAMES;
+			}
+			for (uint16_t i = 0; i < burst; i++) {
+				imu.pushFifoGyroAccFrame(sample_value(filled + i, 3), sample_value(filled + i, 4),
+				                         sample_value(filled + i, 5), sample_value(filled + i, 0),
+				                         sample_value(filled + i, 1), sample_value(filled + i, 2));
+			}
+			Clock::time_point start = Clock::now();
+			imu.getFifoGyroAccXYZ(&imu_window[IMU_AXIS_NUMBER * filled], samples - filled, frames,
+			                      BMI160::SENS_2G, BMI160::DPS_2000);
+			seconds += std::chrono::duration<double>(Clock::now() - start).count();
+			filled += frames;
+		}
+		check(&imu_window[0], 0, samples, IMU_AXIS_NUMBER);
+	}
+	report("6-axis FIFO watermark", imu, seconds, iterations, samples);
+
+	/* Same, raw int16 counts */
+	std::vector<int16_t> imu_raw(IMU_AXIS_NUMBER * samples);
+	imu.resetCounters();
+	seconds = 0.;
+	for (uint32_t it = 0; it < iterations; it++) {
+		uint16_t filled = 0;
+		while (filled < samples) {
+			uint16_t burst = samples - filled;
+			if (burst > IMU_WATERMARK_FRAMES) {
+				burst = IMU_WATERMARK_FRAMES;
+			}
+			for (uint16_t i = 0; i < burst; i++) {
+				imu.pushFifoGyroAccFrame(sample_value(filled + i, 3), sample_value(filled + i, 4),
+				                         sample_value(filled + i, 5), sample_value(filled + i, 0),
+				                         sample_value(filled + i, 1), sample_value(filled + i, 2));
+			}
+			Clock::time_point start = Clock::now();
+			imu.getFifoGyroAccXYZ(&imu_raw[IMU_AXIS_NUMBER * filled], samples - filled, frames);
+			seconds += std::chrono::duration<double>(Clock::now() - start).count();
+			filled += frames;
+		}
+		for (uint16_t i = 0; i < samples; i++) {
+			for (uint8_t axis = 0; axis < IMU_AXIS_NUMBER; axis++) {
+				if (imu_raw[IMU_AXIS_NUMBER * i + axis] != sample_value(i, axis)) {
+					errors++;
+				}
+			}
+		}
+	}
+	report("6-axis FIFO raw", imu, seconds, iterations, samples);
+
+	if (errors > 0) {
+		printf("FAILED: %u decoded values differ\n", errors);
+		return 1;
+	}
+	printf("all decoded values match\n");
+	return 0;
+}
@@ -0,0 +1,141 @@
+/**
+*******************************************************************************
+* @file   bmi160_fifo_check.cpp
+* @brief  Host check of the BMI160 FIFO configuration and frame decoding
+*******************************************************************************
+* Configures the FIFO of BMI160_Mock through the driver and compares
+* FIFO_DOWNS, FIFO_CONFIG_0 (watermark in 4 byte units) and FIFO_CONFIG_1
+* with the values of the BMI160 datasheet, and reads them back. Then drains
+* headerless accelerometer frames with getFifoAccXYZ() and checks:
+* - raw and scaled values, full scale and sign included, for every range
+* - one FIFO_LENGTH read and one FIFO_DATA burst per call
+* - maxFrames honoured, the other frames left in the FIFO for the next call
+* - an empty FIFO read as 0 frames
+*
+* Usage: bmi160_fifo_check
+* Exits with the number of mismatches.
+*******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "bmi160_mock.h"
+#include <cmath>
+#include <cstdio>
+
+/* Defines -------------------------------------------------------------------*/
+#define FRAMES 8
+
+/* Variables -----------------------------------------------------------------*/
+static uint32_t errors = 0;
+
+/* Frame k: full scale, sign and byte order patterns */
+static const int16_t frames[FRAMES][3] = {
+	{0, 0, 0},
+	{1, -1, 256},
+	{32767, -32768, -256},
+	{-2, 255, 16384},
+	{-16384, 8192, 1},
+	{0x1234, -0x1234, 0x7F80},
+	{-32767, 32767, -32768},
+	{100, -200, 300},
+};
+
+/* Functions definition ------------------------------------------------------*/
+static void expect(const char *what, uint32_t value, uint32_t expected)
+{
+	if (value != expected) {
+		printf("FAIL %-40s 0x%02X, expected 0x%02X\n", what, value, expected);
+		errors++;
+	}
+}
+
+static void push_frames(BMI160_Mock &imu, uint16_t first, uint16_t count)
+{
+	for (uint16_t k = first; k < first + count; k++) {
+		imu.pushFifoFrame(frames[k][0], frames[k][1], frames[k][2]);
+	}
+}
+
+static void check_config(const char *name, const BMI160::FifoConfig &config, uint8_t downs, uint8_t config0,
+                         uint8_t config1)
+{
+	BMI160_Mock imu;
+	char what[64];
+	imu.setFifoConfig(config);
+	snprintf(what, sizeof(what), "FIFO_DOWNS %s", name);
+	expect(what, imu.reg(BMI160::FIFO_DOWNS), downs);
+	snprintf(what, sizeof(what), "FIFO_CONFIG_0 %s", name);
+	expect(what, imu.reg(BMI160::FIFO_CONFIG_0), config0);
+	snprintf(what, sizeof(what), "FIFO_CONFIG_1 %s", name);
+	expect(what, imu.reg(BMI160::FIFO_CONFIG_1), config1);
+	BMI160::FifoConfig read = {false, false, BMI160::FIFO_DOWNS_1, 0, false};
+	imu.getFifoConfig(read);
+	snprintf(what, sizeof(what), "getFifoConfig %s", name);
+	expect(what, (read.accEnable == config.accEnable) && (read.accFiltered == config.accFiltered)
+	             && (read.accDowns == config.accDowns) && (read.gyroEnable == config.gyroEnable)
+	             && (read.watermark == config.watermark),
+	       true);
+}
+
+static void check_raw(void)
+{
+	BMI160_Mock imu;
+	int16_t buffer[FRAMES * 3];
+	uint16_t numFrames = 0;
+	push_frames(imu, 0, FRAMES);
+	imu.resetCounters();
+	/* Fewer frames than stored: the others stay for the next call */
+	expect("raw status", imu.getFifoAccXYZ(buffer, 3, numFrames), BMI160::RTN_NO_ERROR);
+	expect("raw frames", numFrames, 3);
+	expect("raw transactions", imu.transactions(), 2);
+	expect("raw bytes left", imu.fifoBytes(), (FRAMES - 3) * BMI160::FIFO_ACC_FRAME_SIZE);
+	imu.getFifoAccXYZ(&buffer[3 * 3], FRAMES, numFrames);
+	expect("raw frames, second call", numFrames, FRAMES - 3);
+	for (uint16_t k = 0; k < FRAMES; k++) {
+		for (uint8_t a = 0; a < 3; a++) {
+			if (buffer[3 * k + a] != frames[k][a]) {
+				printf("FAIL raw frame %u axis %u: %d, expected %d\n", k, a, buffer[3 * k + a], frames[k][a]);
+				errors++;
+			}
+		}
+	}
+	expect("raw empty status", imu.getFifoAccXYZ(buffer, FRAMES, numFrames), BMI160::RTN_NO_ERROR);
+	expect("raw empty frames", numFrames, 0);
+}
+
+static void check_scaled(BMI160::AccRange range, float g_per_lsb)
+{
+	BMI160_Mock imu;
+	float buffer[FRAMES * 3];
+	uint16_t numFrames = 0;
+	push_frames(imu, 0, FRAMES);
+	imu.getFifoAccXYZ(buffer, FRAMES, numFrames, range);
+	expect("scaled frames", numFrames, FRAMES);
+	for (uint16_t k = 0; k < FRAMES; k++) {
+		for (uint8_t a = 0; a < 3; a++) {
+			float expected = frames[k][a] * g_per_lsb;
+			if (fabsf(buffer[3 * k + a] - expected) > 1e-6F * (1.F + fabsf(expected))) {
+				printf("FAIL range 0x%X frame %u axis %u: %f, expected %f\n", range, k, a, buffer[3 * k + a],
+				       expected);
+				errors++;
+			}
+		}
+	}
+}
+
+int main()
+{
+	/* Defaults: filtered, every sample, 504 byte watermark, accelerometer only */
+	check_config("default", BMI160::DEFAULT_FIFO_CONFIG, 0x80, 126, 0x40);
+	const BMI160::FifoConfig downs8 = {true, false, BMI160::FIFO_DOWNS_8, 96, false};
+	check_config("downs 8", downs8, 0x30, 24, 0x40);
+	const BMI160::FifoConfig gyro = {true, true, BMI160::FIFO_DOWNS_2, 1020, true};
+	check_config("gyro", gyro, 0x99, 255, 0xC0);
+	check_raw();
+	check_scaled(BMI160::SENS_2G, 1.F / 16384.F);
+	check_scaled(BMI160::SENS_4G, 1.F / 8192.F);
+	check_scaled(BMI160::SENS_8G, 1.F / 4096.F);
+	check_scaled(BMI160::SENS_16G, 1.F / 2048.F);
+	printf("%s: %u mismatches\n", errors ? "FAIL" : "PASS", errors);
+	return errors;
+}
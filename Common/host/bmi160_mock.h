@@ -0,0 +1,285 @@
+/**********************************************************************
+* BMI160 register model for host builds of the driver.
+**********************************************************************/
+
+
+#ifndef BMI160_MOCK_H
+#define BMI160_MOCK_H
+
+
+#include "bmi160.h"
+#include "perf_stats.h"
+#include <vector>
+
+
+/**
+@brief BMI160_Mock - BMI160 object backed by an in-memory register file
+
+Implements the bus primitives of BMI160 over a register array and a FIFO
+byte queue, and counts the bus traffic each driver call generates. Every
+transaction is counted as one address byte plus its payload.
+
+MCU pins connected with connectPin() get the data interrupts as configured 
+in INT_EN_1, INT_MAP_1, INT_OUT_CTRL and INT_LATCH: a pulse per event when 
+non-latched, a level held until the next read of the data registers 
+otherwise.
+*/
+class BMI160_Mock: public BMI160
+{
+public:
+
+    ///Number of addressable registers
+    static const uint32_t NUM_REGISTERS = 0x80;
+    
+    ///Byte read from FIFO_DATA once the FIFO is empty
+    static const uint8_t FIFO_EMPTY_BYTE = 0x80;
+    
+    
+    ///@brief BMI160_Mock Constructor.\n
+    BMI160_Mock(): m_fifoHead(0), m_transactions(0), m_busBytes(0)
+    {
+        memset(m_regs, 0, sizeof(m_regs));
+        m_pins[INT1] = NULL;
+        m_pins[INT2] = NULL;
+    }
+    
+    
+    ///@brief Wires a sensor interrupt pin to an MCU pin.
+
+    void connectPin(InterruptPin pin, InterruptIn *irq) { m_pins[pin] = irq; }
+    
+    
+    ///@brief New accelerometer sample in the data registers, raises the 
+    ///data ready interrupt as the sensor does at each ODR tick.
+
+    void newSample(int16_t x, int16_t y, int16_t z)
+    {
+        setAccData(x, y, z);
+        raise(DRDY_INT, INT1_MAP_DRDY_MASK, INT2_MAP_DRDY_MASK);
+    }
+    
+    
+    ///@brief Appends one headerless accelerometer frame to the FIFO.\n
+    void pushFifoFrame(int16_t x, int16_t y, int16_t z)
+    {
+        const int16_t axes[3] = {x, y, z};
+        for(uint8_t idx = 0; idx < 3; idx++)
+        {
+            m_fifo.push_back(axes[idx] & 0xFF);
+            m_fifo.push_back((axes[idx] >> 8) & 0xFF);
+        }
+    }
+    
+    
+    ///@brief Appends one headerless gyroscope and accelerometer frame to 
+    ///the FIFO, gyroscope first as written by the sensor.\n
+    void pushFifoGyroAccFrame(int16_t gx, int16_t gy, int16_t gz, 
+                              int16_t ax, int16_t ay, int16_t az)
+    {
+        const int16_t axes[6] = {gx, gy, gz, ax, ay, az};
+        for(uint8_t idx = 0; idx < 6; idx++)
+        {
+            m_fifo.push_back(axes[idx] & 0xFF);
+            m_fifo.push_back((axes[idx] >> 8) & 0xFF);
+        }
+    }
+    
+    
+    ///@brief Sets the gyroscope data registers.\n
+    void setGyroData(int16_t x, int16_t y, int16_t z)
+    {
+        const int16_t axes[3] = {x, y, z};
+        for(uint8_t idx = 0; idx < 3; idx++)
+        {
+            m_regs[DATA_8 + (2 * idx)] = (axes[idx] & 0xFF);
+            m_regs[DATA_8 + (2 * idx) + 1] = ((axes[idx] >> 8) & 0xFF);
+        }
+    }
+    
+    
+    ///@brief Sets the accelerometer data registers.\n
+    void setAccData(int16_t x, int16_t y, int16_t z)
+    {
+        const int16_t axes[3] = {x, y, z};
+        for(uint8_t idx = 0; idx < 3; idx++)
+        {
+            m_regs[DATA_14 + (2 * idx)] = (axes[idx] & 0xFF);
+            m_regs[DATA_14 + (2 * idx) + 1] = ((axes[idx] >> 8) & 0xFF);
+        }
+    }
+    
+    
+    ///@brief Sets the 24 bit sensor time registers.\n
+    void setSensorTime(uint32_t ticks)
+    {
+        m_regs[SENSORTIME_0] = (ticks & 0xFF);
+        m_regs[SENSORTIME_1] = ((ticks >> 8) & 0xFF);
+        m_regs[SENSORTIME_2] = ((ticks >> 16) & 0xFF);
+    }
+    
+    
+    ///@brief Value last written to a register.\n
+    uint8_t reg(Registers reg) const { return m_regs[reg]; }
+    
+    ///@brief Presets a register, as the sensor would hold it.
+    void setReg(Registers reg, uint8_t value) { m_regs[reg] = value; }
+    
+    ///@brief Bytes waiting in the FIFO.\n
+    uint32_t fifoBytes() const { return m_fifo.size() - m_fifoHead; }
+    
+    ///@brief Bus transactions since the last resetCounters().\n
+    uint32_t transactions() const { return m_transactions; }
+    
+    ///@brief Bus bytes since the last resetCounters().\n
+    uint32_t busBytes() const { return m_busBytes; }
+    
+    ///@brief Clears the bus traffic counters.\n
+    void resetCounters()
+    {
+        m_transactions = 0;
+        m_busBytes = 0;
+    }
+    
+    
+    virtual int32_t readRegister(Registers reg, uint8_t *data)
+    {
+        return readBlock(reg, reg, data);
+    }
+    
+    
+    virtual int32_t writeRegister(Registers reg, const uint8_t data)
+    {
+        return writeBlock(reg, reg, &data);
+    }
+    
+    
+    virtual int32_t readBlock(Registers startReg, Registers stopReg, 
+    uint8_t *data)
+    {
+        uint32_t numBytes = ((stopReg - startReg) + 1);
+        count(numBytes);
+        updateFifoLength();
+        memcpy(data, &m_regs[startReg], numBytes);
+        if((startReg <= DATA_19) && (stopReg >= DATA_14))
+        {
+            //Reading the sample clears a latched data ready level
+            release(INT1);
+            release(INT2);
+        }
+        return RTN_NO_ERROR;
+    }
+    
+    
+    virtual int32_t writeBlock(Registers startReg, Registers stopReg, 
+    const uint8_t *data)
+    {
+        uint32_t numBytes = ((stopReg - startReg) + 1);
+        count(numBytes);
+        memcpy(&m_regs[startReg], data, numBytes);
+        if((startReg <= CMD) && (stopReg >= CMD) && 
+           (m_regs[CMD] == FIFO_FLUSH))
+        {
+            m_fifo.clear();
+            m_fifoHead = 0;
+        }
+        return RTN_NO_ERROR;
+    }
+    
+    
+    virtual int32_t readBurst(Registers reg, uint8_t *data, uint32_t numBytes)
+    {
+        if(reg != FIFO_DATA)
+        {
+            return readBlock(reg, static_cast<Registers>(reg + numBytes - 1), 
+                             data);
+        }
+        
+        count(numBytes);
+        for(uint32_t idx = 0; idx < numBytes; idx++)
+        {
+            data[idx] = (fifoBytes() > 0) ? m_fifo[m_fifoHead++] : 
+                                            FIFO_EMPTY_BYTE;
+        }
+        if(m_fifoHead == m_fifo.size())
+        {
+            m_fifo.clear();
+            m_fifoHead = 0;
+        }
+        return RTN_NO_ERROR;
+    }
+    
+private:
+
+    bool pinActiveHigh(InterruptPin pin) const
+    {
+        uint8_t ctrl = (m_regs[INT_OUT_CTRL] >> 
+                        ((pin == INT1) ? INT1_OUT_CTRL_POS : INT2_OUT_CTRL_POS));
+        return ((ctrl >> INT_LVL_POS) & 1);
+    }
+    
+    bool pinOutput(InterruptPin pin) const
+    {
+        uint8_t ctrl = (m_regs[INT_OUT_CTRL] >> 
+                        ((pin == INT1) ? INT1_OUT_CTRL_POS : INT2_OUT_CTRL_POS));
+        return ((m_pins[pin] != NULL) && ((ctrl >> INT_OUTPUT_EN_POS) & 1));
+    }
+    
+    void raise(DataInterrupt source, uint8_t int1Map, uint8_t int2Map)
+    {
+        if(!(m_regs[INT_EN_1] & source))
+        {
+            return;
+        }
+        const uint8_t maps[2] = {int1Map, int2Map};
+        for(uint8_t pin = INT1; pin <= INT2; pin++)
+        {
+            InterruptPin intPin = static_cast<InterruptPin>(pin);
+            if(!pinOutput(intPin) || !(m_regs[INT_MAP_1] & maps[pin]))
+            {
+                continue;
+            }
+            bool activeHigh = pinActiveHigh(intPin);
+            m_pins[pin]->inject(activeHigh);
+            if((m_regs[INT_LATCH] & INT_LATCH_MASK) == INT_NON_LATCHED)
+            {
+                m_pins[pin]->inject(!activeHigh);
+            }
+        }
+    }
+    
+    void release(InterruptPin pin)
+    {
+        if(pinOutput(pin))
+        {
+            m_pins[pin]->inject(!pinActiveHigh(pin));
+        }
+    }
+    
+    void count(uint32_t numBytes)
+    {
+        m_transactions++;
+        m_busBytes += (1 + numBytes);
+        PERF_COUNT(PERF_BUS_TRANSFERS, 1);
+        PERF_COUNT(PERF_BUS_BYTES, numBytes);
+    }
+    
+    void updateFifoLength()
+    {
+        uint32_t length = fifoBytes();
+        if(length > 1024)
+        {
+            length = 1024;
+        }
+        m_regs[FIFO_LENGTH_0] = (length & 0xFF);
+        m_regs[FIFO_LENGTH_1] = ((length >> 8) & FIFO_LENGTH_1_MASK);
+    }
+    
+    uint8_t m_regs[NUM_REGISTERS];
+    InterruptIn *m_pins[2];
+    std::vector<uint8_t> m_fifo;
+    size_t m_fifoHead;
+    uint32_t m_transactions;
+    uint32_t m_busBytes;
+};
+
+#endif /* BMI160_MOCK_H */
@@ -0,0 +1,125 @@
+/**
+*******************************************************************************
+* @file   bmi160_motion_check.cpp
+* @brief  Host check of the BMI160 motion interrupt configuration
+*******************************************************************************
+* Configures the any-motion and high-g engines of BMI160_Mock through the
+* driver and compares the register file with the values of the BMI160
+* datasheet, for every accelerometer range and both interrupt pins. Bits of
+* shared registers that belong to other interrupts must be left untouched.
+*
+* Usage: bmi160_motion_check
+* Exits with the number of mismatches.
+*******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "bmi160_mock.h"
+#include <cstdio>
+
+/* Variables -----------------------------------------------------------------*/
+static uint32_t errors = 0;
+
+/* Functions definition ------------------------------------------------------*/
+static void expect(const char *what, uint32_t value, uint32_t expected)
+{
+	if (value != expected) {
+		printf("FAIL %-40s 0x%02X, expected 0x%02X\n", what, value, expected);
+		errors++;
+	}
+}
+
+static void check_any_motion(BMI160::AccRange range, float mg_per_lsb)
+{
+	BMI160_Mock imu;
+	char what[64];
+	/* slo_no_mot_dur bits must stay */
+	imu.setReg(BMI160::INT_MOTION_0, 0xA8);
+	for (uint8_t samples = 0; samples <= 5; samples++) {
+		BMI160::AnyMotionConfig config = {10.F * mg_per_lsb / 1000.F, samples};
+		imu.setAnyMotionConfig(config, range);
+		uint8_t dur = (samples < 1) ? 0 : ((samples > 4) ? 3 : samples - 1);
+		snprintf(what, sizeof(what), "INT_MOTION_0 range 0x%X samples %u", range, samples);
+		expect(what, imu.reg(BMI160::INT_MOTION_0), 0xA8 | dur);
+		snprintf(what, sizeof(what), "INT_MOTION_1 range 0x%X", range);
+		expect(what, imu.reg(BMI160::INT_MOTION_1), 10);
+	}
+	BMI160::AnyMotionConfig saturated = {100.F, 1};
+	imu.setAnyMotionConfig(saturated, range);
+	snprintf(what, sizeof(what), "INT_MOTION_1 range 0x%X saturated", range);
+	expect(what, imu.reg(BMI160::INT_MOTION_1), 0xFF);
+}
+
+static void check_high_g(BMI160::AccRange range, float mg_per_lsb, float hy_mg_per_lsb)
+{
+	BMI160_Mock imu;
+	char what[64];
+	/* low-g mode and hysteresis bits must stay */
+	imu.setReg(BMI160::INT_LOWHIGH_2, 0x07);
+	BMI160::HighGConfig config = {100.F * mg_per_lsb / 1000.F, 2.F * hy_mg_per_lsb / 1000.F, 25.F};
+	imu.setHighGConfig(config, range);
+	snprintf(what, sizeof(what), "INT_LOWHIGH_2 range 0x%X", range);
+	expect(what, imu.reg(BMI160::INT_LOWHIGH_2), 0x87);
+	/* (9 + 1) * 2.5ms */
+	snprintf(what, sizeof(what), "INT_LOWHIGH_3 range 0x%X", range);
+	expect(what, imu.reg(BMI160::INT_LOWHIGH_3), 9);
+	snprintf(what, sizeof(what), "INT_LOWHIGH_4 range 0x%X", range);
+	expect(what, imu.reg(BMI160::INT_LOWHIGH_4), 100);
+	/* Hysteresis is 2 bits */
+	config.hysteresis = 10.F * hy_mg_per_lsb / 1000.F;
+	imu.setHighGConfig(config, range);
+	snprintf(what, sizeof(what), "INT_LOWHIGH_2 range 0x%X saturated", range);
+	expect(what, imu.reg(BMI160::INT_LOWHIGH_2), 0xC7);
+}
+
+static void check_mapping(BMI160::InterruptPin pin)
+{
+	BMI160_Mock imu;
+	char what[64];
+	BMI160::Registers map = (pin == BMI160::INT1) ? BMI160::INT_MAP_0 : BMI160::INT_MAP_2;
+	BMI160::Registers other = (pin == BMI160::INT1) ? BMI160::INT_MAP_2 : BMI160::INT_MAP_0;
+	/* Flat, orientation and tap enables and the data interrupts must stay */
+	imu.setReg(BMI160::INT_EN_0, 0xF0);
+	imu.setReg(BMI160::INT_EN_1, 0x70);
+	imu.setReg(map, 0x01);
+	imu.enableMotionInterrupt(BMI160::ANY_MOTION_INT, pin);
+	imu.enableMotionInterrupt(BMI160::HIGH_G_INT, pin);
+	snprintf(what, sizeof(what), "INT_EN_0 enable INT%u", pin + 1);
+	expect(what, imu.reg(BMI160::INT_EN_0), 0xF7);
+	snprintf(what, sizeof(what), "INT_EN_1 enable INT%u", pin + 1);
+	expect(what, imu.reg(BMI160::INT_EN_1), 0x77);
+	snprintf(what, sizeof(what), "map enable INT%u", pin + 1);
+	expect(what, imu.reg(map), 0x07);
+	snprintf(what, sizeof(what), "other map enable INT%u", pin + 1);
+	expect(what, imu.reg(other), 0x00);
+
+	imu.disableMotionInterrupt(BMI160::ANY_MOTION_INT);
+	snprintf(what, sizeof(what), "INT_EN_0 disable any-motion INT%u", pin + 1);
+	expect(what, imu.reg(BMI160::INT_EN_0), 0xF0);
+	snprintf(what, sizeof(what), "map disable any-motion INT%u", pin + 1);
+	expect(what, imu.reg(map), 0x03);
+	imu.disableMotionInterrupt(BMI160::HIGH_G_INT);
+	snprintf(what, sizeof(what), "INT_EN_1 disable high-g INT%u", pin + 1);
+	expect(what, imu.reg(BMI160::INT_EN_1), 0x70);
+	snprintf(what, sizeof(what), "map disable high-g INT%u", pin + 1);
+	expect(what, imu.reg(map), 0x01);
+}
+
+int main()
+{
+	/* Datasheet threshold resolutions per range, mg */
+	const BMI160::AccRange ranges[4] = {BMI160::SENS_2G, BMI160::SENS_4G, BMI160::SENS_8G, BMI160::SENS_16G};
+	const float any_motion_mg[4] = {3.91F, 7.81F, 15.63F, 31.25F};
+	const float high_g_mg[4] = {7.81F, 15.63F, 31.25F, 62.5F};
+	const float high_g_hy_mg[4] = {125.F, 250.F, 500.F, 1000.F};
+	for (uint8_t i = 0; i < 4; i++) {
+		check_any_motion(ranges[i], any_motion_mg[i]);
+		check_high_g(ranges[i], high_g_mg[i], high_g_hy_mg[i]);
+	}
+	check_mapping(BMI160::INT1);
+	check_mapping(BMI160::INT2);
+	check_high_g(BMI160::SENS_2G, 7.81F, 125.F);
+
+	printf("%s: %u mismatches\n", errors ? "FAIL" : "PASS", errors);
+	return errors;
+}
@@ -0,0 +1,166 @@
+/**
+*******************************************************************************
+* @file   bmi160_spi_check.cpp
+* @brief  Host check of the BMI160 SPI framing
+*******************************************************************************
+* Drives BMI160_SPI through the SPI and DigitalOut stand-ins of host/mbed.h
+* and checks the bytes of each chip select frame: a single dummy read of
+* 0x7F before the first access, the read bit (bit 7) set on reads only,
+* one CS low/high pair and one bus lock per access, and burst reads of a
+* register block in one frame. With -DDEVICE_SPI_ASYNCH=1 the long reads
+* take the asynchronous path; a transfer that does not start falls back to
+* a blocking read, and one ending in error is reported by readBlock().
+*
+* Usage: bmi160_spi_check
+* Exits with the number of mismatches.
+*******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "bmi160.h"
+#include <cstdio>
+#include <vector>
+
+/* Types ---------------------------------------------------------------------*/
+typedef std::vector<uint8_t> Bytes;
+
+/* Variables -----------------------------------------------------------------*/
+static uint32_t errors = 0;
+
+/* Functions definition ------------------------------------------------------*/
+/**
+ * @brief  Sensor on a host bus, with the bytes of each CS frame
+ */
+struct SpiBench
+{
+	SpiBench() : spi(0, 0, 0), cs(0), imu(spi, cs), stray(0), start(0)
+	{
+		cs.onWrite = [this](int value) {
+			if (value == 0) {
+				stray += spi.sent.size() - start;
+				start = spi.sent.size();
+			} else {
+				frames.push_back(Bytes(spi.sent.begin() + start, spi.sent.end()));
+				start = spi.sent.size();
+			}
+		};
+	}
+
+	SPI spi;
+	DigitalOut cs;
+	BMI160_SPI imu;
+	std::vector<Bytes> frames; /* Bytes clocked out in each CS low/high pair */
+	size_t stray;              /* Bytes clocked out with CS high */
+	size_t start;
+};
+
+static Bytes bytes(uint8_t first, uint8_t fill, size_t fills)
+{
+	Bytes frame(1, first);
+	frame.insert(frame.end(), fills, fill);
+	return frame;
+}
+
+static void expect_frames(const char *what, SpiBench &bench, const std::vector<Bytes> &frames)
+{
+	if ((bench.frames != frames) || (bench.stray != 0) || (bench.spi.locks != 0)) {
+		printf("FAIL %-36s %zu frames, expected %zu, %zu bytes with CS high, %d locks\n", what,
+		       bench.frames.size(), frames.size(), bench.stray, bench.spi.locks);
+		for (size_t i = 0; i < bench.frames.size(); i++) {
+			printf("     frame %zu:", i);
+			for (size_t j = 0; (j < bench.frames[i].size()) && (j < 8); j++) {
+				printf(" %02X", bench.frames[i][j]);
+			}
+			printf("\n");
+		}
+		errors++;
+	}
+	bench.frames.clear();
+}
+
+static void expect(const char *what, int32_t value, int32_t expected)
+{
+	if (value != expected) {
+		printf("FAIL %-36s %d, expected %d\n", what, value, expected);
+		errors++;
+	}
+}
+
+static void check_register_access(void)
+{
+	SpiBench bench;
+	uint8_t value = 0;
+	/* Dummy read, address byte, then the register */
+	bench.spi.miso = {0x00, 0x00, 0x00, 0xD1};
+	expect("readRegister status", bench.imu.readRegister(BMI160::CHIP_ID, &value), BMI160::RTN_NO_ERROR);
+	expect("readRegister value", value, 0xD1);
+	expect_frames("first read", bench, {{0xFF, 0x00}, {0x80, 0x00}});
+
+	bench.imu.writeRegister(BMI160::CMD, 0xB6);
+	expect_frames("write, no dummy read", bench, {{0x7E, 0xB6}});
+
+	bench.imu.readRegister(BMI160::FIFO_DATA, &value);
+	expect_frames("read bit", bench, {{0xA4, 0x00}});
+
+	const uint8_t config[2] = {0x28, 0x03};
+	bench.imu.writeBlock(BMI160::ACC_CONF, BMI160::ACC_RANGE, config);
+	expect_frames("block write", bench, {{0x40, 0x28, 0x03}});
+}
+
+static void check_burst(void)
+{
+	SpiBench bench;
+	uint8_t data[6];
+	bench.imu.writeRegister(BMI160::CMD, 0xB6);
+	bench.frames.clear();
+	/* DATA_14 to DATA_19, address then 6 bytes in one frame */
+	bench.spi.miso = {0x00, 1, 2, 3, 4, 5, 6};
+	expect("readBlock status", bench.imu.readBlock(BMI160::DATA_14, BMI160::DATA_19, data), BMI160::RTN_NO_ERROR);
+	expect_frames("readBlock one frame", bench, {bytes(0x80 | BMI160::DATA_14, 0xFF, 6)});
+	for (uint8_t i = 0; i < 6; i++) {
+		expect("readBlock data", data[i], i + 1);
+	}
+}
+
+static void check_long_read(const char *what, bool starts, int event, int32_t status, int transfers)
+{
+	SpiBench bench;
+	uint8_t data[64];
+	bench.imu.writeRegister(BMI160::CMD, 0xB6);
+	bench.frames.clear();
+	bench.spi.transferStarts = starts;
+	bench.spi.transferEvent = event;
+	bench.spi.miso.push_back(0x00);
+	for (uint8_t i = 0; i < sizeof(data); i++) {
+		bench.spi.miso.push_back(i);
+	}
+	expect(what, bench.imu.readBurst(BMI160::FIFO_DATA, data, sizeof(data)), status);
+	expect_frames(what, bench, {bytes(0x80 | BMI160::FIFO_DATA, 0xFF, sizeof(data))});
+	expect(what, bench.spi.transfers, transfers);
+	if (status == BMI160::RTN_NO_ERROR) {
+		for (uint8_t i = 0; i < sizeof(data); i++) {
+			expect(what, data[i], i);
+		}
+	}
+	/* The bus is usable after an error */
+	uint8_t value = 0;
+	bench.spi.miso = {0x00, 0x5A};
+	bench.imu.readRegister(BMI160::ERR_REG, &value);
+	expect(what, value, 0x5A);
+	expect_frames(what, bench, {{0x82, 0x00}});
+}
+
+int main()
+{
+	check_register_access();
+	check_burst();
+#if DEVICE_SPI_ASYNCH
+	check_long_read("asynchronous read", true, SPI_EVENT_COMPLETE, BMI160::RTN_NO_ERROR, 1);
+	check_long_read("asynchronous read not started", false, SPI_EVENT_COMPLETE, BMI160::RTN_NO_ERROR, 0);
+	check_long_read("asynchronous read error", true, SPI_EVENT_ERROR, -1, 1);
+#else
+	check_long_read("blocking read", true, SPI_EVENT_COMPLETE, BMI160::RTN_NO_ERROR, 0);
+#endif
+	printf("%s: %u mismatches\n", errors ? "FAIL" : "PASS", errors);
+	return errors;
+}
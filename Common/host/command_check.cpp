@@ -0,0 +1,146 @@
+/**
+*******************************************************************************
+* @file   command_check.cpp
+* @brief  Host check of CommandParser and CommandQueue
+*******************************************************************************
+* Feeds byte streams to CommandParser, one byte at a time as the RX interrupt
+* does, and compares the commands with the expected ones: valid commands,
+* line endings, case, blanks, malformed and oversized lines. Then checks the
+* CommandQueue order, full queue and drop count.
+*
+* Usage: command_check
+* Exits with the number of mismatches.
+*******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "command_parser.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/* Variables -----------------------------------------------------------------*/
+static uint32_t errors = 0;
+
+/* Functions definition ------------------------------------------------------*/
+static std::vector<Command> parse(const std::string &stream)
+{
+	CommandParser parser;
+	std::vector<Command> commands;
+	Command command;
+	for (size_t i = 0; i < stream.size(); i++) {
+		if (parser.feed(stream[i], command)) {
+			commands.push_back(command);
+		}
+	}
+	return commands;
+}
+
+static void expect(const std::string &stream, CommandType type, char target, int32_t value)
+{
+	std::vector<Command> commands = parse(stream);
+	std::string shown;
+	for (size_t i = 0; i < stream.size(); i++) {
+		shown += (stream[i] == '\r') ? "\\r" : (stream[i] == '\n') ? "\\n" : std::string(1, stream[i]);
+	}
+	if (commands.size() != 1) {
+		printf("FAIL %-32s %zu commands, expected 1\n", shown.c_str(), commands.size());
+		errors++;
+	} else if ((commands[0].type != type) || (commands[0].target != target) || (commands[0].value != value)) {
+		printf("FAIL %-32s type %d target '%c' value %d, expected %d '%c' %d\n", shown.c_str(),
+			commands[0].type, commands[0].target ? commands[0].target : ' ', commands[0].value,
+			type, target ? target : ' ', value);
+		errors++;
+	}
+}
+
+static void expect_error(const std::string &stream)
+{
+	expect(stream, CMD_ERROR, 0, 0);
+}
+
+static void check_parser(void)
+{
+	expect("B -1\n", CMD_SCORE, 'B', -1);
+	expect("R +2\r\n", CMD_SCORE, 'R', 2);
+	expect("r 3\r", CMD_SCORE, 'R', 3);
+	expect("  B\t+10  \n", CMD_SCORE, 'B', 10);
+	expect("B+1\n", CMD_SCORE, 'B', 1);
+	expect("reset\n", CMD_RESET, 0, 0);
+	expect("RESET  \n", CMD_RESET, 0, 0);
+	expect("SENS 1.5\n", CMD_SENSITIVITY, 0, 1500);
+	expect("sens 0.125\n", CMD_SENSITIVITY, 0, 125);
+	expect("SENS 2\n", CMD_SENSITIVITY, 0, 2000);
+	expect("SENS 3.\n", CMD_SENSITIVITY, 0, 3000);
+	expect("MODE 1\n", CMD_MODE, 0, 1);
+	expect("stats\n", CMD_STATS, 0, 0);
+
+	expect_error("B\n");
+	expect_error("B -\n");
+	expect_error("B 1.5\n");
+	expect_error("B 1 2\n");
+	expect_error("X 1\n");
+	expect_error("1 B\n");
+	expect_error("RESET 1\n");
+	expect_error("SENS -1\n");
+	expect_error("SENS 1.2345\n");
+	expect_error("MODE\n");
+	expect_error("STATS 1\n");
+	expect_error("B 99999999999999999999\n");
+	expect_error("ABCDEFGHIJKLMNOPQRSTUVWXYZ\n");
+	expect_error(std::string(200, 'B') + " 1\n");
+	expect_error("B \x01 1\n");
+
+	/* Several commands and blank lines in one stream */
+	std::vector<Command> commands = parse("\r\n\nB 1\r\n\r\nbad\nR -2\n");
+	if ((commands.size() != 3) || (commands[0].type != CMD_SCORE) || (commands[1].type != CMD_ERROR) ||
+	    (commands[2].value != -2)) {
+		printf("FAIL stream of 3 commands\n");
+		errors++;
+	}
+	/* A line without end is not a command yet */
+	if (!parse("B 1").empty()) {
+		printf("FAIL unterminated line\n");
+		errors++;
+	}
+}
+
+static void check_queue(void)
+{
+	CommandQueue queue;
+	Command command = {CMD_SCORE, 'B', 0};
+	for (int32_t i = 0; i < CommandQueue::SLOTS + 3; i++) {
+		command.value = i;
+		queue.push(command);
+	}
+	if (queue.dropped() != 3) {
+		printf("FAIL queue dropped %u, expected 3\n", queue.dropped());
+		errors++;
+	}
+	for (int32_t i = 0; i < CommandQueue::SLOTS; i++) {
+		if (!queue.pop(command) || (command.value != i)) {
+			printf("FAIL queue order at %d\n", i);
+			errors++;
+		}
+	}
+	if (queue.pop(command)) {
+		printf("FAIL queue not empty\n");
+		errors++;
+	}
+	/* Wrap around */
+	for (int32_t i = 0; i < 3 * CommandQueue::SLOTS; i++) {
+		command.value = i;
+		if (!queue.push(command) || !queue.pop(command) || (command.value != i)) {
+			printf("FAIL queue wrap at %d\n", i);
+			errors++;
+		}
+	}
+}
+
+int main()
+{
+	check_parser();
+	check_queue();
+	printf("%s: %u mismatches\n", errors ? "FAIL" : "PASS", errors);
+	return errors;
+}
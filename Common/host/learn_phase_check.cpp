@@ -0,0 +1,122 @@
+/**
+*******************************************************************************
+* @file   learn_phase_check.cpp
+* @brief  Host check of LearnPhase
+*******************************************************************************
+* Runs the learning loop of the applications with synthetic similarity
+* curves in place of NanoEdgeAI_detect and checks when it stops: rising then
+* stable scores, scores stable under minSimilarity, noisy scores, minWindows,
+* maxWindows, reset, and that the first window is never scored.
+*
+* Usage: learn_phase_check
+* Exits with the number of mismatches.
+*******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "learn_phase.h"
+#include <cstdio>
+
+/* Variables -----------------------------------------------------------------*/
+static uint32_t errors = 0;
+
+/* Functions definition ------------------------------------------------------*/
+/* Similarity of the window learned after `windows` windows */
+typedef uint8_t (*Curve)(uint16_t windows);
+
+static uint8_t rising(uint16_t windows)
+{
+	/* 40% after one window, +5 per window up to 95% */
+	return (windows >= 12) ? 95 : 40 + 5 * (windows - 1);
+}
+
+static uint8_t stable_low(uint16_t windows)
+{
+	(void)windows;
+	return 70;
+}
+
+static uint8_t noisy(uint16_t windows)
+{
+	return (windows % 2) ? 92 : 99;
+}
+
+static uint8_t perfect(uint16_t windows)
+{
+	(void)windows;
+	return 100;
+}
+
+static void expect(const char *name, const LearnPhase::Config &config, Curve curve,
+                   LearnPhase::State state, uint16_t windows)
+{
+	LearnPhase phase(config);
+	uint32_t mismatches = 0;
+	uint32_t loops = 0;
+	while (!phase.done() && (loops++ < 1000)) {
+		if (phase.scoreNext()) {
+			if (phase.windows() == 0) {
+				mismatches++;
+			}
+			phase.scored(curve(phase.windows()));
+		}
+		phase.learned();
+		if ((phase.progress() > 100) || (phase.done() != (phase.progress() == 100))) {
+			mismatches++;
+		}
+	}
+	if ((phase.state() != state) || (phase.windows() != windows)) {
+		printf("FAIL %-28s state %d after %u windows, expected %d after %u\n", name, phase.state(),
+		       phase.windows(), state, windows);
+		mismatches++;
+	}
+	errors += mismatches;
+	printf("%-28s state %d after %u windows, similarity %u, spread %u\n", name, phase.state(),
+	       phase.windows(), phase.similarity(), phase.spread());
+}
+
+static void check_reset(void)
+{
+	const LearnPhase::Config config = {2, 10, 1, 2, 5, 90};
+	LearnPhase phase(config);
+	phase.learned();
+	phase.scored(95);
+	phase.learned();
+	phase.scored(95);
+	if (phase.state() != LearnPhase::CONVERGED) {
+		printf("FAIL reset: not converged before the reset\n");
+		errors++;
+	}
+	phase.reset();
+	if ((phase.state() != LearnPhase::LEARNING) || (phase.windows() != 0) || (phase.similarity() != 0)
+	    || (phase.spread() != 0) || (phase.progress() != 0) || phase.scoreNext()) {
+		printf("FAIL reset: state %d, %u windows, similarity %u\n", phase.state(), phase.windows(),
+		       phase.similarity());
+		errors++;
+	}
+}
+
+int main()
+{
+	/* minWindows, maxWindows, checkEvery, stableChecks, tolerance, minSimilarity */
+	const LearnPhase::Config config = {30, 90, 5, 4, 5, 90};
+	/* Scores after 5, 10, ... windows: 60 80 95 95 95 95 from 15, stable from 30,
+	 * the window scored last is learned too */
+	expect("rising", config, rising, LearnPhase::CONVERGED, 31);
+	expect("stable under minSimilarity", config, stable_low, LearnPhase::LIMIT, 90);
+	expect("spread over tolerance", config, noisy, LearnPhase::LIMIT, 90);
+	const LearnPhase::Config wide = {30, 90, 5, 4, 10, 90};
+	expect("spread within tolerance", wide, noisy, LearnPhase::CONVERGED, 31);
+	const LearnPhase::Config early = {0, 90, 1, 2, 0, 90};
+	/* Window 0 is never scored: first scores after 1 and 2 windows */
+	expect("no minWindows", early, perfect, LearnPhase::CONVERGED, 3);
+	const LearnPhase::Config clamped = {0, 50, 0, 0, 0, 90};
+	expect("checkEvery and stableChecks 0", clamped, perfect, LearnPhase::CONVERGED, 2);
+	const LearnPhase::Config many = {0, 90, 5, 200, 5, 90};
+	expect("stableChecks over CHECKS", many, perfect, LearnPhase::CONVERGED, 5 * LearnPhase::CHECKS + 1);
+	const LearnPhase::Config none = {0, 0, 5, 4, 5, 90};
+	expect("maxWindows 0", none, perfect, LearnPhase::LIMIT, 0);
+	check_reset();
+	printf("%s: %u mismatches\n", errors ? "FAIL" : "PASS", errors);
+	return errors;
+}
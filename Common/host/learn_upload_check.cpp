@@ -0,0 +1,251 @@
+/**
+*******************************************************************************
+* @file   learn_upload_check.cpp
+* @brief  Host check of LearnUpload
+*******************************************************************************
+* Builds learning frames with NeaiStream, feeds them to LearnUpload one byte
+* at a time as the RX interrupt does and checks the windows and the ACK/NAK
+* replies: in order upload, end frame, corrupted frame, lost frame, resent
+* frame, more frames than slots and noise between frames. Then times
+* receive() per byte.
+*
+* Usage: learn_upload_check
+* Exits with the number of mismatches.
+*******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "learn_upload.h"
+#include "neai_stream.h"
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+/* Defines -------------------------------------------------------------------*/
+#define SAMPLES 128
+#define AXES 3
+#define FRAMES 6 /* 5 windows and the end frame */
+
+typedef std::vector<uint8_t> Bytes;
+
+/* Objects -------------------------------------------------------------------*/
+class CaptureStream : public RawSerial
+{
+public:
+	Bytes bytes;
+
+protected:
+	virtual int _putc(int c)
+	{
+		bytes.push_back((uint8_t)c);
+		return c;
+	}
+};
+
+/* Variables -----------------------------------------------------------------*/
+static uint32_t errors = 0;
+static Bytes frames[FRAMES];
+
+/* Functions definition ------------------------------------------------------*/
+static int16_t value(uint32_t frame, uint32_t i)
+{
+	return (int16_t)(frame * 1000 + i - 16384);
+}
+
+static void build_frames(void)
+{
+	BMI160::AccConfig config = BMI160::DEFAULT_ACC_CONFIG;
+	config.range = BMI160::SENS_4G;
+	CaptureStream out;
+	NeaiStream stream(out);
+	int16_t window[SAMPLES * AXES];
+	for (uint32_t frame = 0; frame < FRAMES; frame++) {
+		for (uint32_t i = 0; i < SAMPLES * AXES; i++) {
+			window[i] = value(frame, i);
+		}
+		out.bytes.clear();
+		stream.writeWindow(window, (frame < FRAMES - 1) ? SAMPLES : 0, AXES, config);
+		frames[frame] = out.bytes;
+	}
+}
+
+static void feed(LearnUpload &upload, const Bytes &bytes)
+{
+	for (size_t i = 0; i < bytes.size(); i++) {
+		upload.receive(bytes[i]);
+	}
+}
+
+static void expect_replies(CaptureStream &port, const char *step, const Bytes &expected)
+{
+	if (port.bytes != expected) {
+		printf("FAIL %-24s replies", step);
+		for (size_t i = 0; i < port.bytes.size(); i++) {
+			printf(" %02X", port.bytes[i]);
+		}
+		printf(", expected");
+		for (size_t i = 0; i < expected.size(); i++) {
+			printf(" %02X", expected[i]);
+		}
+		printf("\n");
+		errors++;
+	}
+	port.bytes.clear();
+}
+
+static Bytes reply(uint8_t code, uint16_t sequence, const Bytes &before = Bytes())
+{
+	Bytes bytes = before;
+	bytes.push_back(code);
+	bytes.push_back(sequence & 0xFF);
+	bytes.push_back(sequence >> 8);
+	return bytes;
+}
+
+/* Learn the pending windows, checking their content */
+static void learn(LearnUpload &upload, const char *step, uint32_t expectedFrame)
+{
+	uint8_t range = 0;
+	const int16_t *window = upload.window(range);
+	if (!window) {
+		printf("FAIL %-24s no window, expected frame %u\n", step, expectedFrame);
+		errors++;
+		return;
+	}
+	if (range != BMI160::SENS_4G) {
+		printf("FAIL %-24s range 0x%02X\n", step, range);
+		errors++;
+	}
+	for (uint32_t i = 0; i < SAMPLES * AXES; i++) {
+		if (window[i] != value(expectedFrame, i)) {
+			printf("FAIL %-24s value %u is %d, expected frame %u\n", step, i, window[i], expectedFrame);
+			errors++;
+			break;
+		}
+	}
+	upload.release();
+}
+
+static void check_in_order(void)
+{
+	CaptureStream port;
+	static int16_t storage[LearnUpload::SLOTS * SAMPLES * AXES];
+	LearnUpload upload(port, storage, SAMPLES, AXES);
+	/* SLOTS frames in flight, the next one sent on each ACK */
+	feed(upload, frames[0]);
+	feed(upload, frames[1]);
+	for (uint32_t frame = 0; frame < FRAMES - 1; frame++) {
+		learn(upload, "in order", frame);
+		expect_replies(port, "in order", reply(LEARN_UPLOAD_ACK, frame + 1));
+		if (frame + 2 < FRAMES) {
+			feed(upload, frames[frame + 2]);
+		}
+	}
+	uint8_t range;
+	if (upload.window(range) || !upload.finished() || (upload.windows() != FRAMES - 1)) {
+		printf("FAIL in order: finished %d, %u windows\n", upload.finished(), upload.windows());
+		errors++;
+	}
+	expect_replies(port, "end frame", reply(LEARN_UPLOAD_ACK, FRAMES));
+}
+
+static void check_errors(void)
+{
+	CaptureStream port;
+	static int16_t storage[LearnUpload::SLOTS * SAMPLES * AXES];
+	LearnUpload upload(port, storage, SAMPLES, AXES);
+
+	/* Noise and a false sync before the first frame */
+	Bytes noise;
+	noise.push_back(0x00);
+	noise.push_back(NEAI_STREAM_SYNC_0);
+	noise.push_back(NEAI_STREAM_SYNC_0);
+	noise.push_back(NEAI_STREAM_SYNC_1);
+	noise.push_back(0x07);
+	noise.push_back(0x42);
+	feed(upload, noise);
+	feed(upload, frames[0]);
+	learn(upload, "noise", 0);
+	expect_replies(port, "noise", reply(LEARN_UPLOAD_ACK, 1));
+
+	/* Corrupted frame 1, frame 2 already in flight: one NAK */
+	Bytes corrupted = frames[1];
+	corrupted[100] ^= 0x10;
+	feed(upload, corrupted);
+	feed(upload, frames[2]);
+	upload.poll();
+	expect_replies(port, "corrupted", reply(LEARN_UPLOAD_NAK, 1));
+	if (upload.errors() != 1) {
+		printf("FAIL corrupted: %u errors\n", upload.errors());
+		errors++;
+	}
+
+	/* Resent from frame 1 */
+	feed(upload, frames[1]);
+	feed(upload, frames[2]);
+	learn(upload, "resent", 1);
+	learn(upload, "resent", 2);
+	expect_replies(port, "resent", reply(LEARN_UPLOAD_ACK, 3, reply(LEARN_UPLOAD_ACK, 2)));
+
+	/* Frame 2 again after a lost ACK: acknowledged, not learned twice */
+	feed(upload, frames[2]);
+	uint8_t range;
+	if (upload.window(range)) {
+		printf("FAIL duplicate learned\n");
+		errors++;
+	}
+	expect_replies(port, "duplicate", reply(LEARN_UPLOAD_ACK, 3));
+
+	/* Frame 3 lost */
+	feed(upload, frames[4]);
+	upload.poll();
+	expect_replies(port, "lost", reply(LEARN_UPLOAD_NAK, 3));
+
+	/* More frames than slots: the end frame has no room */
+	feed(upload, frames[3]);
+	feed(upload, frames[4]);
+	feed(upload, frames[5]);
+	upload.poll();
+	expect_replies(port, "no room", reply(LEARN_UPLOAD_NAK, 5));
+	learn(upload, "no room", 3);
+	learn(upload, "no room", 4);
+	feed(upload, frames[5]);
+	if (upload.window(range) || !upload.finished() || (upload.windows() != FRAMES - 1)) {
+		printf("FAIL errors: finished %d, %u windows\n", upload.finished(), upload.windows());
+		errors++;
+	}
+	expect_replies(port, "no room",
+		reply(LEARN_UPLOAD_ACK, 6, reply(LEARN_UPLOAD_ACK, 5, reply(LEARN_UPLOAD_ACK, 4))));
+}
+
+static void time_receive(void)
+{
+	CaptureStream port;
+	static int16_t storage[LearnUpload::SLOTS * SAMPLES * AXES];
+	LearnUpload upload(port, storage, SAMPLES, AXES);
+	const uint32_t rounds = 2000;
+	uint8_t range;
+	size_t bytes = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (uint32_t round = 0; round < rounds; round++) {
+		for (uint32_t frame = 0; frame < FRAMES - 1; frame++) {
+			feed(upload, frames[frame]);
+			bytes += frames[frame].size();
+			if (upload.window(range)) {
+				upload.release();
+			}
+		}
+	}
+	double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	printf("%u windows, %.1f ns per received byte\n", upload.windows(), ns / bytes);
+}
+
+int main()
+{
+	build_frames();
+	check_in_order();
+	check_errors();
+	time_receive();
+	printf("%s: %u mismatches\n", errors ? "FAIL" : "PASS", errors);
+	return errors;
+}
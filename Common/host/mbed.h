@@ -0,0 +1,320 @@
+/**
+*******************************************************************************
+* @file   mbed.h
+* @brief  Host stand-in for mbed.h
+*******************************************************************************
+* Just enough to compile the bus independent BMI160 driver (bmi160.cpp), the
+* single producer, single consumer queues, the serial framing, the timing
+* statistics, the acquisition and the WS2812 encoder (Babyfoot/LED) on a PC,
+* e.g. with BMI160_Mock.
+*
+* Interrupts are modelled for the acquisition checks: InterruptIn::inject()
+* drives a pin and runs its handler at once, or when the critical section
+* ends if interrupts are masked, as a pending IRQ would. __WFI() returns at
+* once while an interrupt is pending, otherwise it calls HostIrq::wfi(), the
+* event the check wants to end the sleep with (e.g. the next sample).
+* Only put this directory on the include path of host builds.
+*******************************************************************************
+*/
+
+#ifndef MBED_HOST_H
+#define MBED_HOST_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+#include <functional>
+#include <vector>
+
+typedef int PinName;
+static const PinName NC = -1;
+
+/* Callbacks of member functions, for the interrupt handlers */
+template <typename Signature>
+using Callback = std::function<Signature>;
+
+template <typename T, typename R, typename... Args>
+Callback<R(Args...)> callback(T *obj, R (T::*method)(Args...))
+{
+	return [obj, method](Args... args) { return (obj->*method)(args...); };
+}
+
+/* Interrupt masking and sleep */
+struct HostIrq
+{
+	/* Critical section nesting */
+	static int &masked(void)
+	{
+		static int depth = 0;
+		return depth;
+	}
+
+	/* Handlers raised while masked */
+	static std::vector<Callback<void()> > &pending(void)
+	{
+		static std::vector<Callback<void()> > handlers;
+		return handlers;
+	}
+
+	/* Event ending a __WFI() without pending interrupt, none by default */
+	static Callback<void()> &wfi(void)
+	{
+		static Callback<void()> event;
+		return event;
+	}
+
+	/* Number of __WFI() calls */
+	static uint32_t &sleeps(void)
+	{
+		static uint32_t count = 0;
+		return count;
+	}
+
+	static void raise(const Callback<void()> &handler)
+	{
+		if (!handler) {
+			return;
+		}
+		if (masked() > 0) {
+			pending().push_back(handler);
+		} else {
+			handler();
+		}
+	}
+};
+
+static inline void core_util_critical_section_enter(void) { HostIrq::masked()++; }
+
+static inline void core_util_critical_section_exit(void)
+{
+	if (--HostIrq::masked() > 0) {
+		return;
+	}
+	while (!HostIrq::pending().empty()) {
+		Callback<void()> handler = HostIrq::pending().front();
+		HostIrq::pending().erase(HostIrq::pending().begin());
+		handler();
+	}
+}
+
+static inline void __WFI(void)
+{
+	HostIrq::sleeps()++;
+	if (HostIrq::pending().empty() && HostIrq::wfi()) {
+		HostIrq::wfi()();
+	}
+}
+
+/* Bus class referenced by BMI160_I2C, not usable on a host */
+class I2C;
+
+/* Asynchronous SPI events */
+#define SPI_EVENT_ERROR (1 << 1)
+#define SPI_EVENT_COMPLETE (1 << 2)
+
+/* SPI master, keeps the bytes clocked out so host checks can inspect them.
+ * Bytes read come from miso, then 0xFF. transfer() runs at once and ends
+ * with transferEvent, or does not start when transferStarts is false; the
+ * targets only have it with DEVICE_SPI_ASYNCH. */
+class SPI
+{
+public:
+	SPI(PinName mosi, PinName miso, PinName sclk)
+	: hz(1000000), locks(0), transfers(0), transferStarts(true), transferEvent(SPI_EVENT_COMPLETE), m_fill(0xFF)
+	{
+		(void)mosi;
+		(void)miso;
+		(void)sclk;
+	}
+	void format(int bits, int mode = 0)
+	{
+		(void)bits;
+		(void)mode;
+	}
+	void frequency(int frequency) { hz = frequency; }
+	void set_default_write_value(char data) { m_fill = (uint8_t)data; }
+	int write(int value)
+	{
+		sent.push_back((uint8_t)value);
+		return receive();
+	}
+	int write(const char *tx_buffer, int tx_length, char *rx_buffer, int rx_length)
+	{
+		/* The default write value is clocked out while reading past tx_length */
+		int length = (tx_length > rx_length) ? tx_length : rx_length;
+		for (int i = 0; i < length; i++) {
+			sent.push_back((i < tx_length) ? (uint8_t)tx_buffer[i] : m_fill);
+			uint8_t value = receive();
+			if (rx_buffer && (i < rx_length)) {
+				rx_buffer[i] = (char)value;
+			}
+		}
+		return length;
+	}
+	template <typename Type>
+	int transfer(const Type *tx_buffer, int tx_length, Type *rx_buffer, int rx_length,
+	             const Callback<void(int)> &callback, int event = SPI_EVENT_COMPLETE)
+	{
+		if (!transferStarts) {
+			return -1;
+		}
+		transfers++;
+		write(reinterpret_cast<const char *>(tx_buffer), tx_length, reinterpret_cast<char *>(rx_buffer),
+		      rx_length);
+		if ((transferEvent & event) && callback) {
+			HostIrq::raise([callback, this, event]() { callback(transferEvent & event); });
+		}
+		return 0;
+	}
+	void lock(void) { locks++; }
+	void unlock(void) { locks--; }
+
+	int hz;
+	int locks;        /* lock() calls not unlocked yet */
+	int transfers;    /* transfer() calls started */
+	bool transferStarts;
+	int transferEvent;
+	std::vector<uint8_t> sent;
+	std::vector<uint8_t> miso;
+
+private:
+	uint8_t receive(void)
+	{
+		if (miso.empty()) {
+			return 0xFF;
+		}
+		uint8_t value = miso.front();
+		miso.erase(miso.begin());
+		return value;
+	}
+
+	uint8_t m_fill;
+};
+
+/* GPIO output, keeps the last written level */
+class DigitalOut
+{
+public:
+	DigitalOut(PinName pin) : onWrite(), m_value(0) { (void)pin; }
+	DigitalOut &operator=(int value)
+	{
+		m_value = value;
+		if (onWrite) {
+			onWrite(value);
+		}
+		return *this;
+	}
+
+	/* Host only: called on each write, e.g. to frame the bytes of a chip select */
+	Callback<void(int)> onWrite;
+
+	operator int() { return m_value; }
+
+private:
+	int m_value;
+};
+
+/* GPIO input with edge interrupts, driven by the host checks */
+class InterruptIn
+{
+public:
+	InterruptIn(PinName pin) : afterRead(), m_value(0) { (void)pin; }
+	void rise(Callback<void()> func) { m_rise = func; }
+	void fall(Callback<void()> func) { m_fall = func; }
+	int read(void)
+	{
+		int value = m_value;
+		if (afterRead) {
+			afterRead();
+		}
+		return value;
+	}
+
+	/* Host only: drive the pin, an edge raises its handler */
+	void inject(int value)
+	{
+		int previous = m_value;
+		m_value = value ? 1 : 0;
+		if (!previous && m_value) {
+			HostIrq::raise(m_rise);
+		} else if (previous && !m_value) {
+			HostIrq::raise(m_fall);
+		}
+	}
+
+	/* Host only: called after each read(), e.g. to raise an edge right after a check */
+	Callback<void()> afterRead;
+
+private:
+	Callback<void()> m_rise;
+	Callback<void()> m_fall;
+	int m_value;
+};
+
+/* No timing on a host */
+static inline void wait_us(int us) { (void)us; }
+static inline void wait_ms(int ms) { (void)ms; }
+static inline void __disable_irq(void) {}
+static inline void __enable_irq(void) {}
+static inline void sleep(void) { __WFI(); }
+
+/* Serial port, output only: checks override _putc */
+class RawSerial
+{
+public:
+	virtual ~RawSerial() {}
+	int putc(int c) { return _putc(c); }
+
+protected:
+	virtual int _putc(int c) = 0;
+};
+
+/* Threads do not run on a host: checks call the thread bodies themselves */
+enum osPriority { osPriorityLow, osPriorityBelowNormal, osPriorityNormal, osPriorityHigh };
+#define osWaitForever 0xFFFFFFFFU
+
+class Thread
+{
+public:
+	Thread(osPriority priority = osPriorityNormal) { (void)priority; }
+	int start(Callback<void()> task)
+	{
+		(void)task;
+		return 0;
+	}
+};
+
+/* Event flags, a wait returns at once with the flags set */
+class EventFlags
+{
+public:
+	EventFlags() : m_flags(0) {}
+	uint32_t set(uint32_t flags) { return m_flags |= flags; }
+	uint32_t clear(uint32_t flags = 0x7FFFFFFF)
+	{
+		uint32_t previous = m_flags;
+		m_flags &= ~flags;
+		return previous;
+	}
+	uint32_t wait_any(uint32_t flags, uint32_t millisec = osWaitForever, bool clear = true)
+	{
+		(void)millisec;
+		uint32_t set = m_flags & flags;
+		if (clear) {
+			m_flags &= ~set;
+		}
+		return set;
+	}
+
+private:
+	uint32_t m_flags;
+};
+
+#define MBED_ASSERT(expr) assert(expr)
+
+/* Memory barrier of the lock-free queues */
+#define __DMB() __sync_synchronize()
+
+#endif /* MBED_HOST_H */
@@ -0,0 +1,124 @@
+/**
+*******************************************************************************
+* @file   neai_reference_model.cpp
+* @brief  Host stand-in for the NanoEdge AI library
+*******************************************************************************
+* Implements the NanoEdgeAI.h API on x86 so neai_replay can run without the
+* Cortex-M libneai.a. It is NOT the Studio model: learning records the mean
+* and spread of a few features per axis (mean, standard deviation,
+* peak-to-peak, mean absolute derivative), detection maps the RMS z-score of
+* a window's features to a 0-100 similarity.
+*
+* Good enough to measure the pipeline and compare datasets against each
+* other; link a host build of the real library for model accuracy.
+*******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "NanoEdgeAI.h"
+#include <math.h>
+#include <string.h>
+
+/* Defines -------------------------------------------------------------------*/
+#define FEATURES_PER_AXIS 4
+#define FEATURE_NUMBER (FEATURES_PER_AXIS * AXIS_NUMBER)
+#define MIN_SPREAD 1e-4 /* Floor of a feature standard deviation */
+
+/* Variables -----------------------------------------------------------------*/
+static uint32_t learned = 0;
+static double feature_mean[FEATURE_NUMBER];
+static double feature_m2[FEATURE_NUMBER];
+static float sensitivity = 1.F;
+
+/* Functions definition ------------------------------------------------------*/
+static void compute_features(const float data_input[], double features[])
+{
+	for (uint8_t axis = 0; axis < AXIS_NUMBER; axis++) {
+		double sum = 0., sum2 = 0., diff = 0.;
+		float vmin = data_input[axis], vmax = data_input[axis];
+		for (uint16_t i = 0; i < DATA_INPUT_USER; i++) {
+			float v = data_input[AXIS_NUMBER * i + axis];
+			sum += v;
+			sum2 += (double)v * v;
+			if (v < vmin) {
+				vmin = v;
+			}
+			if (v > vmax) {
+				vmax = v;
+			}
+			if (i > 0) {
+				diff += fabs(v - data_input[AXIS_NUMBER * (i - 1) + axis]);
+			}
+		}
+		double mean = sum / DATA_INPUT_USER;
+		double var = sum2 / DATA_INPUT_USER - mean * mean;
+		features[FEATURES_PER_AXIS * axis] = mean;
+		features[FEATURES_PER_AXIS * axis + 1] = sqrt(var > 0. ? var : 0.);
+		features[FEATURES_PER_AXIS * axis + 2] = vmax - vmin;
+		features[FEATURES_PER_AXIS * axis + 3] = diff / (DATA_INPUT_USER - 1);
+	}
+}
+
+uint8_t NanoEdgeAI_initialize(void)
+{
+	learned = 0;
+	memset(feature_mean, 0, sizeof(feature_mean));
+	memset(feature_m2, 0, sizeof(feature_m2));
+	return 0;
+}
+
+uint8_t NanoEdgeAI_learn(float data_input[])
+{
+	double features[FEATURE_NUMBER];
+	compute_features(data_input, features);
+	learned++;
+	/* Welford running mean and variance */
+	for (uint8_t f = 0; f < FEATURE_NUMBER; f++) {
+		double delta = features[f] - feature_mean[f];
+		feature_mean[f] += delta / learned;
+		feature_m2[f] += delta * (features[f] - feature_mean[f]);
+	}
+	return 0;
+}
+
+uint8_t NanoEdgeAI_detect(float data_input[])
+{
+	if (learned < 2) {
+		return 0;
+	}
+	double features[FEATURE_NUMBER];
+	compute_features(data_input, features);
+	double z2 = 0.;
+	for (uint8_t f = 0; f < FEATURE_NUMBER; f++) {
+		double spread = sqrt(feature_m2[f] / (learned - 1));
+		double spread_min = MIN_SPREAD + 0.01 * fabs(feature_mean[f]);
+		if (spread < spread_min) {
+			spread = spread_min;
+		}
+		double z = (features[f] - feature_mean[f]) / spread;
+		z2 += z * z;
+	}
+	/* RMS z-score 1 gives about 95%, 3 gives about 60% */
+	double d2 = z2 / FEATURE_NUMBER / ((double)sensitivity * sensitivity);
+	return (uint8_t)lround(100. * exp(-d2 / 18.));
+}
+
+void NanoEdgeAI_set_sensitivity(float value)
+{
+	sensitivity = value;
+}
+
+float NanoEdgeAI_get_sensitivity(void)
+{
+	return sensitivity;
+}
+
+uint8_t NanoEdgeAI_get_status(void)
+{
+	return 0;
+}
+
+void NanoEdgeAI_set_license_key(const char *key)
+{
+	(void)key;
+}
@@ -0,0 +1,225 @@
+/**
+*******************************************************************************
+* @file   neai_replay.cpp
+* @brief  Replay recorded datasets through NanoEdge AI learn/detect on a host
+*******************************************************************************
+* Each CSV line is one window of DATA_INPUT_USER * AXIS_NUMBER "%.4f" values,
+* as written by the data logging mode. The window size comes from the
+* application NanoEdgeAI.h given on the include path.
+*
+* Usage:
+*   neai_replay [--learn <csv>] [--learn-count <n>] [--hop <samples>]
+*               [--sensitivity <s>] <csv>...
+*
+* --learn        windows learned before detection (default: first csv)
+* --learn-count  learn only the first n windows of the learn file
+* --hop          stream each file through SlidingWindow, as the firmware
+*                does with -DNEAI_HOP, instead of one detection per line
+* --sensitivity  NanoEdgeAI_set_sensitivity() value
+*
+* Reports learn and detect throughput, per call latency percentiles and the
+* similarity distribution of every file. Built with -DPERF_STATS, also dumps
+* the statistics of the firmware instrumentation (see perf_stats.h).
+*******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "NanoEdgeAI.h"
+#include "sliding_window.h"
+#include "perf_stats.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/* Defines -------------------------------------------------------------------*/
+#define WINDOW_VALUES (DATA_INPUT_USER * AXIS_NUMBER)
+#define SIMILARITY_THRESHOLD 90 /* Threshold used by the applications */
+
+typedef std::chrono::steady_clock Clock;
+typedef std::vector<float> Window;
+
+#ifdef PERF_STATS
+/* Standard output for PerfStats::dump() */
+class StdoutStream : public RawSerial
+{
+protected:
+	virtual int _putc(int c) { return putchar(c); }
+};
+#endif
+
+/* Functions definition ------------------------------------------------------*/
+static bool load_csv(const char *path, std::vector<Window> &windows, uint32_t &skipped)
+{
+	std::ifstream file(path);
+	if (!file) {
+		fprintf(stderr, "%s: cannot open\n", path);
+		return false;
+	}
+	std::string line;
+	skipped = 0;
+	while (std::getline(file, line)) {
+		std::istringstream values(line);
+		Window window;
+		window.reserve(WINDOW_VALUES);
+		float value;
+		while (values >> value) {
+			window.push_back(value);
+		}
+		if (window.empty()) {
+			continue;
+		}
+		if (window.size() != WINDOW_VALUES) {
+			skipped++;
+			continue;
+		}
+		windows.push_back(window);
+	}
+	return true;
+}
+
+static double percentile(std::vector<double> sorted, double p)
+{
+	if (sorted.empty()) {
+		return 0.;
+	}
+	std::sort(sorted.begin(), sorted.end());
+	size_t index = (size_t)(p / 100. * (sorted.size() - 1) + 0.5);
+	return sorted[index];
+}
+
+static void print_latency(const char *name, const std::vector<double> &us, double total_s)
+{
+	printf("  %-6s %6zu calls  %10.1f windows/s  latency us p50 %.1f  p90 %.1f  p99 %.1f  max %.1f\n",
+		name, us.size(), total_s > 0. ? us.size() / total_s : 0.,
+		percentile(us, 50.), percentile(us, 90.), percentile(us, 99.), percentile(us, 100.));
+}
+
+static double timed_detect(float *window, std::vector<double> &latency, std::vector<double> &similarity)
+{
+	Clock::time_point start = Clock::now();
+	uint8_t result;
+	PERF_TIME(PERF_DETECT, result = NanoEdgeAI_detect(window));
+	double us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+	latency.push_back(us);
+	similarity.push_back(result);
+	return us;
+}
+
+static void usage(void)
+{
+	fprintf(stderr, "usage: neai_replay [--learn <csv>] [--learn-count <n>] [--hop <samples>]"
+		" [--sensitivity <s>] <csv>...\n");
+	exit(2);
+}
+
+int main(int argc, char *argv[])
+{
+	const char *learn_path = NULL;
+	uint32_t learn_count = 0;
+	uint32_t hop = 0;
+	std::vector<const char *> paths;
+	float sensitivity = 0.F;
+
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "--learn") && i + 1 < argc) {
+			learn_path = argv[++i];
+		} else if (!strcmp(argv[i], "--learn-count") && i + 1 < argc) {
+			learn_count = strtoul(argv[++i], NULL, 10);
+		} else if (!strcmp(argv[i], "--hop") && i + 1 < argc) {
+			hop = strtoul(argv[++i], NULL, 10);
+		} else if (!strcmp(argv[i], "--sensitivity") && i + 1 < argc) {
+			sensitivity = strtof(argv[++i], NULL);
+		} else if (argv[i][0] == '-') {
+			usage();
+		} else {
+			paths.push_back(argv[i]);
+		}
+	}
+	if (paths.empty() || hop > DATA_INPUT_USER) {
+		usage();
+	}
+	if (learn_path == NULL) {
+		learn_path = paths[0];
+	}
+
+	printf("window: %d samples x %d axes\n", DATA_INPUT_USER, AXIS_NUMBER);
+#ifdef PERF_STATS
+	PerfStats::start();
+#endif
+	NanoEdgeAI_initialize();
+	if (sensitivity > 0.F) {
+		NanoEdgeAI_set_sensitivity(sensitivity);
+	}
+
+	/* Learning */
+	std::vector<Window> windows;
+	uint32_t skipped;
+	if (!load_csv(learn_path, windows, skipped)) {
+		return 1;
+	}
+	if (learn_count > 0 && learn_count < windows.size()) {
+		windows.resize(learn_count);
+	}
+	std::vector<double> latency;
+	Clock::time_point start = Clock::now();
+	for (size_t i = 0; i < windows.size(); i++) {
+		Clock::time_point call = Clock::now();
+		PERF_TIME(PERF_LEARN, NanoEdgeAI_learn(&windows[i][0]));
+		latency.push_back(std::chrono::duration<double, std::micro>(Clock::now() - call).count());
+	}
+	printf("%s (learn, %u lines skipped)\n", learn_path, skipped);
+	print_latency("learn", latency, std::chrono::duration<double>(Clock::now() - start).count());
+
+	/* Detection */
+	std::vector<float> stream(2 * WINDOW_VALUES);
+	for (size_t p = 0; p < paths.size(); p++) {
+		windows.clear();
+		if (!load_csv(paths[p], windows, skipped)) {
+			continue;
+		}
+		std::vector<double> similarity;
+		latency.clear();
+		double total_us = 0.;
+		if (hop == 0) {
+			for (size_t i = 0; i < windows.size(); i++) {
+				total_us += timed_detect(&windows[i][0], latency, similarity);
+			}
+		} else {
+			/* Lines played back to back as one stream */
+			SlidingWindow sliding(&stream[0], DATA_INPUT_USER, AXIS_NUMBER, hop);
+			for (size_t i = 0; i < windows.size(); i++) {
+				const float *data = &windows[i][0];
+				uint16_t left = DATA_INPUT_USER;
+				while (left > 0) {
+					uint16_t chunk = left < hop ? left : hop;
+					bool due;
+					PERF_TIME(PERF_WINDOW, due = sliding.push(data, chunk));
+					if (due) {
+						total_us += timed_detect(sliding.window(), latency, similarity);
+					}
+					data += chunk * AXIS_NUMBER;
+					left -= chunk;
+				}
+			}
+		}
+		size_t above = std::count_if(similarity.begin(), similarity.end(),
+			[](double s) { return s >= SIMILARITY_THRESHOLD; });
+		printf("%s (%zu windows, %u lines skipped)\n", paths[p], windows.size(), skipped);
+		print_latency("detect", latency, total_us / 1e6);
+		printf("  similarity min %.0f  p10 %.0f  p50 %.0f  p90 %.0f  max %.0f  >=%d%%: %zu/%zu\n",
+			percentile(similarity, 0.), percentile(similarity, 10.), percentile(similarity, 50.),
+			percentile(similarity, 90.), percentile(similarity, 100.),
+			SIMILARITY_THRESHOLD, above, similarity.size());
+	}
+#ifdef PERF_STATS
+	StdoutStream out;
+	PerfStats::dump(out);
+#endif
+	return 0;
+}
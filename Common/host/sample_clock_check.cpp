@@ -0,0 +1,203 @@
+/**
+*******************************************************************************
+* @file   sample_clock_check.cpp
+* @brief  Host check of the sensor time stamps of FIFO windows
+*******************************************************************************
+* Simulates a BMI160 sampling at 800Hz on the sensor time grid, its 24 bit
+* counter wrapping during the run, and FIFO overflows losing samples. The FIFO of
+* BMI160_Mock is drained at irregular intervals, leaving frames behind, and
+* each drain is stamped with BMI160::getSensorTimeAndFifoLength as
+* AccAcquisition does. Every sample holds its grid index, so for windows of
+* the latest samples the check knows the true first and last sample times,
+* gaps, effective rate and jitter, and that resampling a ramp onto the grid
+* must give the ramp back exactly.
+*
+* Usage: sample_clock_check
+* Exits with the number of mismatches.
+*******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "bmi160_mock.h"
+#include "sample_clock.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+/* Defines -------------------------------------------------------------------*/
+#define AXIS_NUMBER 3
+#define WINDOW 256
+#define SAMPLES 6000        /* Samples taken by the simulated sensor */
+#define START_TIME 0xFFE000 /* Sensor time of the first sample, wraps soon after */
+#define DRAIN_TICKS 256     /* 10ms between drains on average */
+#define LOSS_DRAINS 23      /* Drains between two FIFO overflows */
+
+/* Variables -----------------------------------------------------------------*/
+static uint32_t errors = 0;
+
+/* Functions definition ------------------------------------------------------*/
+static void check_period(void)
+{
+	const struct {
+		BMI160::AccOutputDataRate odr;
+		BMI160::FifoDownSampling downs;
+		uint32_t ticks;
+	} periods[] = {
+		{BMI160::ACC_ODR_12, BMI160::FIFO_DOWNS_1, 16},
+		{BMI160::ACC_ODR_11, BMI160::FIFO_DOWNS_1, 32},
+		{BMI160::ACC_ODR_11, BMI160::FIFO_DOWNS_8, 256},
+		{BMI160::ACC_ODR_8, BMI160::FIFO_DOWNS_1, 256},
+		{BMI160::ACC_ODR_1, BMI160::FIFO_DOWNS_2, 65536},
+	};
+	for (size_t i = 0; i < sizeof(periods) / sizeof(periods[0]); i++) {
+		uint32_t ticks = BMI160::getFifoFramePeriod(periods[i].odr, periods[i].downs);
+		if (ticks != periods[i].ticks) {
+			printf("FAIL period of odr %d downs %d: %u ticks, expected %u\n", periods[i].odr,
+			       periods[i].downs, ticks, periods[i].ticks);
+			errors++;
+		}
+	}
+}
+
+static void check_window(const SampleClock &clock, const std::vector<uint32_t> &grid,
+                         const std::vector<float> &values, uint32_t period, uint32_t &resampled)
+{
+	WindowTiming timing;
+	if (!clock.window(WINDOW, timing)) {
+		printf("FAIL window at sample %u: no timing\n", (unsigned)grid.size());
+		errors++;
+		return;
+	}
+	size_t start = grid.size() - WINDOW;
+	uint32_t first = grid[start];
+	uint32_t last = grid.back();
+	uint32_t missing = last - first - (WINDOW - 1);
+	uint8_t gaps = 0;
+	double mean = (double)(last - first) * period / (WINDOW - 1);
+	double sum = 0.;
+	for (size_t i = start + 1; i < grid.size(); i++) {
+		double interval = (double)(grid[i] - grid[i - 1]) * period;
+		sum += (interval - mean) * (interval - mean);
+		gaps += (grid[i] - grid[i - 1] > 1) ? 1 : 0;
+	}
+	double jitter = sqrt(sum / (WINDOW - 1)) * 1e6 / BMI160::SENSOR_TIME_HZ;
+	double odr = BMI160::SENSOR_TIME_HZ / mean;
+
+	if ((((timing.first - (START_TIME + first * period)) & 0xFFFFFF) != 0) ||
+	    (((timing.last - (START_TIME + last * period)) & 0xFFFFFF) != 0) ||
+	    (timing.last - timing.first != (last - first) * period)) {
+		printf("FAIL window at sample %u: time %u to %u, expected grid %u to %u\n", (unsigned)grid.size(),
+		       timing.first, timing.last, first, last);
+		errors++;
+	}
+	if ((timing.missing != missing) || (timing.gaps != gaps)) {
+		printf("FAIL window at sample %u: %u missing in %u gaps, expected %u in %u\n", (unsigned)grid.size(),
+		       timing.missing, timing.gaps, missing, gaps);
+		errors++;
+	}
+	if ((fabs(timing.odr - odr) > odr * 1e-4) || (fabs(timing.jitter - jitter) > 0.01 + jitter * 1e-3)) {
+		printf("FAIL window at sample %u: %.3f Hz, jitter %.2f us, expected %.3f Hz, %.2f us\n",
+		       (unsigned)grid.size(), timing.odr, timing.jitter, odr, jitter);
+		errors++;
+	}
+
+	std::vector<acc_sample_t> window(values.begin() + start * AXIS_NUMBER, values.end());
+	bool changed = SampleClock::resample(timing, &window[0], WINDOW, AXIS_NUMBER);
+	if (changed != ((missing > 0) && (gaps <= SAMPLE_CLOCK_GAPS))) {
+		printf("FAIL window at sample %u: resampled %d with %u gaps\n", (unsigned)grid.size(), changed, gaps);
+		errors++;
+		return;
+	}
+	if (!changed) {
+		return;
+	}
+	resampled++;
+	/* The ramp on the grid ending at the last sample */
+	for (uint16_t k = 0; k < WINDOW; k++) {
+		float expected = (float)(last - (WINDOW - 1) + k);
+		if ((window[k * 3] != expected) || (window[k * 3 + 1] != -expected) || (window[k * 3 + 2] != 0.5F * expected)) {
+			printf("FAIL window at sample %u: resampled %u is %.2f, expected %.2f\n", (unsigned)grid.size(), k,
+			       (double)window[k * 3], expected);
+			errors++;
+			return;
+		}
+	}
+}
+
+static void check_stream(void)
+{
+	BMI160_Mock imu;
+	uint32_t period = BMI160::getFifoFramePeriod(BMI160::ACC_ODR_11, BMI160::FIFO_DOWNS_1);
+	SampleClock clock(period);
+	std::vector<uint32_t> grid;  /* Grid index of each sample drained */
+	std::vector<float> values;   /* Their values, the grid index as a ramp */
+	uint32_t next = 0;           /* Next sample the sensor takes */
+	uint32_t drains = 0;
+	uint32_t windows = 0;
+	uint32_t resampled = 0;
+	uint32_t stamps = 0;
+	uint32_t transactions = 0;
+	uint32_t bytes = 0;
+	std::vector<int16_t> frames(3 * (BMI160::FIFO_SIZE / BMI160::FIFO_ACC_FRAME_SIZE));
+	srand(22);
+
+	for (uint32_t now = START_TIME; next < SAMPLES; now += DRAIN_TICKS / 2 + rand() % DRAIN_TICKS) {
+		/*
+		 * Samples taken since the last drain. Now and then the FIFO overflows,
+		 * losing its oldest frames: the first ones of this batch, when the
+		 * previous drain left none behind.
+		 */
+		drains++;
+		uint32_t lose = ((imu.fifoBytes() == 0) && (drains % LOSS_DRAINS == 0)) ? 1 + drains % 40 : 0;
+		for (; START_TIME + next * period <= now; next++) {
+			if ((lose > 0) && (START_TIME + (next + 1) * period <= now)) {
+				lose--;
+			} else {
+				imu.pushFifoFrame(next, -(int16_t)next, 0);
+			}
+		}
+		/* Read part of the FIFO only, sometimes */
+		uint16_t maxFrames = (rand() % 4 == 0) ? rand() % 8 : frames.size() / 3;
+		uint16_t numFrames = 0;
+		imu.getFifoAccXYZ(&frames[0], maxFrames, numFrames);
+		if (numFrames == 0) {
+			continue;
+		}
+		BMI160::SensorTime time;
+		uint16_t length = 0;
+		imu.setSensorTime(now & 0xFFFFFF);
+		imu.resetCounters();
+		imu.getSensorTimeAndFifoLength(time, length);
+		stamps++;
+		transactions += imu.transactions();
+		bytes += imu.busBytes();
+		clock.addFrames(numFrames, time.raw, length / BMI160::FIFO_ACC_FRAME_SIZE);
+
+		for (uint16_t i = 0; i < numFrames; i++) {
+			uint32_t index = (uint16_t)frames[3 * i];
+			grid.push_back(index);
+			values.push_back((float)index);
+			values.push_back(-(float)index);
+			values.push_back(0.5F * index);
+		}
+		if (grid.size() >= WINDOW) {
+			check_window(clock, grid, values, period, resampled);
+			windows++;
+		}
+	}
+	if (clock.samples() != grid.size()) {
+		printf("FAIL %u samples stamped, %u drained\n", clock.samples(), (unsigned)grid.size());
+		errors++;
+	}
+	printf("%u windows checked, %u resampled, stamp %.1f transactions %.1f bytes per drain\n", windows,
+	       resampled, (double)transactions / stamps, (double)bytes / stamps);
+}
+
+int main()
+{
+	check_period();
+	check_stream();
+	printf("%s: %u mismatches\n", errors ? "FAIL" : "PASS", errors);
+	return errors;
+}
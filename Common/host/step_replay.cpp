@@ -0,0 +1,144 @@
+/**
+*******************************************************************************
+* @file   step_replay.cpp
+* @brief  Replay recorded datasets through StepDetector on a host
+*******************************************************************************
+* Each CSV line is a run of x y z "%.4f" samples in g, as written by the data
+* logging mode (Podometre logs at 100Hz).
+*
+* Usage:
+*   step_replay [--rate <hz>] [--decimation <n>] [--min-interval <n>]
+*               [--min-range <g>] [--hysteresis <f>] [--stream] <csv>...
+*
+* --rate         input sample rate, for steps/min (default 100)
+* --decimation   StepDetector::Config, see step_detector.h
+* --min-interval
+* --min-range
+* --hysteresis
+* --stream       play the lines back to back instead of resetting the
+*                detector on every line
+*
+* Reports the steps counted per line and per file, the cadence and the
+* detector cost per input sample.
+*******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "step_detector.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+typedef std::vector<float> Run;
+
+/* Functions definition ------------------------------------------------------*/
+static bool load_csv(const char *path, std::vector<Run> &runs, uint32_t &skipped)
+{
+	std::ifstream file(path);
+	if (!file) {
+		fprintf(stderr, "%s: cannot open\n", path);
+		return false;
+	}
+	std::string line;
+	skipped = 0;
+	while (std::getline(file, line)) {
+		std::istringstream values(line);
+		Run run;
+		float value;
+		while (values >> value) {
+			run.push_back(value);
+		}
+		if (run.empty()) {
+			continue;
+		}
+		if (run.size() % 3 != 0) {
+			skipped++;
+			continue;
+		}
+		runs.push_back(run);
+	}
+	return true;
+}
+
+static void usage(void)
+{
+	fprintf(stderr, "usage: step_replay [--rate <hz>] [--decimation <n>] [--min-interval <n>]"
+		" [--min-range <g>] [--hysteresis <f>] [--stream] <csv>...\n");
+	exit(2);
+}
+
+int main(int argc, char *argv[])
+{
+	StepDetector::Config config = StepDetector::DEFAULT_CONFIG;
+	float rate = 100.F;
+	bool stream = false;
+	std::vector<const char *> paths;
+
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "--rate") && i + 1 < argc) {
+			rate = strtof(argv[++i], NULL);
+		} else if (!strcmp(argv[i], "--decimation") && i + 1 < argc) {
+			config.decimation = strtoul(argv[++i], NULL, 10);
+		} else if (!strcmp(argv[i], "--min-interval") && i + 1 < argc) {
+			config.minInterval = strtoul(argv[++i], NULL, 10);
+		} else if (!strcmp(argv[i], "--min-range") && i + 1 < argc) {
+			config.minRange = strtof(argv[++i], NULL);
+		} else if (!strcmp(argv[i], "--hysteresis") && i + 1 < argc) {
+			config.hysteresis = strtof(argv[++i], NULL);
+		} else if (!strcmp(argv[i], "--stream")) {
+			stream = true;
+		} else if (argv[i][0] == '-') {
+			usage();
+		} else {
+			paths.push_back(argv[i]);
+		}
+	}
+	if (paths.empty() || rate <= 0.F) {
+		usage();
+	}
+
+	printf("detector: decimation %u  window %u  min interval %u  min range %.3fg  hysteresis %.2f\n",
+		config.decimation, StepDetector::WINDOW, config.minInterval, config.minRange, config.hysteresis);
+	StepDetector detector(config);
+	for (size_t p = 0; p < paths.size(); p++) {
+		std::vector<Run> runs;
+		uint32_t skipped;
+		if (!load_csv(paths[p], runs, skipped)) {
+			continue;
+		}
+		detector.reset();
+		uint64_t samples = 0;
+		uint32_t steps = 0;
+		double total_ns = 0.;
+		printf("%s (%zu lines, %u lines skipped)\n", paths[p], runs.size(), skipped);
+		for (size_t i = 0; i < runs.size(); i++) {
+			if (!stream) {
+				detector.reset();
+			}
+			const float *data = &runs[i][0];
+			uint32_t count = runs[i].size() / 3;
+			uint32_t line_steps = 0;
+			Clock::time_point start = Clock::now();
+			for (uint32_t s = 0; s < count; s++, data += 3) {
+				if (detector.addSample(data[0], data[1], data[2])) {
+					line_steps++;
+				}
+			}
+			total_ns += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+			samples += count;
+			steps += line_steps;
+			printf("  line %3zu  %5u samples  %3u steps\n", i + 1, count, line_steps);
+		}
+		double seconds = samples / rate;
+		printf("  total    %5llu samples  %3u steps  %.1f steps/min  %.1f ns/sample\n",
+			(unsigned long long)samples, steps, seconds > 0. ? steps * 60. / seconds : 0.,
+			samples > 0 ? total_ns / samples : 0.);
+	}
+	return 0;
+}
@@ -0,0 +1,128 @@
+/**
+*******************************************************************************
+* @file   window_check.cpp
+* @brief  Host check of the Window kernels
+*******************************************************************************
+* Checks Window::copy and Window::toG against plain loops for the window
+* sizes of the applications, a size with a partial block and both sample
+* types, then times them against BMI160::scaleRaw and memcpy.
+*
+* Usage: window_check [iterations]
+* Exits with the number of mismatches.
+*******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "window.h"
+#include "bmi160.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+/* Defines -------------------------------------------------------------------*/
+/* As in a generated NanoEdgeAI.h */
+#define DATA_INPUT_USER 256
+#define AXIS_NUMBER 3
+
+typedef std::chrono::steady_clock Clock;
+
+typedef Window<256, 3> AccWindow;
+NEAI_WINDOW_CHECK(AccWindow);
+static_assert(Window<512, 6>::VALUES == 3072, "6-axis window size");
+static_assert(sizeof(Window<128, 3, int16_t>) == 128 * 3 * sizeof(int16_t), "window storage");
+
+/* Variables -----------------------------------------------------------------*/
+static uint32_t errors = 0;
+
+/* Functions definition ------------------------------------------------------*/
+template <typename WindowT>
+static void check(const char *name)
+{
+	typedef typename WindowT::Sample Sample;
+	const float scale = BMI160::getAccScale(BMI160::SENS_4G);
+	std::vector<Sample> src(WindowT::VALUES + 1);
+	std::vector<Sample> dst(WindowT::VALUES + 1, (Sample)0);
+	std::vector<float> g(WindowT::VALUES + 1, -1.F);
+	for (uint32_t i = 0; i < src.size(); i++) {
+		src[i] = (Sample)((int32_t)(i * 7919 % 65536) - 32768);
+	}
+	/* The extra value past the window must be left alone */
+	WindowT::copy(&dst[0], &src[0]);
+	WindowT::toG(&g[0], &src[0], scale);
+	uint32_t mismatches = 0;
+	for (uint32_t i = 0; i < WindowT::VALUES; i++) {
+		if ((dst[i] != src[i]) || (g[i] != acc_sample_to_g(src[i], scale))) {
+			mismatches++;
+		}
+	}
+	if ((dst[WindowT::VALUES] != 0) || (g[WindowT::VALUES] != -1.F)) {
+		mismatches++;
+	}
+	WindowT window;
+	window.values[0] = 1;
+	if ((window.sample(1) != &window.values[WindowT::AXES]) || (*window.sample(0) != 1)) {
+		mismatches++;
+	}
+	if (mismatches > 0) {
+		printf("FAIL %s: %u mismatches\n", name, mismatches);
+		errors += mismatches;
+	}
+}
+
+static void bench(uint32_t iterations)
+{
+	typedef Window<256, 3, int16_t> RawWindow;
+	const float scale = BMI160::getAccScale(BMI160::SENS_2G);
+	RawWindow raw;
+	RawWindow copy;
+	Window<256, 3, float> g;
+	for (uint32_t i = 0; i < RawWindow::VALUES; i++) {
+		raw.values[i] = (int16_t)(i * 37);
+	}
+	double seconds[4] = {0., 0., 0., 0.};
+	float checksum = 0.F;
+	for (uint32_t it = 0; it < iterations; it++) {
+		raw.values[it % RawWindow::VALUES]++;
+		Clock::time_point start = Clock::now();
+		RawWindow::toG(g.values, raw.values, scale);
+		Clock::time_point next = Clock::now();
+		seconds[0] += std::chrono::duration<double>(next - start).count();
+		checksum += g.values[it % RawWindow::VALUES];
+		start = Clock::now();
+		BMI160::scaleRaw(raw.values, g.values, RawWindow::VALUES, scale);
+		next = Clock::now();
+		seconds[1] += std::chrono::duration<double>(next - start).count();
+		checksum += g.values[it % RawWindow::VALUES];
+		start = Clock::now();
+		RawWindow::copy(copy.values, raw.values);
+		next = Clock::now();
+		seconds[2] += std::chrono::duration<double>(next - start).count();
+		checksum += copy.values[it % RawWindow::VALUES];
+		start = Clock::now();
+		memcpy(copy.values, raw.values, sizeof(copy.values));
+		next = Clock::now();
+		seconds[3] += std::chrono::duration<double>(next - start).count();
+		checksum += copy.values[it % RawWindow::VALUES];
+	}
+	double values = (double)iterations * RawWindow::VALUES;
+	printf("toG %.2f ns/value, scaleRaw %.2f, copy %.2f, memcpy %.2f (checksum %.0f)\n",
+	       seconds[0] * 1e9 / values, seconds[1] * 1e9 / values, seconds[2] * 1e9 / values,
+	       seconds[3] * 1e9 / values, (double)checksum);
+}
+
+int main(int argc, char *argv[])
+{
+	uint32_t iterations = (argc > 1) ? atoi(argv[1]) : 20000;
+	check<Window<128, 3, float> >("Babyfoot 128x3 float");
+	check<Window<256, 3, float> >("Podometre 256x3 float");
+	check<Window<256, 3, int16_t> >("Podometre 256x3 int16");
+	check<Window<512, 3, int16_t> >("Ventilateur 512x3 int16");
+	check<Window<512, 6, float> >("Ventilateur 512x6 float");
+	check<Window<100, 3, int16_t> >("100x3 int16, partial block");
+	check<Window<5, 1, float> >("5x1 float, single partial block");
+	bench(iterations);
+	printf("%s: %u mismatches\n", errors ? "FAIL" : "PASS", errors);
+	return errors;
+}
@@ -0,0 +1,373 @@
+/**
+*******************************************************************************
+* @file   window_ring_replay.cpp
+* @brief  Host replay of a recording through WindowRing and AccCapture
+*******************************************************************************
+* Replays the samples of the recordings at the sensor rate, one FIFO
+* watermark at a time, into a WindowRing:
+* - written by a producer with the drop policy of AccCapture
+* - written by AccCapture::drain() from BMI160_Mock, with window timings
+* and a consumer that takes a fixed number of sample periods per window.
+* Each window must hold consecutive samples of the recording, the ones a
+* model of the ring expects, and overruns() and droppedSamples() must match
+* the model: zero when the consumer keeps up, even after a stall that ends
+* just as the ring fills, the lost watermarks when it falls behind.
+*
+* Usage: window_ring_replay [--repeat n] [--samples n] [--watermark n] <csv>...
+* Each line holds x y z values in g; the recordings are chained and replayed
+* n times (default 16). The watermark, in samples, must fit the 1024 byte
+* FIFO. Exits with the number of mismatches.
+*******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "acc_capture.h"
+#include "bmi160_mock.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/* Defines -------------------------------------------------------------------*/
+#define AXES 3
+#define PERIOD 16 /* Sensor time ticks per sample at 1600 Hz */
+
+/* Types ---------------------------------------------------------------------*/
+/**
+ * @brief  What the ring should hold and count, from the FIFO and ring sizes only
+ */
+struct RingModel
+{
+	RingModel(uint8_t slots, uint16_t samples)
+	: slots(slots), samples(samples), full(0), fill(0), dropping(false), overruns(0), dropped(0)
+	{
+	}
+
+	/* A drain of the FIFO samples [first, last) */
+	void drain(uint32_t first, uint32_t last)
+	{
+		if (full < slots) {
+			dropping = false;
+		}
+		while ((first < last) && (full < slots)) {
+			written.push_back(first++);
+			if (++fill == samples) {
+				fill = 0;
+				full++;
+			}
+		}
+		if (first < last) {
+			dropped += last - first;
+			overruns += dropping ? 0 : 1;
+			dropping = true;
+		}
+	}
+
+	uint8_t slots;
+	uint16_t samples;
+	uint8_t full;
+	uint16_t fill;
+	bool dropping;
+	uint32_t overruns;
+	uint32_t dropped;
+	std::vector<uint32_t> written; /* Recording sample of each value written, in order */
+};
+
+/**
+ * @brief  Consumer of a replay
+ */
+struct Consumer
+{
+	uint32_t first; /* Sample periods taken by the first window */
+	uint32_t lag;   /* Sample periods taken by the next ones */
+	bool drops;     /* Samples are expected to be dropped */
+	uint32_t windows; /* Windows expected at least */
+};
+
+/**
+ * @brief  Outcome of one replay
+ */
+struct Result
+{
+	uint32_t windows;
+	uint32_t mismatches;
+};
+
+/* Variables -----------------------------------------------------------------*/
+static std::vector<float> recording; /* AXES values per sample, in g */
+static uint16_t window_samples = 512;
+static uint16_t watermark = 64;
+static uint32_t errors = 0;
+
+/* Functions definition ------------------------------------------------------*/
+static bool load_csv(const char *path)
+{
+	std::ifstream file(path);
+	if (!file) {
+		fprintf(stderr, "%s: cannot open\n", path);
+		return false;
+	}
+	std::string line;
+	while (std::getline(file, line)) {
+		std::istringstream values(line);
+		float value;
+		size_t start = recording.size();
+		while (values >> value) {
+			recording.push_back(value);
+		}
+		/* Incomplete sample at the end of a line */
+		recording.resize(recording.size() - (recording.size() - start) % AXES);
+	}
+	return true;
+}
+
+static int16_t raw_counts(float g, float scale)
+{
+	long raw = lrintf(g / scale);
+	return (raw > INT16_MAX) ? INT16_MAX : ((raw < INT16_MIN) ? INT16_MIN : raw);
+}
+
+static bool same(acc_sample_t value, acc_sample_t expected)
+{
+	return fabsf((float)value - (float)expected) <= 1e-6f * (1.0f + fabsf((float)expected));
+}
+
+/**
+ * @brief  Check a window against the samples the model wrote
+ *
+ * @param  window: window read from the ring
+ * @param  model: ring model
+ * @param  index: window number
+ * @param  expected: expected value of each recording value
+ * @retval Mismatches
+ */
+static uint32_t check_window(const acc_sample_t *window, const RingModel &model, uint32_t index,
+                             const std::vector<acc_sample_t> &expected)
+{
+	uint32_t mismatches = 0;
+	uint32_t first = model.written[index * model.samples];
+	for (uint16_t s = 0; s < model.samples; s++) {
+		uint32_t sample = model.written[index * model.samples + s];
+		/* A window never spans a drop */
+		if (sample != first + s) {
+			mismatches++;
+		}
+		for (uint8_t a = 0; a < AXES; a++) {
+			if (!same(window[s * AXES + a], expected[sample * AXES + a])) {
+				mismatches++;
+			}
+		}
+	}
+	return mismatches;
+}
+
+static uint32_t check_counters(const char *what, const WindowRing &ring, const RingModel &model, bool drops)
+{
+	uint32_t mismatches = 0;
+	if ((ring.overruns() != model.overruns) || (ring.droppedSamples() != model.dropped)) {
+		printf("FAIL %s: %u overruns, %u dropped, expected %u and %u\n", what, ring.overruns(),
+		       ring.droppedSamples(), model.overruns, model.dropped);
+		mismatches++;
+	}
+	if (drops != (model.dropped > 0)) {
+		printf("FAIL %s: %u samples dropped\n", what, model.dropped);
+		mismatches++;
+	}
+	return mismatches;
+}
+
+/**
+ * @brief  Replay into a ring written with the AccCapture drop policy
+ *
+ * @param  slots: ring slots
+ * @param  consumer: time the consumer takes per window
+ * @retval Windows read and mismatches
+ */
+static Result replay_ring(uint8_t slots, const Consumer &consumer)
+{
+	const uint32_t total = recording.size() / AXES;
+	std::vector<acc_sample_t> storage(slots * window_samples * AXES);
+	std::vector<acc_sample_t> expected(recording.size());
+	for (size_t i = 0; i < recording.size(); i++) {
+#ifdef WINDOW_INT16
+		expected[i] = raw_counts(recording[i], BMI160::getAccScale(BMI160::SENS_2G));
+#else
+		expected[i] = recording[i];
+#endif
+	}
+	WindowRing ring(&storage[0], slots, window_samples, AXES);
+	RingModel model(slots, window_samples);
+	Result result = {0, 0};
+	uint32_t fifo = 0; /* Oldest sample not drained */
+	uint32_t busy = 0; /* Consumer busy up to this sample */
+	for (uint32_t t = 1; t <= total; t++) {
+		if ((t % watermark) == 0) {
+			model.drain(fifo, t);
+			uint16_t room;
+			uint16_t frames;
+			do {
+				acc_sample_t *buffer = ring.writeBuffer(room);
+				if (buffer == NULL) {
+					ring.dropSamples(t - fifo);
+					fifo = t;
+					break;
+				}
+				frames = ((t - fifo) < room) ? (t - fifo) : room;
+				memcpy(buffer, &expected[fifo * AXES], frames * AXES * sizeof(acc_sample_t));
+				fifo += frames;
+				ring.commitSamples(frames);
+			} while (frames == room);
+		}
+		const acc_sample_t *window;
+		if ((t >= busy) && ((window = ring.readBuffer()) != NULL)) {
+			result.mismatches += check_window(window, model, result.windows++, expected);
+			ring.release();
+			model.full--;
+			busy = t + ((result.windows == 1) ? consumer.first : consumer.lag);
+		}
+	}
+	char what[64];
+	snprintf(what, sizeof(what), "WindowRing %u slots, %u periods per window", slots, consumer.first);
+	result.mismatches += check_counters(what, ring, model, consumer.drops);
+	printf("%-52s %4u windows, %2u overruns, %6u samples dropped\n", what, result.windows, ring.overruns(),
+	       ring.droppedSamples());
+	return result;
+}
+
+/**
+ * @brief  Replay through the BMI160 FIFO and AccCapture::drain()
+ *
+ * @param  slots: ring slots
+ * @param  consumer: time the consumer takes per window
+ * @retval Windows read and mismatches
+ */
+static Result replay_capture(uint8_t slots, const Consumer &consumer)
+{
+	const uint32_t total = recording.size() / AXES;
+	const float scale = BMI160::getAccScale(BMI160::SENS_2G);
+	std::vector<acc_sample_t> storage(slots * window_samples * AXES);
+	std::vector<int16_t> raw(recording.size());
+	std::vector<acc_sample_t> expected(recording.size());
+	for (size_t i = 0; i < recording.size(); i++) {
+		raw[i] = raw_counts(recording[i], scale);
+#ifdef WINDOW_INT16
+		expected[i] = raw[i];
+#else
+		expected[i] = raw[i] * scale;
+#endif
+	}
+	BMI160_Mock imu;
+	InterruptIn irq(0);
+	WindowRing ring(&storage[0], slots, window_samples, AXES);
+	AccCapture capture(imu, irq, ring);
+	SampleClock clock(PERIOD);
+	capture.setClock(&clock);
+	capture.start(BMI160::SENS_2G, BMI160::INT1);
+	RingModel model(slots, window_samples);
+	Result result = {0, 0};
+	uint32_t fifo = 0;
+	uint32_t busy = 0;
+	for (uint32_t t = 1; t <= total; t++) {
+		/* Sample t - 1 is sampled at t periods */
+		imu.pushFifoFrame(raw[(t - 1) * AXES], raw[(t - 1) * AXES + 1], raw[(t - 1) * AXES + 2]);
+		imu.setSensorTime(t * PERIOD);
+		if ((t % watermark) == 0) {
+			model.drain(fifo, t);
+			fifo = t;
+			capture.drain();
+			if (imu.fifoBytes() != 0) {
+				result.mismatches++;
+			}
+		}
+		if ((t >= busy) && (ring.windows() > result.windows)) {
+			const acc_sample_t *window = capture.waitWindow();
+			WindowTiming timing;
+			uint32_t first = model.written[result.windows * window_samples];
+			if (!capture.windowTiming(timing) || (timing.first != (first + 1) * PERIOD) || (timing.missing != 0)) {
+				result.mismatches++;
+			}
+			result.mismatches += check_window(window, model, result.windows++, expected);
+			capture.releaseWindow();
+			model.full--;
+			busy = t + ((result.windows == 1) ? consumer.first : consumer.lag);
+		}
+	}
+	char what[64];
+	snprintf(what, sizeof(what), "AccCapture %u slots, %u periods per window", slots, consumer.first);
+	result.mismatches += check_counters(what, ring, model, consumer.drops);
+	printf("%-52s %4u windows, %2u overruns, %6u samples dropped\n", what, result.windows, ring.overruns(),
+	       ring.droppedSamples());
+	return result;
+}
+
+static void expect(Result result, const Consumer &consumer)
+{
+	if (result.mismatches > 0) {
+		printf("FAIL %u mismatches\n", result.mismatches);
+		errors += result.mismatches;
+	}
+	if (result.windows < consumer.windows) {
+		printf("FAIL %u windows read, expected at least %u\n", result.windows, consumer.windows);
+		errors++;
+	}
+}
+
+int main(int argc, char **argv)
+{
+	uint32_t repeat = 16;
+	std::vector<const char *> paths;
+	for (int i = 1; i < argc; i++) {
+		if ((strcmp(argv[i], "--repeat") == 0) && (i + 1 < argc)) {
+			repeat = strtoul(argv[++i], NULL, 0);
+		} else if ((strcmp(argv[i], "--samples") == 0) && (i + 1 < argc)) {
+			window_samples = strtoul(argv[++i], NULL, 0);
+		} else if ((strcmp(argv[i], "--watermark") == 0) && (i + 1 < argc)) {
+			watermark = strtoul(argv[++i], NULL, 0);
+		} else {
+			paths.push_back(argv[i]);
+		}
+	}
+	if (paths.empty() || (window_samples == 0) || (watermark == 0) || (repeat == 0)
+	    || (watermark * BMI160::FIFO_ACC_FRAME_SIZE > BMI160::FIFO_SIZE)) {
+		fprintf(stderr, "Usage: %s [--repeat n] [--samples n] [--watermark n] <csv>...\n", argv[0]);
+		return 1;
+	}
+	for (size_t p = 0; p < paths.size(); p++) {
+		if (!load_csv(paths[p])) {
+			return 1;
+		}
+	}
+	const size_t values = recording.size();
+	for (uint32_t r = 1; r < repeat; r++) {
+		recording.insert(recording.end(), recording.begin(), recording.begin() + values);
+	}
+	const uint32_t total = recording.size() / AXES;
+	printf("%u samples, %u per window, watermark %u\n", total, window_samples, watermark);
+	if (total < 4u * window_samples) {
+		fprintf(stderr, "Recording shorter than 4 windows, raise --repeat\n");
+		return 1;
+	}
+	/* A consumer that keeps up reads every window but the one still filling */
+	const uint32_t all = total / window_samples - 1;
+	for (uint8_t slots = 2; slots <= CAPTURE_TIMING_SLOTS; slots += 2) {
+		const uint32_t half = window_samples / 2;
+		const uint32_t stall = (uint32_t)window_samples * slots;
+		const uint32_t behind = (uint32_t)window_samples * (slots + 1);
+		const Consumer consumers[] = {
+			{half, half, false, all},
+			/* Frees the first slot as the last one fills, then catches up */
+			{stall, half, false, all},
+			{behind, behind, true, total / behind},
+		};
+		for (size_t c = 0; c < sizeof(consumers) / sizeof(consumers[0]); c++) {
+			expect(replay_ring(slots, consumers[c]), consumers[c]);
+			expect(replay_capture(slots, consumers[c]), consumers[c]);
+		}
+	}
+	printf("%s: %u mismatches\n", errors ? "FAIL" : "PASS", errors);
+	return errors;
+}
@@ -0,0 +1,308 @@
+/**
+*******************************************************************************
+* @file   acc_acquisition.h
+* @brief  Accelerometer acquisition shared by the applications
+*******************************************************************************
+* Wraps one BMI160 and the MCU pin wired to its interrupt output:
+* - single samples, sleeping on the data ready interrupt (shock triggers)
+* - whole windows drained from the FIFO (learning, detection, logging)
+* - windows from two sensors over the same time span (Babyfoot goals)
+* - windows around a shock, with the samples before it (see trigger_window.h)
+* - sleep until the sensor's any-motion or high-g engine reports a shock
+* - sensor time stamps of the FIFO windows, with a SampleClock attached
+* - accelerometer and gyroscope in the same samples, after enableGyro()
+*
+* The sensor must have been configured (BMI160::setSensorConfig and
+* BMI160::setFifoConfig) before calling start().
+*******************************************************************************
+*/
+
+#ifndef ACC_ACQUISITION_H
+#define ACC_ACQUISITION_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "mbed.h"
+#include "bmi160.h"
+#include "sliding_window.h"
+#include "trigger_window.h"
+#include "sample_clock.h"
+#include "perf_stats.h"
+
+/**
+ * @brief  Sample and window acquisition from one BMI160
+ */
+class AccAcquisition
+{
+public:
+	///Delay between two FIFO drains while a window is being filled
+	static const uint32_t FIFO_POLL_MS = 10;
+
+	/**
+	 * @brief  Create an acquisition, nothing is routed before start()
+	 *
+	 * @param  imu: configured sensor
+	 * @param  irq: MCU pin wired to the sensor interrupt pin
+	 */
+	AccAcquisition(BMI160 &imu, InterruptIn &irq);
+
+	/**
+	 * @brief  Route the data ready interrupt to irq
+	 *
+	 * @param  range: accelerometer range used to scale the samples
+	 * @param  pin: sensor interrupt pin wired to irq
+	 * @retval 0 on success, non 0 on failure
+	 */
+	int32_t start(BMI160::AccRange range, BMI160::InterruptPin pin);
+
+	/**
+	 * @brief  Route the any-motion and high-g interrupts to irq, not data ready
+	 * No bus traffic while nothing moves: the MCU can sleep until a shock,
+	 * and the FIFO keeps the samples before it for a trigger window.
+	 *
+	 * @param  range: accelerometer range used to scale the samples
+	 * @param  pin: sensor interrupt pin wired to irq
+	 * @param  anyMotion: any-motion engine configuration
+	 * @param  highG: high-g engine configuration
+	 * @retval 0 on success, non 0 on failure
+	 */
+	int32_t startMotion(BMI160::AccRange range, BMI160::InterruptPin pin,
+	                    const BMI160::AnyMotionConfig &anyMotion, const BMI160::HighGConfig &highG);
+
+	/**
+	 * @brief  A motion interrupt was raised since the last clearMotion()
+	 */
+	bool motion(void) const { return m_motion; }
+
+	/**
+	 * @brief  Forget the motion interrupts raised so far
+	 *
+	 * @retval None
+	 */
+	void clearMotion(void) { m_motion = false; }
+
+	/**
+	 * @brief  Read the gyroscope along with the accelerometer, call before start()
+	 * Samples get 6 values, [ax, ay, az, gx, gy, gz], from one bus transfer:
+	 * one burst per single sample, 12 byte frames from a FIFO configured with
+	 * gyroEnable. Windows must have been created with axes().
+	 *
+	 * @param  range: gyroscope range used to scale the samples
+	 * @retval None
+	 */
+	void enableGyro(BMI160::GyroRange range)
+	{
+		m_gyroRange = range;
+		m_axes = 6;
+	}
+
+	/**
+	 * @brief  Values per sample: 3, or 6 after enableGyro()
+	 */
+	uint8_t axes(void) const { return m_axes; }
+
+	/**
+	 * @brief  Stamp the samples drained from the FIFO from now on
+	 * Costs one more bus transfer of 12 bytes per drain.
+	 *
+	 * @param  clock: clock of the FIFO frame period, NULL to stop stamping
+	 * @retval None
+	 */
+	void setClock(SampleClock *clock) { m_clock = clock; }
+
+	/**
+	 * @brief  Timing of the window made of the latest samples drained
+	 *
+	 * @param  samples: samples in the window
+	 * @param  timing: holds the timing
+	 * @retval true if the timing is known, false without a clock
+	 */
+	bool windowTiming(uint16_t samples, WindowTiming &timing) const;
+
+	/**
+	 * @brief  Drop the samples in the FIFO, and the stamps of the clock
+	 *
+	 * @retval 0 on success, non 0 on failure
+	 */
+	int32_t flushFifo(void);
+
+	/**
+	 * @brief  Sleep until the next sample is ready, then read it
+	 *
+	 * @param  data: holds the sample on success
+	 * @retval 0 on success, non 0 on failure
+	 */
+	int32_t readSample(BMI160::SensorData &data);
+
+	/**
+	 * @brief  Sleep until the next sample is ready, then read both sensors
+	 * Accelerometer, gyroscope and sensor time come from a single burst.
+	 *
+	 * @param  acc: holds the accelerometer sample on success
+	 * @param  gyro: holds the gyroscope sample on success, range of enableGyro()
+	 * @param  time: holds the sensor time of the sample on success
+	 * @retval 0 on success, non 0 on failure
+	 */
+	int32_t readSample(BMI160::SensorData &acc, BMI160::SensorData &gyro, BMI160::SensorTime &time);
+
+	/**
+	 * @brief  Drop older samples and fill a whole window from the FIFO
+	 *
+	 * @param  buffer: samples * axes() values, [x0, y0, z0, x1, ...]
+	 * @param  samples: samples per window
+	 * @retval 0 on success, non 0 on failure
+	 */
+	int32_t fillWindow(float *buffer, uint16_t samples);
+
+	/**
+	 * @brief  Feed FIFO samples to a sliding window until its next window
+	 * Samples kept in the FIFO since the previous call are used first, so
+	 * consecutive windows have no gap.
+	 *
+	 * @param  window: sliding window to feed
+	 * @retval 0 on success, non 0 on failure
+	 */
+	int32_t slideWindow(SlidingWindow &window);
+
+	/**
+	 * @brief  Start a pre-trigger capture: drop older samples, forget the event
+	 *
+	 * @param  ring: trigger window to fill
+	 * @retval 0 on success, non 0 on failure
+	 */
+	int32_t armTrigger(TriggerWindow &ring);
+
+	/**
+	 * @brief  Drain the FIFO into a trigger window once, without waiting
+	 * The first sample with |x|+|y|+|z| >= threshold and preTrigger samples
+	 * before it is the event. Call every FIFO_POLL_MS until ring.ready(),
+	 * then armTrigger() for the next one.
+	 *
+	 * @param  ring: armed trigger window
+	 * @param  threshold: event level, g
+	 * @retval 0 on success, non 0 on failure
+	 */
+	int32_t pollTrigger(TriggerWindow &ring, float threshold);
+
+	/**
+	 * @brief  Arm a trigger window and sleep until it is ready
+	 *
+	 * @param  ring: trigger window to fill
+	 * @param  threshold: event level, g
+	 * @retval 0 on success, non 0 on failure
+	 */
+	int32_t waitTrigger(TriggerWindow &ring, float threshold);
+
+	/**
+	 * @brief  pollTrigger() on two sensors sharing one event
+	 * The first event seen by either sensor is set on both rings at the same
+	 * position, so both windows cover the same time span. If one ring lacks
+	 * the samples before it, the event is counted in PERF_DROPPED and both
+	 * rings start over, still armed.
+	 *
+	 * @param  first, second: acquisitions, one per sensor
+	 * @param  firstRing, secondRing: armed trigger windows
+	 * @param  threshold: event level, g
+	 * @retval 0 on success, non 0 on failure
+	 */
+	static int32_t pollTriggers(AccAcquisition &first, TriggerWindow &firstRing,
+	                            AccAcquisition &second, TriggerWindow &secondRing, float threshold);
+
+	/**
+	 * @brief  |x|+|y|+|z| of the event sample of a triggered window, g
+	 */
+	float triggerLevel(const TriggerWindow &ring) const;
+
+	/**
+	 * @brief  Drain FIFO frames into a window of acc_sample_t
+	 * Scaled floats, or raw counts with -DWINDOW_INT16.
+	 *
+	 * @param  imu: sensor to read
+	 * @param  buffer: 3 * maxFrames samples
+	 * @param  maxFrames: maximum number of frames to read
+	 * @param  numFrames: number of frames read
+	 * @param  range: accelerometer range, for float samples
+	 * @retval 0 on success, non 0 on failure
+	 */
+	static int32_t readFifo(BMI160 &imu, float *buffer, uint16_t maxFrames, uint16_t &numFrames,
+	                        BMI160::AccRange range)
+	{
+		PERF_SCOPE(PERF_FIFO_DRAIN);
+		return imu.getFifoAccXYZ(buffer, maxFrames, numFrames, range);
+	}
+
+	static int32_t readFifo(BMI160 &imu, int16_t *buffer, uint16_t maxFrames, uint16_t &numFrames,
+	                        BMI160::AccRange range)
+	{
+		PERF_SCOPE(PERF_FIFO_DRAIN);
+		(void)range;
+		return imu.getFifoAccXYZ(buffer, maxFrames, numFrames);
+	}
+
+	/**
+	 * @brief  Drain FIFO gyroscope and accelerometer frames into a window
+	 * Same as above for a FIFO configured with gyroEnable.
+	 *
+	 * @param  imu: sensor to read
+	 * @param  buffer: 6 * maxFrames samples, [ax0, ay0, az0, gx0, gy0, gz0, ax1, ...]
+	 * @param  maxFrames: maximum number of frames to read
+	 * @param  numFrames: number of frames read
+	 * @param  range: accelerometer range, for float samples
+	 * @param  gyroRange: gyroscope range, for float samples
+	 * @retval 0 on success, non 0 on failure
+	 */
+	static int32_t readFifo(BMI160 &imu, float *buffer, uint16_t maxFrames, uint16_t &numFrames,
+	                        BMI160::AccRange range, BMI160::GyroRange gyroRange)
+	{
+		PERF_SCOPE(PERF_FIFO_DRAIN);
+		return imu.getFifoGyroAccXYZ(buffer, maxFrames, numFrames, range, gyroRange);
+	}
+
+	static int32_t readFifo(BMI160 &imu, int16_t *buffer, uint16_t maxFrames, uint16_t &numFrames,
+	                        BMI160::AccRange range, BMI160::GyroRange gyroRange)
+	{
+		PERF_SCOPE(PERF_FIFO_DRAIN);
+		(void)range;
+		(void)gyroRange;
+		return imu.getFifoGyroAccXYZ(buffer, maxFrames, numFrames);
+	}
+
+	/**
+	 * @brief  Stamp the frames just drained from the FIFO
+	 *
+	 * @param  imu: sensor just read
+	 * @param  clock: clock of the sample stream
+	 * @param  numFrames: number of frames read
+	 * @param  frameSize: bytes per FIFO frame
+	 * @retval 0 on success, non 0 on failure
+	 */
+	static int32_t stampFifo(BMI160 &imu, SampleClock &clock, uint16_t numFrames,
+	                         uint8_t frameSize = BMI160::FIFO_ACC_FRAME_SIZE);
+
+	/**
+	 * @brief  Sensor read by this acquisition
+	 */
+	BMI160 &imu(void) { return m_imu; }
+
+private:
+	void waitDataReady(void);
+	void dataReadyIsr(void);
+	void motionIsr(void);
+	float sampleLevel(const acc_sample_t *sample) const;
+	int32_t stamp(uint16_t numFrames);
+	int32_t drainFifo(float *buffer, uint16_t maxFrames, uint16_t &numFrames);
+	int32_t drainFifo(int16_t *buffer, uint16_t maxFrames, uint16_t &numFrames);
+
+	BMI160 &m_imu;
+	InterruptIn &m_irq;
+	BMI160::AccRange m_range;
+	BMI160::GyroRange m_gyroRange;
+	uint8_t m_axes;
+	volatile bool m_dataReady;
+	volatile bool m_motion;
+	SampleClock *m_clock;
+#ifdef PERF_STATS
+	int16_t m_lastRaw[3]; /* Previous single sample, to count duplicates */
+#endif
+};
+
+#endif /* ACC_ACQUISITION_H */
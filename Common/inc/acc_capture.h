@@ -0,0 +1,136 @@
+/**
+*******************************************************************************
+* @file   acc_capture.h
+* @brief  Continuous accelerometer capture into a WindowRing
+*******************************************************************************
+* A high priority thread sleeps until the BMI160 FIFO watermark interrupt,
+* then drains the FIFO into the ring. The application consumes complete
+* windows with waitWindow()/releaseWindow() while the next ones keep being
+* captured, so consecutive windows have no gap unless the ring overruns.
+*
+* With a SampleClock attached, each window gets its sensor time stamps as
+* it completes (see sample_clock.h).
+*
+* The FIFO must have been configured (BMI160::setFifoConfig) with
+* accelerometer frames and a watermark before calling start(), and with
+* gyroscope frames too for enableGyro().
+*******************************************************************************
+*/
+
+#ifndef ACC_CAPTURE_H
+#define ACC_CAPTURE_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "mbed.h"
+#include "bmi160.h"
+#include "acc_acquisition.h"
+#include "window_ring.h"
+#include "sample_clock.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define CAPTURE_TIMING_SLOTS 4 /* Window timings kept, at least the ring slots */
+
+/**
+ * @brief  Fail the build if a ring has more slots than the capture has timings
+ */
+#define CAPTURE_SLOTS_CHECK(slots) \
+	static_assert((slots) <= CAPTURE_TIMING_SLOTS, "ring slots over CAPTURE_TIMING_SLOTS")
+
+/**
+ * @brief  FIFO watermark driven capture thread
+ */
+class AccCapture
+{
+public:
+	/**
+	 * @brief  Create a capture, nothing runs before start()
+	 *
+	 * @param  imu: sensor with its FIFO configured
+	 * @param  irq: MCU pin wired to the sensor interrupt pin
+	 * @param  ring: destination of the windows, at most CAPTURE_TIMING_SLOTS slots
+	 */
+	AccCapture(BMI160 &imu, InterruptIn &irq, WindowRing &ring);
+
+	/**
+	 * @brief  Route the FIFO watermark interrupt and start capturing
+	 *
+	 * @param  range: accelerometer range used to scale the samples
+	 * @param  pin: sensor interrupt pin wired to irq
+	 * @retval None
+	 */
+	void start(BMI160::AccRange range, BMI160::InterruptPin pin);
+
+	/**
+	 * @brief  Capture 6 values per sample, [ax, ay, az, gx, gy, gz], call before start()
+	 * The ring must have been created with 6 axes.
+	 *
+	 * @param  range: gyroscope range used to scale the samples
+	 * @retval None
+	 */
+	void enableGyro(BMI160::GyroRange range)
+	{
+		m_gyroRange = range;
+		m_frameSize = BMI160::FIFO_GYRO_ACC_FRAME_SIZE;
+	}
+
+	/**
+	 * @brief  Stamp the captured windows, call before start()
+	 *
+	 * @param  clock: clock of the FIFO frame period, used by the capture thread only
+	 * @retval None
+	 */
+	void setClock(SampleClock *clock) { m_clock = clock; }
+
+	/**
+	 * @brief  Timing of the window returned by waitWindow()
+	 *
+	 * @param  timing: holds the timing
+	 * @retval true if the timing is known, false without a clock
+	 */
+	bool windowTiming(WindowTiming &timing) const;
+
+	/**
+	 * @brief  Block until a complete window is available
+	 *
+	 * @retval Window, valid until releaseWindow()
+	 */
+	acc_sample_t *waitWindow(void);
+
+	/**
+	 * @brief  Give the window returned by waitWindow back to the capture
+	 *
+	 * @retval None
+	 */
+	void releaseWindow(void);
+
+	/**
+	 * @brief  Ring fed by this capture, for its counters
+	 */
+	const WindowRing &ring(void) const { return m_ring; }
+
+	/**
+	 * @brief  Drain the FIFO into the ring once, as the thread does on each watermark
+	 * Only for host replays, the capture thread is the single producer.
+	 *
+	 * @retval None
+	 */
+	void drain(void);
+
+private:
+	void fifoIsr(void);
+	void run(void);
+
+	BMI160 &m_imu;
+	InterruptIn &m_irq;
+	WindowRing &m_ring;
+	BMI160::AccRange m_range;
+	BMI160::GyroRange m_gyroRange;
+	uint8_t m_frameSize; /* FIFO frame size, 12 bytes with the gyroscope */
+	Thread m_thread;
+	EventFlags m_flags;
+	SampleClock *m_clock;
+	WindowTiming m_timing[CAPTURE_TIMING_SLOTS]; /* Indexed by window number */
+	uint32_t m_taken; /* Windows released by the consumer */
+};
+
+#endif /* ACC_CAPTURE_H */
@@ -0,0 +1,44 @@
+/**
+*******************************************************************************
+* @file   acc_sample.h
+* @brief  Type of the accelerometer samples stored in windows
+*******************************************************************************
+* Windows hold scaled floats (g) by default. Build with -DWINDOW_INT16 to
+* store the raw int16 counts of the sensor instead, half the RAM per window;
+* the application then scales to float only where NanoEdge AI needs it
+* (Window::toG, see window.h, with BMI160::getAccScale).
+*******************************************************************************
+*/
+
+#ifndef ACC_SAMPLE_H
+#define ACC_SAMPLE_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Types ---------------------------------------------------------------------*/
+#ifdef WINDOW_INT16
+typedef int16_t acc_sample_t;
+#else
+typedef float acc_sample_t;
+#endif
+
+/**
+ * @brief  Value of a stored sample in g
+ *
+ * @param  value: stored sample
+ * @param  scale: g per LSB of the raw counts
+ * @retval Sample in g
+ */
+inline float acc_sample_to_g(float value, float scale)
+{
+	(void)scale;
+	return value;
+}
+
+inline float acc_sample_to_g(int16_t value, float scale)
+{
+	return value * scale;
+}
+
+#endif /* ACC_SAMPLE_H */
@@ -86,6 +86,10 @@ public:
         float seconds; ///<SensorTime as seconds
     };
     
+    ///Sensor time ticks per second, 39.0625us per tick.  The 24 bit 
+    ///counter wraps every 655.36s
+    static const uint32_t SENSOR_TIME_HZ = 25600;
+    
     ///Structure for holding sensor data
     struct SensorData
     {
@@ -367,6 +371,191 @@ public:
     ///@}
     
     
+    ///@name FIFO_DOWNS(0x45), FIFO_CONFIG_0(0x46) and FIFO_CONFIG_1(0x47)
+    ///Data for configuring the FIFO
+    ///@{
+    
+    static const uint8_t FIFO_GYRO_DOWNS_MASK = 0x07;
+    static const uint8_t FIFO_GYRO_DOWNS_POS = 0x00;
+    static const uint8_t FIFO_GYRO_FILT_MASK = 0x08;
+    static const uint8_t FIFO_GYRO_FILT_POS = 0x03;
+    static const uint8_t FIFO_ACC_DOWNS_MASK = 0x70;
+    static const uint8_t FIFO_ACC_DOWNS_POS = 0x04;
+    static const uint8_t FIFO_ACC_FILT_MASK = 0x80;
+    static const uint8_t FIFO_ACC_FILT_POS = 0x07;
+    static const uint8_t FIFO_TIME_EN_MASK = 0x02;
+    static const uint8_t FIFO_TIME_EN_POS = 0x01;
+    static const uint8_t FIFO_HEADER_EN_MASK = 0x10;
+    static const uint8_t FIFO_HEADER_EN_POS = 0x04;
+    static const uint8_t FIFO_MAG_EN_MASK = 0x20;
+    static const uint8_t FIFO_MAG_EN_POS = 0x05;
+    static const uint8_t FIFO_ACC_EN_MASK = 0x40;
+    static const uint8_t FIFO_ACC_EN_POS = 0x06;
+    static const uint8_t FIFO_GYRO_EN_MASK = 0x80;
+    static const uint8_t FIFO_GYRO_EN_POS = 0x07;
+    static const uint8_t FIFO_LENGTH_1_MASK = 0x07;
+    
+    ///FIFO capacity in bytes
+    static const uint16_t FIFO_SIZE = 1024;
+    ///Size of a headerless accelerometer frame in bytes
+    static const uint8_t FIFO_ACC_FRAME_SIZE = 6;
+    ///Size of a headerless gyroscope and accelerometer frame in bytes
+    static const uint8_t FIFO_GYRO_ACC_FRAME_SIZE = 12;
+    ///FIFO_CONFIG_0 watermark unit in bytes
+    static const uint8_t FIFO_WATERMARK_LSB = 4;
+    
+    ///FIFO down sampling ratios, applied to the sensor ODR
+    enum FifoDownSampling
+    {
+        FIFO_DOWNS_1 = 0, ///<Every sample
+        FIFO_DOWNS_2,     ///<Every 2nd sample
+        FIFO_DOWNS_4,     ///<Every 4th sample
+        FIFO_DOWNS_8,     ///<Every 8th sample
+        FIFO_DOWNS_16,    ///<Every 16th sample
+        FIFO_DOWNS_32,    ///<Every 32nd sample
+        FIFO_DOWNS_64,    ///<Every 64th sample
+        FIFO_DOWNS_128    ///<Every 128th sample
+    };
+    
+    ///FIFO configuration data structure.  Only headerless frames without 
+    ///sensor time are supported by the frame decoder.  Headerless frames 
+    ///with both sensors need the same rate for both: the gyroscope gets the 
+    ///accelerometer down sampling and filter settings, and must be set to 
+    ///the accelerometer ODR.
+    struct FifoConfig
+    {
+        bool accEnable;             ///<Store accelerometer frames
+        bool accFiltered;           ///<Store filtered accelerometer data
+        FifoDownSampling accDowns;  ///<Accelerometer down sampling ratio
+        uint16_t watermark;         ///<Watermark level in bytes
+        bool gyroEnable;            ///<Store gyroscope data in the frames too
+    };
+    
+    ///FIFO default configuration
+    static const FifoConfig DEFAULT_FIFO_CONFIG;
+    ///@}
+    
+    
+    ///@name INT_EN_1(0x51), INT_OUT_CTRL(0x53), INT_LATCH(0x54) and 
+    ///INT_MAP_1(0x56)
+    ///Data for configuring data interrupts
+    ///@{
+    
+    static const uint8_t INT1_OUT_CTRL_MASK = 0x0F;
+    static const uint8_t INT1_OUT_CTRL_POS = 0x00;
+    static const uint8_t INT2_OUT_CTRL_MASK = 0xF0;
+    static const uint8_t INT2_OUT_CTRL_POS = 0x04;
+    static const uint8_t INT_EDGE_CTRL_POS = 0x00;
+    static const uint8_t INT_LVL_POS = 0x01;
+    static const uint8_t INT_OD_POS = 0x02;
+    static const uint8_t INT_OUTPUT_EN_POS = 0x03;
+    static const uint8_t INT_LATCH_MASK = 0x0F;
+    static const uint8_t INT_LATCH_POS = 0x00;
+    static const uint8_t INT1_MAP_DRDY_MASK = 0x80;
+    static const uint8_t INT1_MAP_FWM_MASK = 0x40;
+    static const uint8_t INT1_MAP_FFULL_MASK = 0x20;
+    static const uint8_t INT2_MAP_DRDY_MASK = 0x08;
+    static const uint8_t INT2_MAP_FWM_MASK = 0x04;
+    static const uint8_t INT2_MAP_FFULL_MASK = 0x02;
+    
+    ///Interrupt pins
+    enum InterruptPin
+    {
+        INT1 = 0, ///<INT1 pin
+        INT2      ///<INT2 pin
+    };
+    
+    ///Data interrupts, values are the INT_EN_1 and INT_STATUS_1 bits
+    enum DataInterrupt
+    {
+        DRDY_INT = 0x10,  ///<New data available in data registers
+        FFULL_INT = 0x20, ///<FIFO full
+        FWM_INT = 0x40    ///<FIFO fill level above watermark
+    };
+    
+    ///Interrupt latch durations
+    enum InterruptLatch
+    {
+        INT_NON_LATCHED = 0, ///<Interrupt pin follows the interrupt signal
+        INT_LATCH_312_5_US,  ///<Temporary latch of 312.5us
+        INT_LATCH_625_US,    ///<Temporary latch of 625us
+        INT_LATCH_1_25_MS,   ///<Temporary latch of 1.25ms
+        INT_LATCH_2_5_MS,    ///<Temporary latch of 2.5ms
+        INT_LATCH_5_MS,      ///<Temporary latch of 5ms
+        INT_LATCH_10_MS,     ///<Temporary latch of 10ms
+        INT_LATCH_20_MS,     ///<Temporary latch of 20ms
+        INT_LATCH_40_MS,     ///<Temporary latch of 40ms
+        INT_LATCH_80_MS,     ///<Temporary latch of 80ms
+        INT_LATCH_160_MS,    ///<Temporary latch of 160ms
+        INT_LATCH_320_MS,    ///<Temporary latch of 320ms
+        INT_LATCH_640_MS,    ///<Temporary latch of 640ms
+        INT_LATCH_1_28_S,    ///<Temporary latch of 1.28s
+        INT_LATCH_2_56_S,    ///<Temporary latch of 2.56s
+        INT_LATCHED          ///<Latched until INT_RESET command
+    };
+    
+    ///Interrupt pin electrical configuration data structure
+    struct IntPinConfig
+    {
+        bool edgeTrigger;  ///<Edge instead of level trigger when used as input
+        bool activeHigh;   ///<Active high instead of active low output
+        bool openDrain;    ///<Open drain instead of push-pull output
+        bool outputEnable; ///<Pin is used as an output
+    };
+    
+    ///Interrupt pin default configuration, push-pull active high output
+    static const IntPinConfig DEFAULT_INT_PIN_CONFIG;
+    ///@}
+    
+    
+    ///@name INT_EN_0(0x50), INT_EN_1(0x51), INT_MAP_0(0x55), INT_MAP_2(0x57), 
+    ///INT_LOWHIGH_2(0x5C) to INT_LOWHIGH_4(0x5E), INT_MOTION_0(0x5F) and 
+    ///INT_MOTION_1(0x60)
+    ///Data for configuring the any-motion and high-g interrupts
+    ///@{
+    
+    static const uint8_t ANYMO_EN_MASK = 0x07;
+    static const uint8_t HIGHG_EN_MASK = 0x07;
+    static const uint8_t MAP_HIGHG_MASK = 0x02;
+    static const uint8_t MAP_ANYMO_MASK = 0x04;
+    static const uint8_t ANYMO_DUR_MASK = 0x03;
+    static const uint8_t ANYMO_DUR_POS = 0x00;
+    static const uint8_t HIGHG_HY_MASK = 0xC0;
+    static const uint8_t HIGHG_HY_POS = 0x06;
+    
+    ///Any-motion threshold LSB, in accelerometer data LSBs
+    static const uint16_t ANYMO_TH_LSB = 64;
+    ///High-g threshold LSB, in accelerometer data LSBs
+    static const uint16_t HIGHG_TH_LSB = 128;
+    ///High-g hysteresis LSB, in accelerometer data LSBs
+    static const uint16_t HIGHG_HY_LSB = 2048;
+    ///High-g duration LSB, in ms
+    static const float HIGHG_DUR_LSB_MS;
+    
+    ///Motion interrupts, values are the getInterruptStatus() bits
+    enum MotionInterrupt
+    {
+        ANY_MOTION_INT = 0x0004, ///<Slope between samples above threshold
+        HIGH_G_INT = 0x0400      ///<Acceleration above threshold on an axis
+    };
+    
+    ///Any-motion interrupt configuration data structure
+    struct AnyMotionConfig
+    {
+        float threshold; ///<Slope threshold, g
+        uint8_t samples; ///<Consecutive samples above threshold, 1 to 4
+    };
+    
+    ///High-g interrupt configuration data structure
+    struct HighGConfig
+    {
+        float threshold;  ///<Threshold on any axis, g
+        float hysteresis; ///<Hysteresis below threshold to clear, g
+        float duration;   ///<Time above threshold before the interrupt, ms
+    };
+    ///@}
+    
+    
     ///Enumerated power modes
     enum PowerModes
     {
@@ -465,6 +654,23 @@ public:
     const uint8_t *data) = 0;
     
     
+    ///@brief Reads 'numBytes' from a single register in one transfer.\n
+    ///@detail Used for burst registers such as FIFO_DATA, where the 
+    ///register address does not auto increment.\n
+    ///
+    ///On Entry:
+    ///@param[in] reg - register to read from
+    ///@param[in] data - pointer to memory for storing read data
+    ///@param[in] numBytes - number of bytes to read
+    ///
+    ///On Exit:
+    ///@param[out] data - holds read bytes on success
+    ///
+    ///@returns 0 on success, non 0 on failure
+    virtual int32_t readBurst(Registers reg, uint8_t *data, 
+    uint32_t numBytes) = 0;
+    
+    
     ///@brief Sets sensors power mode through CMD register.\n
     ///@details Observe command execution times given in datasheet.\n 
     ///
@@ -574,6 +780,361 @@ public:
                                        AccRange accRange, GyroRange gyroRange);
     
     
+    ///@brief Get the scale of an accelerometer range.\n
+    ///@detail Table lookup, resolve it once when configuring the range and 
+    ///scale with a multiply instead of a division per axis.\n
+    ///
+    ///On Entry:
+    ///@param[in] range - Accelerometer range
+    ///
+    ///On Exit:
+    ///@param[out] none
+    ///
+    ///@returns g per LSB, 0 for a reserved range
+    static float getAccScale(AccRange range);
+    
+    
+    ///@brief Get the scale of a gyroscope range.\n
+    ///
+    ///On Entry:
+    ///@param[in] range - Gyroscope range
+    ///
+    ///On Exit:
+    ///@param[out] none
+    ///
+    ///@returns dps per LSB, 0 for a reserved range
+    static float getGyroScale(GyroRange range);
+    
+    
+    ///@brief Scale a block of raw axis values.\n
+    ///
+    ///On Entry:
+    ///@param[in] raw - raw axis values
+    ///@param[in] buffer - pointer to memory for 'numValues' floats
+    ///@param[in] numValues - number of values to scale
+    ///@param[in] scale - from getAccScale() or getGyroScale()
+    ///
+    ///On Exit:
+    ///@param[out] buffer - holds the scaled values
+    ///
+    ///@returns none
+    static void scaleRaw(const int16_t *raw, float *buffer, uint32_t numValues, 
+                         float scale);
+    
+    
+    ///@brief Decode and scale headerless FIFO accelerometer frames.\n
+    ///@detail One pass from the little endian FIFO burst to the 
+    ///[x0, y0, z0, x1, ...] float window.  'frames' may live inside 
+    ///'buffer' as long as it starts at or above 
+    ///'buffer' + 6 * 'numFrames' bytes, as getFifoAccXYZ does.\n
+    ///
+    ///On Entry:
+    ///@param[in] frames - FIFO_ACC_FRAME_SIZE bytes per frame
+    ///@param[in] buffer - pointer to memory for 3 * 'numFrames' floats
+    ///@param[in] numFrames - number of frames
+    ///@param[in] scale - from getAccScale()
+    ///
+    ///On Exit:
+    ///@param[out] buffer - holds the scaled samples
+    ///
+    ///@returns none
+    static void scaleFifoAccFrames(const uint8_t *frames, float *buffer, 
+                                   uint16_t numFrames, float scale);
+    
+    
+    ///@brief Decode and scale headerless FIFO gyroscope and accelerometer 
+    ///frames.\n
+    ///@detail Frames hold the gyroscope then the accelerometer axes, 
+    ///samples are written accelerometer first: [ax0, ay0, az0, gx0, gy0, 
+    ///gz0, ax1, ...].  'frames' may live inside 'buffer' as for 
+    ///scaleFifoAccFrames.\n
+    ///
+    ///On Entry:
+    ///@param[in] frames - FIFO_GYRO_ACC_FRAME_SIZE bytes per frame
+    ///@param[in] buffer - pointer to memory for 6 * 'numFrames' floats
+    ///@param[in] numFrames - number of frames
+    ///@param[in] accScale - from getAccScale()
+    ///@param[in] gyroScale - from getGyroScale()
+    ///
+    ///On Exit:
+    ///@param[out] buffer - holds the scaled samples
+    ///
+    ///@returns none
+    static void scaleFifoGyroAccFrames(const uint8_t *frames, float *buffer, 
+                                       uint16_t numFrames, float accScale, 
+                                       float gyroScale);
+    
+    
+    ///@brief Time between two FIFO accelerometer frames.\n
+    ///@detail A sample is taken when the sensor time bit of its period 
+    ///toggles, so frames sit on a grid of multiples of this period.\n
+    ///
+    ///On Entry:
+    ///@param[in] odr - Accelerometer output data rate
+    ///@param[in] downs - FIFO down sampling ratio
+    ///
+    ///On Exit:
+    ///@param[out] none
+    ///
+    ///@returns Frame period in sensor time ticks, a power of 2
+    static uint32_t getFifoFramePeriod(AccOutputDataRate odr, 
+                                       FifoDownSampling downs);
+    
+    
+    ///@brief Configure FIFO.\n
+    ///
+    ///On Entry:
+    ///@param[in] config - FIFO configuration data structure
+    ///
+    ///On Exit:
+    ///@param[out] none
+    ///
+    ///@returns 0 on success, non 0 on failure
+    int32_t setFifoConfig(const FifoConfig &config);
+    
+    
+    ///@brief Get FIFO configuration.\n
+    ///
+    ///On Entry:
+    ///@param[in] config - FIFO configuration data structure
+    ///
+    ///On Exit:
+    ///@param[out] config - on success, holds FIFO's current configuration
+    ///
+    ///@returns 0 on success, non 0 on failure
+    int32_t getFifoConfig(FifoConfig &config);
+    
+    
+    ///@brief Clears FIFO content through CMD register.\n
+    ///
+    ///On Entry:
+    ///@param[in] none
+    ///
+    ///On Exit:
+    ///@param[out] none
+    ///
+    ///@returns 0 on success, non 0 on failure
+    int32_t flushFifo();
+    
+    
+    ///@brief Get FIFO fill level.\n
+    ///
+    ///On Entry:
+    ///@param[in] length - reference to fill level
+    ///
+    ///On Exit:
+    ///@param[out] length - on success, number of bytes in FIFO
+    ///
+    ///@returns 0 on success, non 0 on failure
+    int32_t getFifoLength(uint16_t &length);
+    
+    
+    ///@brief Drain accelerometer frames from FIFO.\n
+    ///@detail Reads FIFO_LENGTH, then moves up to 'maxFrames' complete 
+    ///headerless frames out of FIFO_DATA in a single burst and decodes them 
+    ///in place into 'buffer' as [x0, y0, z0, x1, y1, z1, ...], the layout 
+    ///expected by NanoEdgeAI_learn/detect.  'buffer' must have room for 
+    ///3 * 'maxFrames' floats.\n
+    ///
+    ///On Entry:
+    ///@param[in] buffer - pointer to window position to fill
+    ///@param[in] maxFrames - maximum number of frames to read
+    ///@param[in] range - Accelerometer range
+    ///
+    ///On Exit:
+    ///@param[out] buffer - holds scaled data of the frames read
+    ///@param[out] numFrames - number of frames read, 0 if FIFO was empty
+    ///
+    ///@returns 0 on success, non 0 on failure
+    int32_t getFifoAccXYZ(float *buffer, uint16_t maxFrames, 
+                          uint16_t &numFrames, AccRange range);
+    
+    
+    ///@brief Drain raw accelerometer frames from FIFO.\n
+    ///@detail Same as above without scaling: 'buffer' receives the int16 
+    ///counts as [x0, y0, z0, x1, ...], half the memory of scaled floats.  
+    ///'buffer' must have room for 3 * 'maxFrames' values.\n
+    ///
+    ///On Entry:
+    ///@param[in] buffer - pointer to window position to fill
+    ///@param[in] maxFrames - maximum number of frames to read
+    ///
+    ///On Exit:
+    ///@param[out] buffer - holds raw data of the frames read
+    ///@param[out] numFrames - number of frames read, 0 if FIFO was empty
+    ///
+    ///@returns 0 on success, non 0 on failure
+    int32_t getFifoAccXYZ(int16_t *buffer, uint16_t maxFrames, 
+                          uint16_t &numFrames);
+    
+    
+    ///@brief Drain gyroscope and accelerometer frames from FIFO.\n
+    ///@detail As getFifoAccXYZ, for a FIFO configured with gyroEnable: one 
+    ///burst moves both sensors, 'buffer' receives 6 values per sample, 
+    ///accelerometer first (see scaleFifoGyroAccFrames).  'buffer' must have 
+    ///room for 6 * 'maxFrames' floats.\n
+    ///
+    ///On Entry:
+    ///@param[in] buffer - pointer to window position to fill
+    ///@param[in] maxFrames - maximum number of frames to read
+    ///@param[in] accRange - Accelerometer range
+    ///@param[in] gyroRange - Gyroscope range
+    ///
+    ///On Exit:
+    ///@param[out] buffer - holds scaled data of the frames read
+    ///@param[out] numFrames - number of frames read, 0 if FIFO was empty
+    ///
+    ///@returns 0 on success, non 0 on failure
+    int32_t getFifoGyroAccXYZ(float *buffer, uint16_t maxFrames, 
+                              uint16_t &numFrames, AccRange accRange, 
+                              GyroRange gyroRange);
+    
+    
+    ///@brief Drain raw gyroscope and accelerometer frames from FIFO.\n
+    ///@detail Same as above without scaling, int16 counts in the same 
+    ///order.\n
+    ///
+    ///On Entry:
+    ///@param[in] buffer - pointer to window position to fill
+    ///@param[in] maxFrames - maximum number of frames to read
+    ///
+    ///On Exit:
+    ///@param[out] buffer - holds raw data of the frames read
+    ///@param[out] numFrames - number of frames read, 0 if FIFO was empty
+    ///
+    ///@returns 0 on success, non 0 on failure
+    int32_t getFifoGyroAccXYZ(int16_t *buffer, uint16_t maxFrames, 
+                              uint16_t &numFrames);
+    
+    
+    ///@brief Configure the electrical behaviour of an interrupt pin.\n
+    ///
+    ///On Entry:
+    ///@param[in] pin - Interrupt pin to configure
+    ///@param[in] config - Interrupt pin configuration data structure
+    ///
+    ///On Exit:
+    ///@param[out] none
+    ///
+    ///@returns 0 on success, non 0 on failure
+    int32_t setInterruptPinConfig(InterruptPin pin, 
+                                  const IntPinConfig &config);
+    
+    
+    ///@brief Set the latch mode shared by both interrupt pins.\n
+    ///
+    ///On Entry:
+    ///@param[in] latch - Interrupt latch duration
+    ///
+    ///On Exit:
+    ///@param[out] none
+    ///
+    ///@returns 0 on success, non 0 on failure
+    int32_t setInterruptLatch(InterruptLatch latch);
+    
+    
+    ///@brief Enable a data interrupt and map it to an interrupt pin.\n
+    ///
+    ///On Entry:
+    ///@param[in] source - Data interrupt to enable
+    ///@param[in] pin - Interrupt pin the interrupt is routed to
+    ///
+    ///On Exit:
+    ///@param[out] none
+    ///
+    ///@returns 0 on success, non 0 on failure
+    int32_t enableDataInterrupt(DataInterrupt source, InterruptPin pin);
+    
+    
+    ///@brief Disable a data interrupt and unmap it from both pins.\n
+    ///
+    ///On Entry:
+    ///@param[in] source - Data interrupt to disable
+    ///
+    ///On Exit:
+    ///@param[out] none
+    ///
+    ///@returns 0 on success, non 0 on failure
+    int32_t disableDataInterrupt(DataInterrupt source);
+    
+    
+    ///@brief Configure the any-motion interrupt engine.\n
+    ///
+    ///On Entry:
+    ///@param[in] config - Any-motion configuration data structure
+    ///@param[in] range - Accelerometer range the threshold is scaled to
+    ///
+    ///On Exit:
+    ///@param[out] none
+    ///
+    ///@returns 0 on success, non 0 on failure
+    int32_t setAnyMotionConfig(const AnyMotionConfig &config, AccRange range);
+    
+    
+    ///@brief Configure the high-g interrupt engine.\n
+    ///
+    ///On Entry:
+    ///@param[in] config - High-g configuration data structure
+    ///@param[in] range - Accelerometer range the thresholds are scaled to
+    ///
+    ///On Exit:
+    ///@param[out] none
+    ///
+    ///@returns 0 on success, non 0 on failure
+    int32_t setHighGConfig(const HighGConfig &config, AccRange range);
+    
+    
+    ///@brief Enable a motion interrupt on all axes and map it to an 
+    ///interrupt pin.\n
+    ///
+    ///On Entry:
+    ///@param[in] source - Motion interrupt to enable
+    ///@param[in] pin - Interrupt pin the interrupt is routed to
+    ///
+    ///On Exit:
+    ///@param[out] none
+    ///
+    ///@returns 0 on success, non 0 on failure
+    int32_t enableMotionInterrupt(MotionInterrupt source, InterruptPin pin);
+    
+    
+    ///@brief Disable a motion interrupt and unmap it from both pins.\n
+    ///
+    ///On Entry:
+    ///@param[in] source - Motion interrupt to disable
+    ///
+    ///On Exit:
+    ///@param[out] none
+    ///
+    ///@returns 0 on success, non 0 on failure
+    int32_t disableMotionInterrupt(MotionInterrupt source);
+    
+    
+    ///@brief Get interrupt status.\n
+    ///
+    ///On Entry:
+    ///@param[in] status - reference to status word
+    ///
+    ///On Exit:
+    ///@param[out] status - on success, INT_STATUS_0 to INT_STATUS_3 with 
+    ///INT_STATUS_0 in bits7:0
+    ///
+    ///@returns 0 on success, non 0 on failure
+    int32_t getInterruptStatus(uint32_t &status);
+    
+    
+    ///@brief Clears interrupt engine, INT_STATUS and the interrupt pins.\n
+    ///
+    ///On Entry:
+    ///@param[in] none
+    ///
+    ///On Exit:
+    ///@param[out] none
+    ///
+    ///@returns 0 on success, non 0 on failure
+    int32_t resetInterrupts();
+    
+    
     ///@brief Get sensor time.\n
     ///
     ///On Entry:
@@ -586,6 +1147,24 @@ public:
     int32_t getSensorTime(SensorTime &sensorTime);
     
     
+    ///@brief Get sensor time and FIFO fill level.\n
+    ///@detail One burst from SENSORTIME_0 to FIFO_LENGTH_1: the fill level 
+    ///is the one at the sensor time read, the newest frame in FIFO was 
+    ///sampled on the last multiple of getFifoFramePeriod() up to it.\n
+    ///
+    ///On Entry:
+    ///@param[in] sensorTime - SensorTime structure for data
+    ///@param[in] length - reference to fill level
+    ///
+    ///On Exit:
+    ///@param[out] sensorTime - Holds sensor time on success
+    ///@param[out] length - on success, number of bytes in FIFO
+    ///
+    ///@returns 0 on success, non 0 on failure
+    int32_t getSensorTimeAndFifoLength(SensorTime &sensorTime, 
+                                       uint16_t &length);
+    
+    
     ///@brief Get die temperature.\n
     ///
     ///On Entry:
@@ -596,6 +1175,35 @@ public:
     ///
     ///@returns 0 on success, non 0 on failure
     int32_t getTemperature(float *temp);
+    
+protected:
+    
+    ///@brief Read-modify-write of the bits of a single register.\n
+    ///
+    ///On Entry:
+    ///@param[in] reg - register to update
+    ///@param[in] mask - bits of the register to update
+    ///@param[in] data - new value of the masked bits
+    ///
+    ///On Exit:
+    ///@param[out] none
+    ///
+    ///@returns 0 on success, non 0 on failure
+    int32_t updateRegister(Registers reg, uint8_t mask, uint8_t data);
+    
+    
+    ///@brief Number of complete frames ready in FIFO.\n
+    ///
+    ///On Entry:
+    ///@param[in] frameSize - bytes per frame
+    ///@param[in] maxFrames - maximum number of frames wanted
+    ///
+    ///On Exit:
+    ///@param[out] numFrames - min(frames in FIFO, 'maxFrames')
+    ///
+    ///@returns 0 on success, non 0 on failure
+    int32_t getFifoFrames(uint8_t frameSize, uint16_t maxFrames, 
+                          uint16_t &numFrames);
 };
 
 
@@ -684,6 +1292,20 @@ public:
     virtual int32_t writeBlock(Registers startReg, Registers stopReg, 
     const uint8_t *data);
     
+    
+    ///@brief Reads 'numBytes' from a single register in one transfer.\n
+    ///
+    ///On Entry:
+    ///@param[in] reg - register to read from
+    ///@param[in] data - pointer to memory for storing read data
+    ///@param[in] numBytes - number of bytes to read
+    ///
+    ///On Exit:
+    ///@param[out] data - holds read bytes on success
+    ///
+    ///@returns 0 on success, non 0 on failure
+    virtual int32_t readBurst(Registers reg, uint8_t *data, uint32_t numBytes);
+    
 private:
 
     I2C &m_i2cBus;
@@ -698,7 +1320,21 @@ class BMI160_SPI: public BMI160
 {
 public:
 
+    ///Read/write flag, bit7 of the address byte
+    static const uint8_t SPI_READ = 0x80;
+    ///Register address bits of the address byte
+    static const uint8_t SPI_ADRS_MASK = 0x7F;
+    ///Register read once after power up to switch the interface to SPI
+    static const uint8_t SPI_DUMMY_ADRS = 0x7F;
+    ///Reads of at least this many bytes use an asynchronous (DMA) transfer 
+    ///when the target supports it
+    static const uint32_t SPI_ASYNCH_MIN_BYTES = 32;
+    
+
     ///@brief BMI160_SPI Constructor.\n
+    ///@detail The bus must be configured by the application for 8 bit 
+    ///words, mode 0 or 3, and at most 10MHz.  The interface is switched to 
+    ///SPI by a dummy read on the first transaction.\n
     ///
     ///On Entry:
     ///@param[in] spiBus - reference to SPI bus for this device
@@ -770,10 +1406,43 @@ public:
     virtual int32_t writeBlock(Registers startReg, Registers stopReg, 
     const uint8_t *data);
     
+    
+    ///@brief Reads 'numBytes' from a single register in one transfer.\n
+    ///
+    ///On Entry:
+    ///@param[in] reg - register to read from
+    ///@param[in] data - pointer to memory for storing read data
+    ///@param[in] numBytes - number of bytes to read
+    ///
+    ///On Exit:
+    ///@param[out] data - holds read bytes on success
+    ///
+    ///@returns 0 on success, non 0 on failure
+    virtual int32_t readBurst(Registers reg, uint8_t *data, uint32_t numBytes);
+    
 private:
 
+    ///Selects the device, switching it to SPI first if needed, and sends 
+    ///the address byte
+    void select(uint8_t adrs);
+    ///Deselects the device
+    void deselect();
+    
+    ///Receives 'numBytes' into 'data' while the device is selected, 
+    ///returns 0 on success, non 0 if the transfer ended in error
+    int32_t receive(uint8_t *data, uint32_t numBytes);
+    
+#if DEVICE_SPI_ASYNCH
+    ///Completion callback of asynchronous transfers
+    void transferDone(int event);
+    
+    volatile bool m_transferDone;
+    volatile int m_transferEvent;
+#endif
+    
     SPI &m_spiBus;
-    DigitalOut m_cs;
+    DigitalOut &m_cs;
+    bool m_spiMode;
 };
 
 #endif /* BMI160_H */
@@ -0,0 +1,141 @@
+/**
+*******************************************************************************
+* @file   command_parser.h
+* @brief  Line commands received on a serial port
+*******************************************************************************
+* One command per line, ended by CR and/or LF, keyword case insensitive:
+*
+*   B <n>              blue goal count += n (signed integer)
+*   R <n>              red goal count += n
+*   RESET              reset the game
+*   SENS <x>           sensitivity, decimal with up to 3 fraction digits
+*   MODE <n>           switch to application mode n
+*   STATS              dump and clear the timing statistics (see perf_stats.h)
+*
+* CommandParser takes one byte at a time in O(1), without sscanf and with
+* bounded state, so it can run in the RX interrupt. Complete commands go
+* through a CommandQueue to the main loop. Malformed lines are reported as
+* CMD_ERROR commands, empty lines are ignored.
+*******************************************************************************
+*/
+
+#ifndef COMMAND_PARSER_H
+#define COMMAND_PARSER_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "mbed.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define COMMAND_KEYWORD_SIZE 8 /* Longest keyword, characters */
+#define COMMAND_FRACTION_DIGITS 3 /* SENS resolution 0.001 */
+#define COMMAND_VALUE_MAX 1000000L /* Larger arguments are an error */
+
+/**
+ * @brief  Command types
+ */
+enum CommandType {
+	CMD_ERROR = 0,   ///<Malformed line
+	CMD_SCORE,       ///<B or R, target is 'B' or 'R', value the goals to add
+	CMD_RESET,       ///<RESET
+	CMD_SENSITIVITY, ///<SENS, value in thousandths
+	CMD_MODE,        ///<MODE, value the mode number
+	CMD_STATS        ///<STATS
+};
+
+/**
+ * @brief  Parsed command
+ */
+struct Command {
+	CommandType type;
+	char target;
+	int32_t value;
+};
+
+/**
+ * @brief  Incremental command line parser
+ */
+class CommandParser
+{
+public:
+	CommandParser(void);
+
+	/**
+	 * @brief  Forget the current line
+	 *
+	 * @retval None
+	 */
+	void reset(void);
+
+	/**
+	 * @brief  Parse one received byte
+	 *
+	 * @param  byte: received byte
+	 * @param  command: holds the command when a line ends
+	 * @retval true if a line ended with a command (or an error) in command
+	 */
+	bool feed(char byte, Command &command);
+
+private:
+	enum State {
+		IDLE,     /* Nothing on the line yet */
+		KEYWORD,  /* Letters of the keyword */
+		GAP,      /* Blanks between keyword and argument */
+		SIGN,     /* Sign read, digits expected */
+		INTEGER,  /* Integer digits */
+		FRACTION, /* Fraction digits */
+		TRAILING, /* Blanks after the argument */
+		INVALID   /* Skip to the end of the line */
+	};
+
+	bool finish(Command &command);
+
+	State m_state;
+	char m_keyword[COMMAND_KEYWORD_SIZE];
+	uint8_t m_keywordLength;
+	bool m_hasValue;
+	bool m_negative;
+	int32_t m_value;
+	uint8_t m_fractionDigits;
+};
+
+/**
+ * @brief  Commands from the RX interrupt to the main loop
+ * Single producer (the ISR), single consumer (the main loop).
+ */
+class CommandQueue
+{
+public:
+	///Pending commands at most
+	static const uint8_t SLOTS = 8;
+
+	CommandQueue(void);
+
+	/**
+	 * @brief  Queue a command, from the producer
+	 *
+	 * @param  command: command to queue
+	 * @retval false if the queue was full and the command dropped
+	 */
+	bool push(const Command &command);
+
+	/**
+	 * @brief  Take the oldest command, from the consumer
+	 *
+	 * @param  command: holds the command on success
+	 * @retval false if no command is pending
+	 */
+	bool pop(Command &command);
+
+	/**
+	 * @brief  Commands dropped because the queue was full
+	 */
+	uint32_t dropped(void) const { return m_dropped; }
+
+private:
+	Command m_commands[SLOTS];
+	volatile uint32_t m_pushed;
+	volatile uint32_t m_popped;
+	volatile uint32_t m_dropped;
+};
+
+#endif /* COMMAND_PARSER_H */
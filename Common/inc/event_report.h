@@ -0,0 +1,85 @@
+/**
+*******************************************************************************
+* @file   event_report.h
+* @brief  Non-blocking event messages on one or two serial ports
+*******************************************************************************
+* printf() formats the message into a slot of a single producer, single
+* consumer queue and returns at once; a low priority thread writes the
+* queued messages to the ports. The loop producing events is never held by
+* the serial output, the Bluetooth port at 9600 baud included.
+*
+* When the ports are slower than the events the newest messages are dropped
+* and counted, messages longer than MESSAGE_SIZE - 1 are cut and counted.
+* printf() must always be called from the same thread, never from an ISR.
+*******************************************************************************
+*/
+
+#ifndef EVENT_REPORT_H
+#define EVENT_REPORT_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "mbed.h"
+
+/**
+ * @brief  Serial reporting through a message queue and a writer thread
+ */
+class EventReport
+{
+public:
+	///Queued messages at most
+	static const uint8_t SLOTS = 16;
+	///Bytes per message, terminating null included
+	static const uint8_t MESSAGE_SIZE = 64;
+
+	/**
+	 * @brief  Report on a single port, nothing is written before start()
+	 *
+	 * @param  port: output port
+	 */
+	EventReport(RawSerial &port);
+
+	/**
+	 * @brief  Report on two ports, e.g. USB and Bluetooth
+	 *
+	 * @param  port: output port
+	 * @param  mirror: second output port receiving the same messages
+	 */
+	EventReport(RawSerial &port, RawSerial &mirror);
+
+	/**
+	 * @brief  Start the writer thread
+	 *
+	 * @retval None
+	 */
+	void start(void);
+
+	/**
+	 * @brief  Queue a message
+	 *
+	 * @param  format: printf format
+	 * @retval false if the queue was full and the message dropped
+	 */
+	bool printf(const char *format, ...);
+
+	/**
+	 * @brief  Messages written, dropped and cut since start
+	 */
+	uint32_t sent(void) const { return m_sent; }
+	uint32_t dropped(void) const { return m_dropped; }
+	uint32_t truncated(void) const { return m_truncated; }
+
+private:
+	void run(void);
+
+	RawSerial *m_port;
+	RawSerial *m_mirror;
+	char m_messages[SLOTS][MESSAGE_SIZE];
+	volatile uint32_t m_queued;
+	volatile uint32_t m_sent;
+	uint32_t m_dropped;
+	uint32_t m_truncated;
+	Thread m_thread;
+	EventFlags m_flags;
+};
+
+#endif /* EVENT_REPORT_H */
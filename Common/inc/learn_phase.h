@@ -0,0 +1,138 @@
+/**
+*******************************************************************************
+* @file   learn_phase.h
+* @brief  Learning phase with early stop on convergence
+*******************************************************************************
+* Decides, window after window, how long NanoEdge AI keeps learning:
+* - every `checkEvery` windows learned, the next window is first scored
+*   with NanoEdgeAI_detect, before it is learned: the model has never seen
+*   it, so its similarity measures how well the model already knows the
+*   signal
+* - learning has converged once the last `stableChecks` scores are all at
+*   least `minSimilarity` and within `tolerance` points of each other, and
+*   at least `minWindows` windows were learned
+* - it stops at `maxWindows` otherwise
+*
+* The class only counts: the application calls NanoEdgeAI_learn and
+* NanoEdgeAI_detect itself and reports the progress, e.g. through an
+* EventReport so learning never waits for the serial ports:
+*
+*   while (!phase.done()) {
+*       fill_acc_buffer();
+*       if (phase.scoreNext()) {
+*           phase.scored(NanoEdgeAI_detect(window));
+*       }
+*       NanoEdgeAI_learn(window);
+*       phase.learned();
+*   }
+*******************************************************************************
+*/
+
+#ifndef LEARN_PHASE_H
+#define LEARN_PHASE_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/**
+ * @brief  Learning window count and convergence
+ */
+class LearnPhase
+{
+public:
+	///Scores remembered, the most `stableChecks` can ask for
+	static const uint8_t CHECKS = 8;
+
+	///Learning phase tuning
+	struct Config
+	{
+		uint16_t minWindows;   ///<Windows learned before convergence can stop learning
+		uint16_t maxWindows;   ///<Windows learned at most
+		uint8_t checkEvery;    ///<Windows learned between two scores
+		uint8_t stableChecks;  ///<Consecutive scores that must agree, at most CHECKS
+		uint8_t tolerance;     ///<Largest spread of these scores, similarity points
+		uint8_t minSimilarity; ///<Smallest of these scores, %
+	};
+
+	///Learning state
+	enum State
+	{
+		LEARNING,  ///<More windows needed
+		CONVERGED, ///<Similarity stable, stopped early
+		LIMIT      ///<maxWindows learned without convergence
+	};
+
+	/**
+	 * @brief  Create a learning phase, no window learned yet
+	 *
+	 * @param  config: tuning
+	 */
+	LearnPhase(const Config &config);
+
+	/**
+	 * @brief  Start again from no window, e.g. for another learning session
+	 *
+	 * @retval None
+	 */
+	void reset(void);
+
+	/**
+	 * @brief  The next window must be scored before it is learned
+	 */
+	bool scoreNext(void) const;
+
+	/**
+	 * @brief  Add the score of a window not learned yet
+	 *
+	 * @param  score: NanoEdgeAI_detect similarity, 0 to 100
+	 * @retval true if learning has just converged, the window is learned all the same
+	 */
+	bool scored(uint8_t score);
+
+	/**
+	 * @brief  Count a window passed to NanoEdgeAI_learn
+	 *
+	 * @retval None
+	 */
+	void learned(void);
+
+	/**
+	 * @brief  No more window to learn, converged or at maxWindows
+	 */
+	bool done(void) const { return m_state != LEARNING; }
+
+	/**
+	 * @brief  Current state
+	 */
+	State state(void) const { return m_state; }
+
+	/**
+	 * @brief  Windows learned since the last reset
+	 */
+	uint16_t windows(void) const { return m_windows; }
+
+	/**
+	 * @brief  Latest score, 0 before the first one
+	 */
+	uint8_t similarity(void) const;
+
+	/**
+	 * @brief  Spread of the latest stableChecks scores, or of all of them if fewer
+	 */
+	uint8_t spread(void) const;
+
+	/**
+	 * @brief  Progress towards maxWindows, 100 once done, %
+	 */
+	uint8_t progress(void) const;
+
+private:
+	Config m_config;
+	State m_state;
+	uint16_t m_windows;
+	uint16_t m_sinceCheck; /* Windows learned since the last score */
+	uint32_t m_checks;     /* Scores since the last reset */
+	uint8_t m_scores[CHECKS];
+};
+
+#endif /* LEARN_PHASE_H */
@@ -0,0 +1,170 @@
+/**
+*******************************************************************************
+* @file   learn_upload.h
+* @brief  Binary upload of learning windows from a host
+*******************************************************************************
+* The host sends each window as a NeaiStream frame (see neai_stream.h): raw
+* int16 counts, the accelerometer range to scale them and a CRC-16. A frame
+* with 0 samples ends the upload. Common/tools/neai_learn_upload.py is the
+* host sender.
+*
+* The firmware answers on the same port, 3 bytes per reply:
+*
+*   ACK 0x06 + sequence (little endian): every frame before sequence released
+*   NAK 0x15 + sequence: frame lost or corrupted, resend from sequence on
+*
+* Flow control: the host keeps at most SLOTS frames not acknowledged. Frames
+* are received in the RX interrupt while the main loop learns the previous
+* window, so the upload rate is only limited by the link as long as one
+* NanoEdgeAI_learn() call is shorter than one frame on the wire.
+* A frame with sequence 0 starts a new upload.
+*******************************************************************************
+*/
+
+#ifndef LEARN_UPLOAD_H
+#define LEARN_UPLOAD_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "mbed.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define LEARN_UPLOAD_ACK 0x06
+#define LEARN_UPLOAD_NAK 0x15
+
+/**
+ * @brief  Receives learning windows one byte at a time
+ * Single producer (the RX interrupt), single consumer (the main loop).
+ */
+class LearnUpload
+{
+public:
+	///Windows received ahead of the learning, frames in flight at most
+	static const uint8_t SLOTS = 2;
+
+	/**
+	 * @brief  Constructor
+	 *
+	 * @param  port: port the frames come from, replies are written to it
+	 * @param  storage: SLOTS * samples * axes values
+	 * @param  samples: samples per window, frames of another size are ignored
+	 * @param  axes: values per sample
+	 */
+	LearnUpload(RawSerial &port, int16_t *storage, uint16_t samples, uint8_t axes);
+
+	/**
+	 * @brief  Parse one received byte, from the RX interrupt
+	 * O(1) per byte, never writes to the port.
+	 *
+	 * @param  byte: received byte
+	 * @retval None
+	 */
+	void receive(uint8_t byte);
+
+	/**
+	 * @brief  Oldest received window, from the main loop
+	 * Sends the pending replies first. The window stays valid until release().
+	 *
+	 * @param  range: holds the ACC_RANGE register value of the window
+	 * @retval window [x0, y0, z0, x1, ...] in raw counts, NULL if none is pending
+	 */
+	const int16_t *window(uint8_t &range);
+
+	/**
+	 * @brief  Done with the window returned by window(), acknowledge it
+	 *
+	 * @retval None
+	 */
+	void release(void);
+
+	/**
+	 * @brief  Send the pending ACK and NAK replies, from the main loop
+	 *
+	 * @retval None
+	 */
+	void poll(void);
+
+	/**
+	 * @brief  Sleep until the RX interrupt stores a frame or queues a reply,
+	 * from the main loop when window() returned NULL
+	 * Returns at once if one came after that call.
+	 *
+	 * @retval None
+	 */
+	void wait(void);
+
+	/**
+	 * @brief  True once the end frame is reached and every window before it
+	 * has been released
+	 */
+	bool finished(void) const { return m_finished; }
+
+	/**
+	 * @brief  Windows released since the start
+	 */
+	uint32_t windows(void) const { return m_windows; }
+
+	/**
+	 * @brief  Frames rejected for a wrong CRC
+	 */
+	uint32_t errors(void) const { return m_errors; }
+
+private:
+	enum State {
+		SYNC_0,  /* Looking for the first sync byte */
+		SYNC_1,  /* First sync byte seen */
+		HEADER,  /* Version to samples */
+		PAYLOAD, /* Window values */
+		CHECK    /* CRC bytes */
+	};
+
+	struct Slot {
+		uint16_t sequence;
+		uint8_t range;
+		bool end;
+	};
+
+	static const uint8_t HEADER_SIZE = 8;
+
+	void startPayload(void);
+	void endFrame(void);
+	void nak(void);
+	void reply(uint8_t code, uint16_t sequence);
+	void wake(void);
+
+	RawSerial *m_port;
+	int16_t *m_storage;
+	uint16_t m_samples;
+	uint8_t m_axes;
+
+	/* Receiver, RX interrupt only */
+	State m_state;
+	uint8_t m_frame[HEADER_SIZE + 2];
+	uint32_t m_count;
+	uint32_t m_length;
+	uint16_t m_crc;
+	uint8_t m_low;
+	int16_t *m_write;
+	bool m_room;
+	uint16_t m_expected;
+	bool m_nakArmed;
+
+	/* Shared */
+	Slot m_slots[SLOTS];
+	volatile uint32_t m_pushed;
+	volatile uint32_t m_popped;
+	volatile uint32_t m_naks;
+	volatile uint16_t m_nakSequence;
+	volatile uint32_t m_repeats;
+	volatile uint32_t m_errors;
+	EventFlags m_flags;
+
+	/* Main loop only */
+	uint32_t m_naksSent;
+	uint32_t m_repeatsSent;
+	bool m_ackPending;
+	uint16_t m_ackSequence;
+	uint32_t m_windows;
+	bool m_finished;
+};
+
+#endif /* LEARN_UPLOAD_H */
@@ -0,0 +1,170 @@
+/**
+*******************************************************************************
+* @file   perf_stats.h
+* @brief  Timing and event counters of the acquire, learn and detect loops
+*******************************************************************************
+* Build with -DPERF_STATS to gather, in RAM:
+* - scoped timers: count, min, average, max and a log2 histogram of the time
+*   spent in sensor reads, window fills, FIFO drains, learn, detect and
+*   reporting, from the Cortex-M cycle counter (DWT) when there is one
+* - counters: bus transactions and bytes, wait loop iterations, samples
+*   dropped or read twice
+* PerfStats::dump() writes them to a serial port, the applications do it on
+* a STATS command. Without PERF_STATS, PERF_SCOPE() and PERF_COUNT() expand
+* to nothing, PERF_TIME() to its statement alone, and no RAM is used.
+*
+* Host builds (Common/host/mbed.h) time with the steady clock in ns instead,
+* so the replay benchmark reports the same statistics.
+* Updates are not atomic: a thread preempting another one in the middle of
+* an update may lose one count.
+*******************************************************************************
+*/
+
+#ifndef PERF_STATS_H
+#define PERF_STATS_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "mbed.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define PERF_BUCKETS 20 /* Histogram buckets per timer */
+#define PERF_HISTOGRAM_SHIFT 6 /* First bucket below 2^6 ticks */
+
+/**
+ * @brief  Timed code sections
+ */
+enum PerfTimer {
+	PERF_ACC_SAMPLE = 0, ///<AccAcquisition::readSample(), wait for data ready included
+	PERF_WINDOW,         ///<Whole window fill, FIFO poll waits included
+	PERF_FIFO_DRAIN,     ///<One FIFO read and decode
+	PERF_LEARN,          ///<NanoEdgeAI_learn()
+	PERF_DETECT,         ///<NanoEdgeAI_detect()
+	PERF_REPORT,         ///<Result printing or queueing
+	PERF_TIMERS
+};
+
+/**
+ * @brief  Counted events
+ */
+enum PerfCounter {
+	PERF_BUS_TRANSFERS = 0, ///<BMI160 bus transactions
+	PERF_BUS_BYTES,         ///<BMI160 payload bytes
+	PERF_SPINS,             ///<Wait loop iterations: sleeps for data ready, FIFO polls
+	PERF_DROPPED,           ///<Samples lost: FIFO found full (one per read), ring overruns, refused shared trigger events
+	PERF_DUPLICATES,        ///<Single samples equal to the previous one, read before an update
+	PERF_RESAMPLED,         ///<Samples lost inside windows put back on the nominal grid
+	PERF_COUNTERS
+};
+
+/**
+ * @brief  Statistics of one timer
+ */
+struct PerfTimerStats {
+	uint32_t count;
+	uint32_t min;   ///<Ticks, see PerfStats::clockHz()
+	uint32_t max;
+	uint64_t total;
+	///Bucket 0 below 2^PERF_HISTOGRAM_SHIFT ticks, bucket n from 2^(n - 1 + PERF_HISTOGRAM_SHIFT)
+	uint32_t histogram[PERF_BUCKETS];
+};
+
+/**
+ * @brief  Process wide timers and counters
+ */
+class PerfStats
+{
+public:
+	/**
+	 * @brief  Start the tick counter and clear the statistics
+	 *
+	 * @retval None
+	 */
+	static void start(void);
+
+	/**
+	 * @brief  Clear the statistics
+	 *
+	 * @retval None
+	 */
+	static void reset(void);
+
+	/**
+	 * @brief  Free running tick counter, wraps around
+	 */
+#if defined(MBED_HOST_H) || !defined(DWT_CTRL_CYCCNTENA_Msk)
+	static uint32_t ticks(void);
+#else
+	static uint32_t ticks(void) { return DWT->CYCCNT; }
+#endif
+
+	/**
+	 * @brief  Ticks per second: core clock, 1MHz without a cycle counter, 1GHz on a host
+	 */
+	static uint32_t clockHz(void);
+
+	/**
+	 * @brief  Add one measure to a timer
+	 *
+	 * @param  timer: timer to update
+	 * @param  ticks: measured duration
+	 * @retval None
+	 */
+	static void record(PerfTimer timer, uint32_t ticks);
+
+	/**
+	 * @brief  Add to a counter
+	 *
+	 * @param  counter: counter to update
+	 * @param  n: events to add
+	 * @retval None
+	 */
+	static void count(PerfCounter counter, uint32_t n) { s_counters[counter] += n; }
+
+	/**
+	 * @brief  Statistics gathered since the last reset()
+	 */
+	static const PerfTimerStats &timer(PerfTimer timer) { return s_timers[timer]; }
+	static uint32_t counter(PerfCounter counter) { return s_counters[counter]; }
+
+	/**
+	 * @brief  Write the statistics, one line per timer and a line of counters
+	 * Times in us. Blocks until written, the time it takes is not measured.
+	 *
+	 * @param  port: output port
+	 * @retval None
+	 */
+	static void dump(RawSerial &port);
+
+private:
+	static PerfTimerStats s_timers[PERF_TIMERS];
+	static uint32_t s_counters[PERF_COUNTERS];
+};
+
+/**
+ * @brief  Times its own scope into a timer
+ */
+class PerfScope
+{
+public:
+	PerfScope(PerfTimer timer) : m_timer(timer), m_start(PerfStats::ticks()) {}
+	~PerfScope() { PerfStats::record(m_timer, PerfStats::ticks() - m_start); }
+
+private:
+	PerfTimer m_timer;
+	uint32_t m_start;
+};
+
+/* Instrumentation points, compiled out without PERF_STATS */
+#ifdef PERF_STATS
+#define PERF_CONCAT_(a, b) a##b
+#define PERF_CONCAT(a, b) PERF_CONCAT_(a, b)
+#define PERF_SCOPE(timer) PerfScope PERF_CONCAT(perf_scope_, __LINE__)(timer)
+#define PERF_COUNT(counter, n) PerfStats::count(counter, n)
+#define PERF_TIME(timer, ...) do { PerfScope perf_scope(timer); __VA_ARGS__; } while (0)
+#else
+#define PERF_SCOPE(timer) ((void)0)
+#define PERF_COUNT(counter, n) ((void)0)
+#define PERF_TIME(timer, ...) do { __VA_ARGS__; } while (0)
+#endif
+
+#endif /* PERF_STATS_H */
@@ -0,0 +1,135 @@
+/**
+*******************************************************************************
+* @file   sample_clock.h
+* @brief  Sample timestamps from the BMI160 sensor time
+*******************************************************************************
+* The BMI160 takes a sample each time the sensor time bit of the sample
+* period toggles, so samples sit on an exact grid of the sensor clock, free of
+* the MCU timing. After each FIFO drain, one burst reads the sensor time and
+* the frames still in the FIFO (BMI160::getSensorTimeAndFifoLength): the
+* newest frame is on the last grid point, the last frame drained is as many
+* periods before it as there are frames left. From these stamps SampleClock
+* works out, for a window of the latest samples:
+* - the sensor time of its first and last samples
+* - its effective sample rate, below the nominal one when samples are missing
+* - its gaps: samples lost by the FIFO (overflow, discarded data) inside it
+* - its jitter: standard deviation of the intervals between its samples
+* A window with gaps can then be resampled onto the nominal grid, so the model
+* always sees the same sample spacing whatever the firmware timing.
+*
+* A run of consecutive samples costs one stamp, a new one is kept after each
+* gap only: the last SAMPLE_CLOCK_RUNS runs are known, a window starting in an
+* older one has no valid timing.
+*******************************************************************************
+*/
+
+#ifndef SAMPLE_CLOCK_H
+#define SAMPLE_CLOCK_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "acc_sample.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define SAMPLE_CLOCK_RUNS 8 /* Runs of consecutive samples remembered */
+#define SAMPLE_CLOCK_GAPS 4 /* Gaps listed per window */
+
+/**
+ * @brief  Timing of one window, times in sensor time ticks (BMI160::SENSOR_TIME_HZ)
+ */
+struct WindowTiming {
+	bool valid;        ///<false if the window started before the known runs
+	uint32_t first;    ///<Sensor time of the first sample, unwrapped to 32 bits
+	uint32_t last;     ///<Sensor time of the last sample
+	uint32_t period;   ///<Nominal sample period
+	float odr;         ///<Effective sample rate, Hz
+	float jitter;      ///<Standard deviation of the sample intervals, us
+	uint32_t missing;  ///<Samples lost inside the window
+	uint8_t gaps;      ///<Gaps inside the window, at most SAMPLE_CLOCK_GAPS listed
+	uint16_t gapAt[SAMPLE_CLOCK_GAPS];     ///<Window sample right after each gap
+	uint16_t gapLength[SAMPLE_CLOCK_GAPS]; ///<Samples lost in each gap
+};
+
+/**
+ * @brief  Sensor time stamps of a stream of FIFO samples
+ */
+class SampleClock
+{
+public:
+	/**
+	 * @brief  Create a clock without any stamp
+	 *
+	 * @param  period: FIFO frame period, ticks (BMI160::getFifoFramePeriod)
+	 */
+	SampleClock(uint32_t period);
+
+	/**
+	 * @brief  Forget the stamps and restart the sample count, after a FIFO flush
+	 *
+	 * @retval None
+	 */
+	void reset(void);
+
+	/**
+	 * @brief  Stamp the frames of one FIFO drain
+	 *
+	 * @param  frames: frames just drained
+	 * @param  time: raw sensor time read after the drain
+	 * @param  pending: frames still in the FIFO at that time
+	 * @retval None
+	 */
+	void addFrames(uint16_t frames, uint32_t time, uint16_t pending);
+
+	/**
+	 * @brief  Samples stamped since the last reset()
+	 */
+	uint32_t samples(void) const { return m_samples; }
+
+	/**
+	 * @brief  Nominal sample period, ticks
+	 */
+	uint32_t period(void) const { return m_period; }
+
+	/**
+	 * @brief  Timing of the window made of the latest samples
+	 *
+	 * @param  samples: samples in the window, ending with the last one stamped
+	 * @param  timing: holds the timing, timing.valid set as the return value
+	 * @retval true if the timing is known
+	 */
+	bool window(uint16_t samples, WindowTiming &timing) const;
+
+	/**
+	 * @brief  Resample a window with gaps onto the nominal grid, in place
+	 * The grid ends on the last sample and goes back one nominal period per
+	 * sample, each value is interpolated linearly between the two samples
+	 * around it. The oldest samples, before the grid, are dropped.
+	 *
+	 * @param  timing: timing of the window
+	 * @param  window: samples * axes values, oldest sample first
+	 * @param  samples: samples in the window
+	 * @param  axes: values per sample
+	 * @retval true if the window was changed, false if it has no gap, or
+	 *         more than SAMPLE_CLOCK_GAPS, or no valid timing
+	 */
+	static bool resample(const WindowTiming &timing, acc_sample_t *window, uint16_t samples, uint8_t axes);
+
+private:
+	/* First sample of a run of consecutive samples */
+	struct Run {
+		uint32_t sample; /* Index since reset() */
+		uint32_t time;   /* Sensor time, unwrapped */
+		uint16_t lost;   /* Samples lost right before it */
+	};
+
+	const Run &run(uint32_t n) const { return m_runs[n % SAMPLE_CLOCK_RUNS]; }
+	void addRun(uint32_t time, uint16_t lost);
+
+	uint32_t m_period;
+	uint32_t m_samples;
+	uint32_t m_count;   /* Runs since reset() */
+	uint32_t m_raw;     /* Last raw sensor time, 24 bits */
+	uint32_t m_time;    /* Same, unwrapped */
+	Run m_runs[SAMPLE_CLOCK_RUNS];
+};
+
+#endif /* SAMPLE_CLOCK_H */
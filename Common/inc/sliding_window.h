@@ -0,0 +1,95 @@
+/**
+*******************************************************************************
+* @file   sliding_window.h
+* @brief  Overlapping windows over a continuous sample stream
+*******************************************************************************
+* A new window is due every `hop` samples instead of every `samples` samples,
+* so detection latency drops from one window to one hop.
+*
+* Every sample is stored twice, at its slot and one window further, so the
+* latest window is always contiguous in [x0, y0, z0, x1, ...] order and can be
+* handed to NanoEdgeAI_learn/detect as is. Sliding costs two writes per new
+* sample, the window itself is never copied.
+*******************************************************************************
+*/
+
+#ifndef SLIDING_WINDOW_H
+#define SLIDING_WINDOW_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "acc_sample.h"
+
+/* Defines -------------------------------------------------------------------*/
+/**
+ * @brief  Fail the build unless a window is a whole number of hops
+ */
+#define SLIDING_HOP_CHECK(WindowT, hop) \
+	static_assert(((hop) > 0) && ((hop) <= WindowT::SAMPLES) && ((WindowT::SAMPLES % (hop)) == 0), \
+	              "NEAI_HOP must be 1 to SAMPLES and divide SAMPLES")
+
+/**
+ * @brief  Mirrored circular sample store
+ */
+class SlidingWindow
+{
+public:
+	/**
+	 * @brief  Create a sliding window over caller provided storage
+	 *
+	 * @param  storage: 2 * samples * axes values
+	 * @param  samples: samples per window
+	 * @param  axes: values per sample
+	 * @param  hop: new samples between two windows, 1 to samples
+	 */
+	SlidingWindow(acc_sample_t *storage, uint16_t samples, uint8_t axes, uint16_t hop);
+
+	/**
+	 * @brief  Forget the stored samples, the next window needs a full window
+	 *
+	 * @retval None
+	 */
+	void reset(void);
+
+	/**
+	 * @brief  Where the next samples go
+	 *
+	 * @param  room: samples that can be written contiguously before the
+	 *         next window is due
+	 * @retval Write position
+	 */
+	acc_sample_t *writeBuffer(uint16_t &room);
+
+	/**
+	 * @brief  Samples written at the write position
+	 *
+	 * @param  samples: number of samples written, at most room
+	 * @retval true if a new window is due
+	 */
+	bool commitSamples(uint16_t samples);
+
+	/**
+	 * @brief  Copy samples in
+	 * Stops early once a window is due, the remaining samples are not used.
+	 *
+	 * @param  data: samples in [x0, y0, z0, x1, ...] order
+	 * @param  samples: number of samples
+	 * @retval true if a new window is due
+	 */
+	bool push(const acc_sample_t *data, uint16_t samples);
+
+	/**
+	 * @brief  Latest window, oldest sample first
+	 * Valid until the next write.
+	 */
+	acc_sample_t *window(void) { return &m_storage[m_head * m_axes]; }
+
+private:
+	acc_sample_t *m_storage;
+	uint16_t m_samples;
+	uint8_t m_axes;
+	uint16_t m_hop;
+	uint16_t m_head;
+	uint16_t m_remaining;
+};
+
+#endif /* SLIDING_WINDOW_H */
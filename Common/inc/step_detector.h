@@ -0,0 +1,110 @@
+/**
+*******************************************************************************
+* @file   step_detector.h
+* @brief  Streaming step counter, O(1) per sample
+*******************************************************************************
+* Samples are averaged by `decimation` (step content is below 5Hz), then:
+* - per axis running min/max over the last WINDOW decimated samples, kept
+*   with monotonic deques (amortized O(1) per sample)
+* - the axis with the largest range is the dominant one
+* - adaptive threshold at the middle of its range, with a hysteresis band
+*   of `hysteresis` * range
+* - a step is a rising crossing of the band, at least `minInterval`
+*   decimated samples after the previous one, while the range is at least
+*   `minRange` g
+*
+* Every step of a window is counted, not one per window.
+*******************************************************************************
+*/
+
+#ifndef STEP_DETECTOR_H
+#define STEP_DETECTOR_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "acc_sample.h"
+
+/**
+ * @brief  Incremental step detector
+ */
+class StepDetector
+{
+public:
+	///Decimated samples in the min/max window
+	static const uint16_t WINDOW = 128;
+
+	///Detector tuning
+	struct Config
+	{
+		uint8_t decimation;   ///<Input samples averaged per decimated sample
+		uint16_t minInterval; ///<Minimum decimated samples between two steps
+		float minRange;       ///<Minimum dominant axis range, g
+		float hysteresis;     ///<Half width of the threshold band, fraction of range
+	};
+
+	///100Hz after decimation, up to 4 steps/s, 0.15g swing, 20% band
+	static const Config DEFAULT_CONFIG;
+
+	/**
+	 * @brief  Create a detector
+	 *
+	 * @param  config: tuning, decimation from the input rate to ~100Hz
+	 */
+	StepDetector(const Config &config);
+
+	/**
+	 * @brief  Forget the history and the step count
+	 *
+	 * @retval None
+	 */
+	void reset(void);
+
+	/**
+	 * @brief  Add one input sample
+	 *
+	 * @param  x, y, z: acceleration in g
+	 * @retval true if a step ended on this sample
+	 */
+	bool addSample(float x, float y, float z);
+
+	/**
+	 * @brief  Add a block of input samples
+	 *
+	 * @param  xyz: samples [x0, y0, z0, x1, ...]
+	 * @param  samples: number of samples
+	 * @param  scale: g per LSB, for raw int16 samples
+	 * @retval Steps counted in the block
+	 */
+	uint16_t addSamples(const acc_sample_t *xyz, uint16_t samples, float scale);
+
+	/**
+	 * @brief  Steps counted since the last reset
+	 */
+	uint32_t steps(void) const { return m_steps; }
+
+private:
+	/* Indices of decimated samples, monotonic values, front is the extremum */
+	struct Deque
+	{
+		uint16_t index[WINDOW];
+		uint16_t front;
+		uint16_t count;
+	};
+
+	void push(Deque &deque, const float *history, bool isMax);
+	void expire(Deque &deque);
+	bool detect(void);
+
+	Config m_config;
+	float m_history[3][WINDOW];
+	Deque m_max[3];
+	Deque m_min[3];
+	float m_sum[3];
+	uint8_t m_summed;
+	uint16_t m_index;
+	uint16_t m_filled;
+	uint16_t m_sinceStep;
+	bool m_armed;
+	uint32_t m_steps;
+};
+
+#endif /* STEP_DETECTOR_H */
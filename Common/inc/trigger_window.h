@@ -0,0 +1,112 @@
+/**
+*******************************************************************************
+* @file   trigger_window.h
+* @brief  Window around an event from a continuously filled ring
+*******************************************************************************
+* Samples stream into a ring of samples + slack slots, stored twice like
+* SlidingWindow so that any window of the ring is contiguous. Once an event
+* sample is flagged with trigger(), the ring keeps `samples - preTrigger`
+* samples from the event on and stops: window() then holds preTrigger
+* samples before the event, the event and the samples after it, in place.
+*
+* slack bounds the samples written between two trigger checks, it must be
+* at least the largest burst read at once.
+*******************************************************************************
+*/
+
+#ifndef TRIGGER_WINDOW_H
+#define TRIGGER_WINDOW_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "acc_sample.h"
+
+/**
+ * @brief  Pre-trigger capture ring
+ */
+class TriggerWindow
+{
+public:
+	/**
+	 * @brief  Create a trigger window over caller provided storage
+	 *
+	 * @param  storage: 2 * (samples + slack) * axes values
+	 * @param  samples: samples per window
+	 * @param  slack: samples written at most between two trigger checks
+	 * @param  axes: values per sample
+	 * @param  preTrigger: samples before the event in the window, below samples
+	 */
+	TriggerWindow(acc_sample_t *storage, uint16_t samples, uint16_t slack, uint8_t axes,
+	              uint16_t preTrigger);
+
+	/**
+	 * @brief  Forget the stored samples and the event
+	 *
+	 * @retval None
+	 */
+	void reset(void);
+
+	/**
+	 * @brief  Where the next samples go
+	 *
+	 * @param  room: samples that can be written contiguously, 0 once the
+	 *         window is ready
+	 * @retval Write position
+	 */
+	acc_sample_t *writeBuffer(uint16_t &room);
+
+	/**
+	 * @brief  Samples written at the write position
+	 *
+	 * @param  samples: number of samples written, at most room
+	 * @retval true if the window is ready
+	 */
+	bool commitSamples(uint16_t samples);
+
+	/**
+	 * @brief  Flag an event, or move it before the window is ready
+	 *
+	 * @param  age: event position, 0 for the latest committed sample
+	 * @retval false if fewer than preTrigger samples precede it
+	 */
+	bool trigger(uint16_t age);
+
+	/**
+	 * @brief  Stored sample
+	 *
+	 * @param  age: 0 for the latest committed sample
+	 */
+	const acc_sample_t *sample(uint16_t age) const
+	{
+		return &m_storage[((m_head + m_capacity - 1 - age) % m_capacity) * m_axes];
+	}
+
+	/**
+	 * @brief  Position of the event, 0 for the latest committed sample
+	 */
+	uint16_t eventAge(void) const { return (m_head + m_capacity - 1 - m_event) % m_capacity; }
+
+	bool triggered(void) const { return m_triggered; }
+	bool ready(void) const { return m_triggered && m_pending == 0; }
+
+	/**
+	 * @brief  Window around the event, oldest sample first
+	 * Valid once ready, until the next reset.
+	 */
+	acc_sample_t *window(void) { return &m_storage[m_start * m_axes]; }
+
+private:
+	acc_sample_t *m_storage;
+	uint16_t m_samples;
+	uint16_t m_slack;
+	uint16_t m_capacity;
+	uint8_t m_axes;
+	uint16_t m_preTrigger;
+	uint16_t m_head;
+	uint16_t m_count;
+	bool m_triggered;
+	uint16_t m_event;
+	uint16_t m_start;
+	uint16_t m_pending;
+};
+
+#endif /* TRIGGER_WINDOW_H */
@@ -0,0 +1,166 @@
+/**
+*******************************************************************************
+* @file   window.h
+* @brief  Compile-time sized sample windows
+*******************************************************************************
+* The window size of an application is set once, as a type:
+*
+*   typedef Window<256, 3> AccWindow;
+*
+* Buffers, rings and loops are then sized from AccWindow::SAMPLES,
+* AccWindow::AXES and AccWindow::VALUES, in the data logging and library
+* modes alike. In the library modes NEAI_WINDOW_CHECK(AccWindow) stops the
+* build when the window differs from the DATA_INPUT_USER and AXIS_NUMBER
+* the NanoEdge AI library was generated for (NanoEdgeAI.h).
+*
+* The copy and conversion kernels are unrolled at compile time over blocks
+* of WINDOW_UNROLL samples, all axes included, with a loop over the blocks.
+* Build with -DWINDOW_UNROLL=<samples per window> for fully unrolled
+* kernels, at the cost of one store per value in flash.
+*******************************************************************************
+*/
+
+#ifndef WINDOW_H
+#define WINDOW_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "acc_sample.h"
+
+/* Defines -------------------------------------------------------------------*/
+#ifndef WINDOW_UNROLL
+#define WINDOW_UNROLL 8 /* Samples per unrolled kernel block */
+#endif
+
+/**
+ * @brief  Fail the build if a window differs from the NanoEdge AI library
+ * Use after including NanoEdgeAI.h.
+ */
+#define NEAI_WINDOW_CHECK(WindowT) \
+	static_assert((WindowT::SAMPLES == DATA_INPUT_USER) && (WindowT::AXES == AXIS_NUMBER), \
+	              "window size differs from DATA_INPUT_USER/AXIS_NUMBER of NanoEdgeAI.h")
+
+/**
+ * @brief  Kernels on N consecutive values, unrolled at compile time
+ * Blocks are split in halves down to single values, the template recursion
+ * stays log2(N) deep.
+ */
+template <uint32_t N>
+struct WindowBlock {
+	template <typename DstT, typename SrcT>
+	static inline void copy(DstT *dst, const SrcT *src)
+	{
+		WindowBlock<N / 2>::copy(dst, src);
+		WindowBlock<N - N / 2>::copy(dst + N / 2, src + N / 2);
+	}
+
+	template <typename SrcT>
+	static inline void toG(float *dst, const SrcT *src, float scale)
+	{
+		WindowBlock<N / 2>::toG(dst, src, scale);
+		WindowBlock<N - N / 2>::toG(dst + N / 2, src + N / 2, scale);
+	}
+};
+
+template <>
+struct WindowBlock<1> {
+	template <typename DstT, typename SrcT>
+	static inline void copy(DstT *dst, const SrcT *src)
+	{
+		*dst = *src;
+	}
+
+	template <typename SrcT>
+	static inline void toG(float *dst, const SrcT *src, float scale)
+	{
+		*dst = acc_sample_to_g(*src, scale);
+	}
+};
+
+template <>
+struct WindowBlock<0> {
+	template <typename DstT, typename SrcT>
+	static inline void copy(DstT *dst, const SrcT *src)
+	{
+		(void)dst;
+		(void)src;
+	}
+
+	template <typename SrcT>
+	static inline void toG(float *dst, const SrcT *src, float scale)
+	{
+		(void)dst;
+		(void)src;
+		(void)scale;
+	}
+};
+
+/**
+ * @brief  Window of Samples samples of Axes values, [x0, y0, z0, x1, ...]
+ */
+template <uint16_t Samples, uint8_t Axes, typename SampleT = acc_sample_t>
+struct Window {
+	static_assert((Samples > 0) && (Axes > 0), "empty window");
+
+	typedef SampleT Sample;
+	static constexpr uint16_t SAMPLES = Samples;
+	static constexpr uint8_t AXES = Axes;
+	static constexpr uint32_t VALUES = (uint32_t)Samples * Axes;
+
+	/**
+	 * @brief  Window of the same size holding another sample type
+	 */
+	template <typename OtherT>
+	using Of = Window<Samples, Axes, OtherT>;
+
+	SampleT values[VALUES];
+
+	/**
+	 * @brief  Values of one sample
+	 */
+	SampleT *sample(uint16_t index) { return &values[index * Axes]; }
+	const SampleT *sample(uint16_t index) const { return &values[index * Axes]; }
+
+	/**
+	 * @brief  Copy a whole window
+	 *
+	 * @param  dst: VALUES values
+	 * @param  src: VALUES values, not overlapping dst
+	 * @retval None
+	 */
+	static void copy(SampleT *dst, const SampleT *src)
+	{
+		for (uint16_t block = 0; block < Samples / WINDOW_UNROLL; block++) {
+			WindowBlock<WINDOW_UNROLL * Axes>::copy(dst, src);
+			dst += WINDOW_UNROLL * Axes;
+			src += WINDOW_UNROLL * Axes;
+		}
+		WindowBlock<(Samples % WINDOW_UNROLL) * Axes>::copy(dst, src);
+	}
+
+	/**
+	 * @brief  Convert a whole window to g, the float layout NanoEdge AI expects
+	 *
+	 * @param  dst: VALUES floats
+	 * @param  src: VALUES stored samples
+	 * @param  scale: g per LSB, for int16 samples
+	 * @retval None
+	 */
+	static void toG(float *dst, const SampleT *src, float scale)
+	{
+		for (uint16_t block = 0; block < Samples / WINDOW_UNROLL; block++) {
+			WindowBlock<WINDOW_UNROLL * Axes>::toG(dst, src, scale);
+			dst += WINDOW_UNROLL * Axes;
+			src += WINDOW_UNROLL * Axes;
+		}
+		WindowBlock<(Samples % WINDOW_UNROLL) * Axes>::toG(dst, src, scale);
+	}
+};
+
+template <uint16_t Samples, uint8_t Axes, typename SampleT>
+constexpr uint16_t Window<Samples, Axes, SampleT>::SAMPLES;
+template <uint16_t Samples, uint8_t Axes, typename SampleT>
+constexpr uint8_t Window<Samples, Axes, SampleT>::AXES;
+template <uint16_t Samples, uint8_t Axes, typename SampleT>
+constexpr uint32_t Window<Samples, Axes, SampleT>::VALUES;
+
+#endif /* WINDOW_H */
@@ -0,0 +1,117 @@
+/**
+*******************************************************************************
+* @file   window_ring.h
+* @brief  N-slot ring of sample windows shared by a producer and a consumer
+*******************************************************************************
+* The producer (acquisition thread) fills one slot while the consumer (main
+* loop) scores or logs a previously completed one. Each slot holds a window
+* in the [x0, y0, z0, x1, y1, z1, ...] layout NanoEdgeAI_learn/detect expects.
+*
+* Single producer and single consumer, no lock: each side only writes its own
+* counter. When every slot holds an unread window the producer has nowhere to
+* write and the incoming samples are counted as dropped.
+*******************************************************************************
+*/
+
+#ifndef WINDOW_RING_H
+#define WINDOW_RING_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "mbed.h"
+#include "acc_sample.h"
+
+/**
+ * @brief  Ring of sample windows
+ */
+class WindowRing
+{
+public:
+	/**
+	 * @brief  Create a ring over caller provided storage
+	 *
+	 * @param  storage: slots * samples * axes values
+	 * @param  slots: number of windows, 2 for ping-pong
+	 * @param  samples: samples per window
+	 * @param  axes: values per sample
+	 */
+	WindowRing(acc_sample_t *storage, uint8_t slots, uint16_t samples, uint8_t axes);
+
+	/**
+	 * @brief  Producer: where the next samples go
+	 *
+	 * @param  room: samples left in the slot being filled
+	 * @retval Write position, NULL if every slot holds an unread window
+	 */
+	acc_sample_t *writeBuffer(uint16_t &room);
+
+	/**
+	 * @brief  Producer: samples written at the write position
+	 * The slot is handed to the consumer once it is full.
+	 *
+	 * @param  samples: number of samples written
+	 * @retval true if a window was completed
+	 */
+	bool commitSamples(uint16_t samples);
+
+	/**
+	 * @brief  Producer: samples discarded because the ring was full
+	 * Nothing is counted for 0 samples.
+	 *
+	 * @param  samples: number of samples discarded
+	 * @retval None
+	 */
+	void dropSamples(uint32_t samples);
+
+	/**
+	 * @brief  Consumer: oldest complete window
+	 *
+	 * @retval Window, NULL if none is ready
+	 */
+	acc_sample_t *readBuffer(void);
+
+	/**
+	 * @brief  Consumer: give the window returned by readBuffer back
+	 *
+	 * @retval None
+	 */
+	void release(void);
+
+	/**
+	 * @brief  Number of windows the ring holds
+	 */
+	uint8_t slots(void) const { return m_slots; }
+
+	/**
+	 * @brief  Samples per window
+	 */
+	uint16_t samples(void) const { return m_samples; }
+
+	/**
+	 * @brief  Number of completed windows
+	 */
+	uint32_t windows(void) const { return m_written; }
+
+	/**
+	 * @brief  Number of times the producer found the ring full
+	 */
+	uint32_t overruns(void) const { return m_overruns; }
+
+	/**
+	 * @brief  Number of samples discarded because the ring was full
+	 */
+	uint32_t droppedSamples(void) const { return m_dropped; }
+
+private:
+	acc_sample_t *m_storage;
+	uint8_t m_slots;
+	uint16_t m_samples;
+	uint8_t m_axes;
+	uint16_t m_fill;
+	bool m_dropping;
+	volatile uint32_t m_written;
+	volatile uint32_t m_released;
+	volatile uint32_t m_overruns;
+	volatile uint32_t m_dropped;
+};
+
+#endif /* WINDOW_RING_H */
@@ -0,0 +1,299 @@
+/**
+*******************************************************************************
+* @file   acc_acquisition.cpp
+* @brief  Accelerometer acquisition shared by the applications
+*******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "acc_acquisition.h"
+#include <math.h>
+#include <string.h>
+
+/* Functions definition ------------------------------------------------------*/
+AccAcquisition::AccAcquisition(BMI160 &imu, InterruptIn &irq)
+: m_imu(imu), m_irq(irq), m_range(BMI160::SENS_2G), m_gyroRange(BMI160::DPS_2000), m_axes(3),
+  m_dataReady(false), m_motion(false), m_clock(NULL)
+{
+#ifdef PERF_STATS
+	m_lastRaw[0] = m_lastRaw[1] = m_lastRaw[2] = 0;
+#endif
+}
+
+int32_t AccAcquisition::start(BMI160::AccRange range, BMI160::InterruptPin pin)
+{
+	int32_t rtnVal;
+	m_range = range;
+	/* Data ready interrupt, one pulse per new sample */
+	rtnVal = m_imu.setInterruptPinConfig(pin, BMI160::DEFAULT_INT_PIN_CONFIG);
+	if (rtnVal == BMI160::RTN_NO_ERROR) {
+		rtnVal = m_imu.setInterruptLatch(BMI160::INT_NON_LATCHED);
+	}
+	if (rtnVal == BMI160::RTN_NO_ERROR) {
+		rtnVal = m_imu.enableDataInterrupt(BMI160::DRDY_INT, pin);
+	}
+	m_irq.rise(callback(this, &AccAcquisition::dataReadyIsr));
+	return rtnVal;
+}
+
+int32_t AccAcquisition::startMotion(BMI160::AccRange range, BMI160::InterruptPin pin,
+                                    const BMI160::AnyMotionConfig &anyMotion, const BMI160::HighGConfig &highG)
+{
+	int32_t rtnVal;
+	m_range = range;
+	m_motion = false;
+	/* One pulse per shock instead of one per sample */
+	rtnVal = m_imu.disableDataInterrupt(BMI160::DRDY_INT);
+	if (rtnVal == BMI160::RTN_NO_ERROR) {
+		rtnVal = m_imu.setInterruptPinConfig(pin, BMI160::DEFAULT_INT_PIN_CONFIG);
+	}
+	if (rtnVal == BMI160::RTN_NO_ERROR) {
+		rtnVal = m_imu.setInterruptLatch(BMI160::INT_NON_LATCHED);
+	}
+	if (rtnVal == BMI160::RTN_NO_ERROR) {
+		rtnVal = m_imu.setAnyMotionConfig(anyMotion, range);
+	}
+	if (rtnVal == BMI160::RTN_NO_ERROR) {
+		rtnVal = m_imu.setHighGConfig(highG, range);
+	}
+	if (rtnVal == BMI160::RTN_NO_ERROR) {
+		rtnVal = m_imu.enableMotionInterrupt(BMI160::ANY_MOTION_INT, pin);
+	}
+	if (rtnVal == BMI160::RTN_NO_ERROR) {
+		rtnVal = m_imu.enableMotionInterrupt(BMI160::HIGH_G_INT, pin);
+	}
+	m_irq.rise(callback(this, &AccAcquisition::motionIsr));
+	return rtnVal;
+}
+
+bool AccAcquisition::windowTiming(uint16_t samples, WindowTiming &timing) const
+{
+	if (m_clock == NULL) {
+		memset(&timing, 0, sizeof(timing));
+		return false;
+	}
+	return m_clock->window(samples, timing);
+}
+
+int32_t AccAcquisition::flushFifo()
+{
+	if (m_clock != NULL) {
+		m_clock->reset();
+	}
+	return m_imu.flushFifo();
+}
+
+int32_t AccAcquisition::readSample(BMI160::SensorData &data)
+{
+	PERF_SCOPE(PERF_ACC_SAMPLE);
+	waitDataReady();
+	int32_t rtnVal = m_imu.getSensorXYZ(data, m_range);
+#ifdef PERF_STATS
+	/* Noise changes at least one axis between two real samples */
+	if ((data.xAxis.raw == m_lastRaw[0]) && (data.yAxis.raw == m_lastRaw[1]) && (data.zAxis.raw == m_lastRaw[2])) {
+		PERF_COUNT(PERF_DUPLICATES, 1);
+	}
+	m_lastRaw[0] = data.xAxis.raw;
+	m_lastRaw[1] = data.yAxis.raw;
+	m_lastRaw[2] = data.zAxis.raw;
+#endif
+	return rtnVal;
+}
+
+int32_t AccAcquisition::readSample(BMI160::SensorData &acc, BMI160::SensorData &gyro, BMI160::SensorTime &time)
+{
+	PERF_SCOPE(PERF_ACC_SAMPLE);
+	waitDataReady();
+	/* DATA_8 to SENSORTIME_2: both sensors and the time in one transfer */
+	return m_imu.getGyroAccXYZandSensorTime(acc, gyro, time, m_range, m_gyroRange);
+}
+
+int32_t AccAcquisition::fillWindow(float *buffer, uint16_t samples)
+{
+	PERF_SCOPE(PERF_WINDOW);
+	/* FIFO method: drain whole bursts of samples straight into the buffer */
+	uint16_t filled = 0;
+	uint16_t frames = 0;
+	int32_t rtnVal = flushFifo();
+	while (rtnVal == BMI160::RTN_NO_ERROR && filled < samples) {
+		PERF_COUNT(PERF_SPINS, 1);
+		wait_ms(FIFO_POLL_MS);
+		rtnVal = drainFifo(&buffer[m_axes * filled], samples - filled, frames);
+		filled += frames;
+	}
+	return rtnVal;
+}
+
+int32_t AccAcquisition::slideWindow(SlidingWindow &window)
+{
+	PERF_SCOPE(PERF_WINDOW);
+	uint16_t room = 0;
+	uint16_t frames = 0;
+	bool due = false;
+	int32_t rtnVal = BMI160::RTN_NO_ERROR;
+	while (rtnVal == BMI160::RTN_NO_ERROR && !due) {
+		acc_sample_t *buffer = window.writeBuffer(room);
+		rtnVal = drainFifo(buffer, room, frames);
+		due = window.commitSamples(frames);
+		if (frames < room) {
+			PERF_COUNT(PERF_SPINS, 1);
+			wait_ms(FIFO_POLL_MS);
+		}
+	}
+	return rtnVal;
+}
+
+int32_t AccAcquisition::armTrigger(TriggerWindow &ring)
+{
+	ring.reset();
+	return flushFifo();
+}
+
+int32_t AccAcquisition::pollTrigger(TriggerWindow &ring, float threshold)
+{
+	uint16_t room = 0;
+	uint16_t frames = 0;
+	acc_sample_t *buffer = ring.writeBuffer(room);
+	if (room == 0) {
+		return BMI160::RTN_NO_ERROR;
+	}
+	int32_t rtnVal = drainFifo(buffer, room, frames);
+	if (rtnVal != BMI160::RTN_NO_ERROR || frames == 0) {
+		return rtnVal;
+	}
+	bool armed = !ring.triggered();
+	ring.commitSamples(frames);
+	/* Only the new samples are checked, room is at most the ring slack.
+	 * A sample without preTrigger samples before it is refused, the next one
+	 * over the threshold is tried instead */
+	for (uint16_t i = 0; armed && i < frames; i++) {
+		if (sampleLevel(&buffer[m_axes * i]) >= threshold && ring.trigger(frames - 1 - i)) {
+			armed = false;
+		}
+	}
+	return rtnVal;
+}
+
+int32_t AccAcquisition::waitTrigger(TriggerWindow &ring, float threshold)
+{
+	PERF_SCOPE(PERF_WINDOW);
+	int32_t rtnVal = armTrigger(ring);
+	while (rtnVal == BMI160::RTN_NO_ERROR && !ring.ready()) {
+		PERF_COUNT(PERF_SPINS, 1);
+		wait_ms(FIFO_POLL_MS);
+		rtnVal = pollTrigger(ring, threshold);
+	}
+	return rtnVal;
+}
+
+int32_t AccAcquisition::pollTriggers(AccAcquisition &first, TriggerWindow &firstRing,
+                                     AccAcquisition &second, TriggerWindow &secondRing, float threshold)
+{
+	bool armed = !firstRing.triggered() && !secondRing.triggered();
+	int32_t rtnVal = first.pollTrigger(firstRing, threshold);
+	if (rtnVal == BMI160::RTN_NO_ERROR) {
+		rtnVal = second.pollTrigger(secondRing, threshold);
+	}
+	if (rtnVal != BMI160::RTN_NO_ERROR || !armed) {
+		return rtnVal;
+	}
+	if (!firstRing.triggered() && !secondRing.triggered()) {
+		return rtnVal;
+	}
+	/* Both FIFOs were just drained: the same age is about the same instant */
+	uint16_t age = firstRing.triggered() ? firstRing.eventAge() : 0;
+	if (secondRing.triggered() && secondRing.eventAge() > age) {
+		age = secondRing.eventAge();
+	}
+	/* The second ring only moves once the first took the event */
+	if (!firstRing.trigger(age) || !secondRing.trigger(age)) {
+		/* A ring lacks the samples before the event: both wait for the next one */
+		PERF_COUNT(PERF_DROPPED, 1);
+		firstRing.reset();
+		secondRing.reset();
+	}
+	return rtnVal;
+}
+
+float AccAcquisition::triggerLevel(const TriggerWindow &ring) const
+{
+	return sampleLevel(ring.sample(ring.eventAge()));
+}
+
+int32_t AccAcquisition::stampFifo(BMI160 &imu, SampleClock &clock, uint16_t numFrames, uint8_t frameSize)
+{
+	BMI160::SensorTime time;
+	uint16_t length = 0;
+	if (numFrames == 0) {
+		return BMI160::RTN_NO_ERROR;
+	}
+	/* Frames written since the drain are counted in length, at the time read */
+	int32_t rtnVal = imu.getSensorTimeAndFifoLength(time, length);
+	if (rtnVal == BMI160::RTN_NO_ERROR) {
+		clock.addFrames(numFrames, time.raw, length / frameSize);
+	}
+	return rtnVal;
+}
+
+int32_t AccAcquisition::stamp(uint16_t numFrames)
+{
+	if (m_clock == NULL) {
+		return BMI160::RTN_NO_ERROR;
+	}
+	return stampFifo(m_imu, *m_clock, numFrames,
+	                 (m_axes == 6) ? BMI160::FIFO_GYRO_ACC_FRAME_SIZE : BMI160::FIFO_ACC_FRAME_SIZE);
+}
+
+int32_t AccAcquisition::drainFifo(float *buffer, uint16_t maxFrames, uint16_t &numFrames)
+{
+	int32_t rtnVal = (m_axes == 6) ? readFifo(m_imu, buffer, maxFrames, numFrames, m_range, m_gyroRange)
+	                               : readFifo(m_imu, buffer, maxFrames, numFrames, m_range);
+	if (rtnVal == BMI160::RTN_NO_ERROR) {
+		rtnVal = stamp(numFrames);
+	}
+	return rtnVal;
+}
+
+int32_t AccAcquisition::drainFifo(int16_t *buffer, uint16_t maxFrames, uint16_t &numFrames)
+{
+	int32_t rtnVal = (m_axes == 6) ? readFifo(m_imu, buffer, maxFrames, numFrames, m_range, m_gyroRange)
+	                               : readFifo(m_imu, buffer, maxFrames, numFrames, m_range);
+	if (rtnVal == BMI160::RTN_NO_ERROR) {
+		rtnVal = stamp(numFrames);
+	}
+	return rtnVal;
+}
+
+void AccAcquisition::waitDataReady()
+{
+	/* Checked with interrupts masked: an edge after the check stays pending
+	 * and ends the WFI at once, instead of sleeping until the next sample.
+	 * A pin still high means the sample is pending but its edge was missed. */
+	core_util_critical_section_enter();
+	while (!m_dataReady && !m_irq.read()) {
+		PERF_COUNT(PERF_SPINS, 1);
+		__WFI();
+		/* Pending handler runs here */
+		core_util_critical_section_exit();
+		core_util_critical_section_enter();
+	}
+	m_dataReady = false;
+	core_util_critical_section_exit();
+}
+
+void AccAcquisition::dataReadyIsr()
+{
+	m_dataReady = true;
+}
+
+void AccAcquisition::motionIsr()
+{
+	m_motion = true;
+}
+
+float AccAcquisition::sampleLevel(const acc_sample_t *sample) const
+{
+	float scale = BMI160::getAccScale(m_range);
+	return fabsf(acc_sample_to_g(sample[0], scale)) + fabsf(acc_sample_to_g(sample[1], scale))
+	     + fabsf(acc_sample_to_g(sample[2], scale));
+}
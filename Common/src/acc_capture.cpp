@@ -0,0 +1,108 @@
+/**
+*******************************************************************************
+* @file   acc_capture.cpp
+* @brief  Continuous accelerometer capture into a WindowRing
+*******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "acc_capture.h"
+#include "perf_stats.h"
+#include <string.h>
+
+/* Defines -------------------------------------------------------------------*/
+#define CAPTURE_FIFO_FLAG 0x01
+#define CAPTURE_WINDOW_FLAG 0x02
+#define CAPTURE_POLL_MS 50 /* Drain even without interrupt, in case an edge is missed */
+
+/* Functions definition ------------------------------------------------------*/
+AccCapture::AccCapture(BMI160 &imu, InterruptIn &irq, WindowRing &ring)
+: m_imu(imu), m_irq(irq), m_ring(ring), m_range(BMI160::SENS_2G), m_gyroRange(BMI160::DPS_2000),
+  m_frameSize(BMI160::FIFO_ACC_FRAME_SIZE), m_thread(osPriorityHigh),
+  m_clock(NULL), m_taken(0)
+{
+	/* Window timings are indexed by window number modulo their count */
+	MBED_ASSERT(ring.slots() <= CAPTURE_TIMING_SLOTS);
+	memset(m_timing, 0, sizeof(m_timing));
+}
+
+void AccCapture::start(BMI160::AccRange range, BMI160::InterruptPin pin)
+{
+	m_range = range;
+	m_imu.setInterruptPinConfig(pin, BMI160::DEFAULT_INT_PIN_CONFIG);
+	m_imu.setInterruptLatch(BMI160::INT_NON_LATCHED);
+	m_imu.enableDataInterrupt(BMI160::FWM_INT, pin);
+	m_imu.flushFifo();
+	m_irq.rise(callback(this, &AccCapture::fifoIsr));
+	m_thread.start(callback(this, &AccCapture::run));
+}
+
+acc_sample_t *AccCapture::waitWindow()
+{
+	PERF_SCOPE(PERF_WINDOW);
+	acc_sample_t *window;
+	while ((window = m_ring.readBuffer()) == NULL) {
+		m_flags.wait_any(CAPTURE_WINDOW_FLAG);
+	}
+	return window;
+}
+
+void AccCapture::releaseWindow()
+{
+	m_taken++;
+	m_ring.release();
+}
+
+bool AccCapture::windowTiming(WindowTiming &timing) const
+{
+	timing = m_timing[m_taken % CAPTURE_TIMING_SLOTS];
+	return timing.valid;
+}
+
+void AccCapture::fifoIsr()
+{
+	m_flags.set(CAPTURE_FIFO_FLAG);
+}
+
+void AccCapture::run()
+{
+	while (true) {
+		m_flags.wait_any(CAPTURE_FIFO_FLAG, CAPTURE_POLL_MS);
+		drain();
+	}
+}
+
+void AccCapture::drain()
+{
+	uint16_t room;
+	uint16_t frames;
+	do {
+		acc_sample_t *buffer = m_ring.writeBuffer(room);
+		if (buffer == NULL) {
+			/* Consumer is late: discard rather than let the FIFO overflow */
+			uint16_t length = 0;
+			m_imu.getFifoLength(length);
+			m_imu.flushFifo();
+			m_ring.dropSamples(length / m_frameSize);
+			PERF_COUNT(PERF_DROPPED, length / m_frameSize);
+			return;
+		}
+		frames = 0;
+		if (m_frameSize == BMI160::FIFO_GYRO_ACC_FRAME_SIZE) {
+			AccAcquisition::readFifo(m_imu, buffer, room, frames, m_range, m_gyroRange);
+		} else {
+			AccAcquisition::readFifo(m_imu, buffer, room, frames, m_range);
+		}
+		if (m_clock != NULL) {
+			/* Discarded samples are not stamped: they show as a gap */
+			AccAcquisition::stampFifo(m_imu, *m_clock, frames, m_frameSize);
+			if ((frames > 0) && (frames == room)) {
+				/* Stamped before the consumer can see the window */
+				m_clock->window(m_ring.samples(), m_timing[m_ring.windows() % CAPTURE_TIMING_SLOTS]);
+			}
+		}
+		if (m_ring.commitSamples(frames)) {
+			m_flags.set(CAPTURE_WINDOW_FLAG);
+		}
+	} while (frames == room);
+}
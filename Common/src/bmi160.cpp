@@ -0,0 +1,1004 @@
+/**********************************************************************
+* Copyright (C) 2016 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+**********************************************************************/
+
+
+#include "bmi160.h"
+#include "perf_stats.h"
+
+
+const struct BMI160::AccConfig BMI160::DEFAULT_ACC_CONFIG = {SENS_2G, 
+                                                             ACC_US_OFF, 
+                                                             ACC_BWP_2, 
+                                                             ACC_ODR_8};
+                                                             
+const struct BMI160::GyroConfig BMI160::DEFAULT_GYRO_CONFIG = {DPS_2000, 
+                                                               GYRO_BWP_2, 
+                                                               GYRO_ODR_8};
+
+const struct BMI160::FifoConfig BMI160::DEFAULT_FIFO_CONFIG = {true, 
+                                                               true, 
+                                                               FIFO_DOWNS_1, 
+                                                               504, 
+                                                               false};
+
+const struct BMI160::IntPinConfig BMI160::DEFAULT_INT_PIN_CONFIG = {false, 
+                                                                    true, 
+                                                                    false, 
+                                                                    true};
+
+///Period of internal counter
+static const float SENSOR_TIME_LSB = (1.0F / BMI160::SENSOR_TIME_HZ);
+
+const float BMI160::HIGHG_DUR_LSB_MS = 2.5F;
+
+///Threshold register value, rounded and clamped to 8 bits
+static uint8_t thresholdReg(float threshold, float lsb)
+{
+    if(!(lsb > 0.0F) || (threshold <= 0.0F))
+    {
+        return 0;
+    }
+    
+    float steps = ((threshold / lsb) + 0.5F);
+    return ((steps >= 255.0F) ? 255 : static_cast<uint8_t>(steps));
+}
+
+///g per LSB, indexed by AccRange (SENS_2G = 0x03 ... SENS_16G = 0x0C), 
+///0 for reserved values
+static const float ACC_G_PER_LSB[16] = 
+{
+    0.0F, 0.0F, 0.0F, (1.0F / 16384.0F), 
+    0.0F, (1.0F / 8192.0F), 0.0F, 0.0F, 
+    (1.0F / 4096.0F), 0.0F, 0.0F, 0.0F, 
+    (1.0F / 2048.0F), 0.0F, 0.0F, 0.0F
+};
+
+///dps per LSB, indexed by GyroRange
+static const float GYRO_DPS_PER_LSB[5] = 
+{
+    (1.0F / 16.4F),  //DPS_2000
+    (1.0F / 32.8F),  //DPS_1000
+    (1.0F / 65.6F),  //DPS_500
+    (1.0F / 131.2F), //DPS_250
+    (1.0F / 262.4F)  //DPS_125
+};
+
+
+//*****************************************************************************
+static void decodeXYZ(const uint8_t *localData, BMI160::SensorData &data, 
+                      float scale)
+{
+    data.xAxis.raw = ((localData[1] << 8) | localData[0]);
+    data.yAxis.raw = ((localData[3] << 8) | localData[2]);
+    data.zAxis.raw = ((localData[5] << 8) | localData[4]);
+    
+    data.xAxis.scaled = (data.xAxis.raw * scale);
+    data.yAxis.scaled = (data.yAxis.raw * scale);
+    data.zAxis.scaled = (data.zAxis.raw * scale);
+}
+    
+
+//*****************************************************************************
+int32_t BMI160::setSensorPowerMode(Sensors sensor, PowerModes pwrMode)
+{
+    int32_t rtnVal = -1;
+    
+    switch(sensor)
+    {
+        case MAG:
+            rtnVal = writeRegister(CMD, (MAG_SET_PMU_MODE | pwrMode));
+        break;
+        
+        case GYRO:
+            rtnVal = writeRegister(CMD, (GYR_SET_PMU_MODE | pwrMode));
+        break;
+        
+        case ACC:
+            rtnVal = writeRegister(CMD, (ACC_SET_PMU_MODE | pwrMode));
+        break;
+        
+        default:
+            rtnVal = -1;
+        break;
+    }
+    
+    return rtnVal;
+}
+
+
+//*****************************************************************************
+int32_t BMI160::setSensorConfig(const AccConfig &config)
+{
+    uint8_t data[2];
+    
+    data[0] = ((config.us << ACC_US_POS) | (config.bwp << ACC_BWP_POS) | 
+               (config.odr << ACC_ODR_POS));
+    data[1] = config.range;
+    
+    return writeBlock(ACC_CONF, ACC_RANGE, data);
+}
+
+
+//*****************************************************************************
+int32_t BMI160::setSensorConfig(const GyroConfig &config)
+{
+    uint8_t data[2];
+    
+    data[0] = ((config.bwp << GYRO_BWP_POS) | (config.odr << GYRO_ODR_POS));
+    data[1] = config.range;
+    
+    return writeBlock(GYR_CONF, GYR_RANGE, data);
+}
+
+
+//*****************************************************************************
+int32_t BMI160::getSensorConfig(AccConfig &config)
+{
+    uint8_t data[2];
+    int32_t rtnVal = readBlock(ACC_CONF, ACC_RANGE, data);
+    
+    if(rtnVal == RTN_NO_ERROR)
+    {
+        config.range = static_cast<BMI160::AccRange>(
+        (data[1] & ACC_RANGE_MASK));
+        config.us = static_cast<BMI160::AccUnderSampling>(
+        ((data[0] & ACC_US_MASK) >> ACC_US_POS));
+        config.bwp = static_cast<BMI160::AccBandWidthParam>(
+        ((data[0] & ACC_BWP_MASK) >> ACC_BWP_POS));
+        config.odr = static_cast<BMI160::AccOutputDataRate>(
+        ((data[0] & ACC_ODR_MASK) >> ACC_ODR_POS));
+    }
+    
+    return rtnVal;
+}
+
+
+//*****************************************************************************
+int32_t BMI160::getSensorConfig(GyroConfig &config)
+{
+    uint8_t data[2];
+    int32_t rtnVal = readBlock(GYR_CONF, GYR_RANGE, data);
+    
+    if(rtnVal == RTN_NO_ERROR)
+    {
+        config.range = static_cast<BMI160::GyroRange>(
+        (data[1] & GYRO_RANGE_MASK));
+        config.bwp = static_cast<BMI160::GyroBandWidthParam>(
+        ((data[0] & GYRO_BWP_MASK) >> GYRO_BWP_POS));
+        config.odr = static_cast<BMI160::GyroOutputDataRate>(
+        ((data[0] & GYRO_ODR_MASK) >> GYRO_ODR_POS));
+    }
+    
+    return rtnVal;
+}
+
+
+//*****************************************************************************
+float BMI160::getAccScale(AccRange range)
+{
+    return ACC_G_PER_LSB[(range & 0x0F)];
+}
+
+
+//*****************************************************************************
+float BMI160::getGyroScale(GyroRange range)
+{
+    return (static_cast<uint32_t>(range) < 5) ? GYRO_DPS_PER_LSB[range] : 0.0F;
+}
+
+
+//*****************************************************************************
+void BMI160::scaleRaw(const int16_t *raw, float *buffer, uint32_t numValues, 
+                      float scale)
+{
+    for(uint32_t idx = 0; idx < numValues; idx++)
+    {
+        buffer[idx] = (raw[idx] * scale);
+    }
+}
+
+
+//*****************************************************************************
+void BMI160::scaleFifoAccFrames(const uint8_t *frames, float *buffer, 
+                                uint16_t numFrames, float scale)
+{
+    for(uint16_t idx = 0; idx < numFrames; idx++)
+    {
+        const uint8_t *frame = (frames + (idx * FIFO_ACC_FRAME_SIZE));
+        int16_t x = ((frame[1] << 8) | frame[0]);
+        int16_t y = ((frame[3] << 8) | frame[2]);
+        int16_t z = ((frame[5] << 8) | frame[4]);
+        
+        buffer[(3 * idx)] = (x * scale);
+        buffer[(3 * idx) + 1] = (y * scale);
+        buffer[(3 * idx) + 2] = (z * scale);
+    }
+}
+
+
+//*****************************************************************************
+void BMI160::scaleFifoGyroAccFrames(const uint8_t *frames, float *buffer, 
+                                    uint16_t numFrames, float accScale, 
+                                    float gyroScale)
+{
+    for(uint16_t idx = 0; idx < numFrames; idx++)
+    {
+        const uint8_t *frame = (frames + (idx * FIFO_GYRO_ACC_FRAME_SIZE));
+        int16_t gx = ((frame[1] << 8) | frame[0]);
+        int16_t gy = ((frame[3] << 8) | frame[2]);
+        int16_t gz = ((frame[5] << 8) | frame[4]);
+        int16_t ax = ((frame[7] << 8) | frame[6]);
+        int16_t ay = ((frame[9] << 8) | frame[8]);
+        int16_t az = ((frame[11] << 8) | frame[10]);
+        
+        //The six values are read before any is written: a frame never 
+        //lies below its own destination
+        buffer[(6 * idx)] = (ax * accScale);
+        buffer[(6 * idx) + 1] = (ay * accScale);
+        buffer[(6 * idx) + 2] = (az * accScale);
+        buffer[(6 * idx) + 3] = (gx * gyroScale);
+        buffer[(6 * idx) + 4] = (gy * gyroScale);
+        buffer[(6 * idx) + 5] = (gz * gyroScale);
+    }
+}
+
+
+//*****************************************************************************
+int32_t BMI160::getSensorAxis(SensorAxis axis, AxisData &data, AccRange range)
+{
+    uint8_t localData[2];
+    int32_t rtnVal;
+    
+    switch(axis)
+    {
+        case X_AXIS:
+            rtnVal = readBlock(DATA_14, DATA_15, localData);
+        break;
+        
+        case Y_AXIS:
+            rtnVal = readBlock(DATA_16, DATA_17, localData);
+        break;
+        
+        case Z_AXIS:
+            rtnVal = readBlock(DATA_18, DATA_19, localData);
+        break;
+        
+        default:
+            rtnVal = -1;
+        break;
+    }
+    
+    if(rtnVal == RTN_NO_ERROR)
+    {
+        data.raw = ((localData[1] << 8) | localData[0]);
+        data.scaled = (data.raw * getAccScale(range));
+    }
+    
+    return rtnVal;
+}
+
+
+//*****************************************************************************
+int32_t BMI160::getSensorAxis(SensorAxis axis, AxisData &data, GyroRange range)
+{
+    uint8_t localData[2];
+    int32_t rtnVal;
+    
+    switch(axis)
+    {
+        case X_AXIS:
+            rtnVal = readBlock(DATA_8, DATA_9, localData);
+        break;
+        
+        case Y_AXIS:
+            rtnVal = readBlock(DATA_10, DATA_11, localData);
+        break;
+        
+        case Z_AXIS:
+            rtnVal = readBlock(DATA_12, DATA_13, localData);
+        break;
+        
+        default:
+            rtnVal = -1;
+        break;
+    }
+    
+    if(rtnVal == RTN_NO_ERROR)
+    {
+        data.raw = ((localData[1] << 8) | localData[0]);
+        data.scaled = (data.raw * getGyroScale(range));
+    }
+    
+    return rtnVal;
+}
+    
+
+//*****************************************************************************    
+int32_t BMI160::getSensorXYZ(SensorData &data, AccRange range)
+{
+    uint8_t localData[6];
+    int32_t rtnVal = readBlock(DATA_14, DATA_19, localData);
+    
+    if(rtnVal == RTN_NO_ERROR)
+    {
+        decodeXYZ(localData, data, getAccScale(range));
+    }
+    
+    return rtnVal;
+}
+
+
+//*****************************************************************************    
+int32_t BMI160::getSensorXYZ(SensorData &data, GyroRange range)
+{
+    uint8_t localData[6];
+    int32_t rtnVal = readBlock(DATA_8, DATA_13, localData);
+    
+    if(rtnVal == RTN_NO_ERROR)
+    {
+        decodeXYZ(localData, data, getGyroScale(range));
+    }
+    
+    return rtnVal;
+}
+
+
+//***************************************************************************** 
+int32_t BMI160::getSensorXYZandSensorTime(SensorData &data, 
+                                          SensorTime &sensorTime, 
+                                          AccRange range)
+{
+    uint8_t localData[9];
+    int32_t rtnVal = readBlock(DATA_14, SENSORTIME_2, localData);
+    if(rtnVal == RTN_NO_ERROR)
+    {
+        decodeXYZ(localData, data, getAccScale(range));
+        
+        sensorTime.raw = ((localData[8] << 16) | (localData[7] << 8) | 
+                           localData[6]);
+        sensorTime.seconds = (sensorTime.raw * SENSOR_TIME_LSB);
+    }
+    
+    return rtnVal;
+}
+
+
+//***************************************************************************** 
+int32_t BMI160::getSensorXYZandSensorTime(SensorData &data, 
+                                          SensorTime &sensorTime, 
+                                          GyroRange range)
+{
+    uint8_t localData[16];
+    int32_t rtnVal = readBlock(DATA_8, SENSORTIME_2, localData);
+    if(rtnVal == RTN_NO_ERROR)
+    {
+        decodeXYZ(localData, data, getGyroScale(range));
+        
+        sensorTime.raw = ((localData[14] << 16) | (localData[13] << 8) | 
+                           localData[12]);
+        sensorTime.seconds = (sensorTime.raw * SENSOR_TIME_LSB);
+    }
+    
+    return rtnVal;
+}
+
+
+//***************************************************************************** 
+int32_t BMI160::getGyroAccXYZandSensorTime(SensorData &accData, 
+                                           SensorData &gyroData, 
+                                           SensorTime &sensorTime, 
+                                           AccRange accRange, 
+                                           GyroRange gyroRange)
+{
+    uint8_t localData[16];
+    int32_t rtnVal = readBlock(DATA_8, SENSORTIME_2, localData);
+    if(rtnVal == RTN_NO_ERROR)
+    {
+        decodeXYZ(localData, gyroData, getGyroScale(gyroRange));
+        decodeXYZ((localData + 6), accData, getAccScale(accRange));
+        
+        sensorTime.raw = ((localData[14] << 16) | (localData[13] << 8) | 
+                           localData[12]);
+        sensorTime.seconds = (sensorTime.raw * SENSOR_TIME_LSB);
+    }
+    
+    return rtnVal;
+}
+
+
+//*****************************************************************************
+uint32_t BMI160::getFifoFramePeriod(AccOutputDataRate odr, 
+                                    FifoDownSampling downs)
+{
+    //16 ticks at 1600Hz, twice as many for each halving of the rate
+    return ((16UL << (ACC_ODR_12 - odr)) << downs);
+}
+
+
+//*****************************************************************************
+int32_t BMI160::setFifoConfig(const FifoConfig &config)
+{
+    uint8_t data[3];
+    
+    data[0] = ((config.accFiltered << FIFO_ACC_FILT_POS) | 
+               (config.accDowns << FIFO_ACC_DOWNS_POS));
+    if(config.gyroEnable)
+    {
+        data[0] |= ((config.accFiltered << FIFO_GYRO_FILT_POS) | 
+                    (config.accDowns << FIFO_GYRO_DOWNS_POS));
+    }
+    data[1] = (config.watermark / FIFO_WATERMARK_LSB);
+    data[2] = ((config.accEnable << FIFO_ACC_EN_POS) | 
+               (config.gyroEnable << FIFO_GYRO_EN_POS));
+    
+    return writeBlock(FIFO_DOWNS, FIFO_CONFIG_1, data);
+}
+
+
+//*****************************************************************************
+int32_t BMI160::getFifoConfig(FifoConfig &config)
+{
+    uint8_t data[3];
+    int32_t rtnVal = readBlock(FIFO_DOWNS, FIFO_CONFIG_1, data);
+    
+    if(rtnVal == RTN_NO_ERROR)
+    {
+        config.accFiltered = ((data[0] & FIFO_ACC_FILT_MASK) != 0);
+        config.accDowns = static_cast<BMI160::FifoDownSampling>(
+        ((data[0] & FIFO_ACC_DOWNS_MASK) >> FIFO_ACC_DOWNS_POS));
+        config.watermark = (data[1] * FIFO_WATERMARK_LSB);
+        config.accEnable = ((data[2] & FIFO_ACC_EN_MASK) != 0);
+        config.gyroEnable = ((data[2] & FIFO_GYRO_EN_MASK) != 0);
+    }
+    
+    return rtnVal;
+}
+
+
+//*****************************************************************************
+int32_t BMI160::flushFifo()
+{
+    return writeRegister(CMD, FIFO_FLUSH);
+}
+
+
+//*****************************************************************************
+int32_t BMI160::getFifoLength(uint16_t &length)
+{
+    uint8_t data[2];
+    int32_t rtnVal = readBlock(FIFO_LENGTH_0, FIFO_LENGTH_1, data);
+    
+    if(rtnVal == RTN_NO_ERROR)
+    {
+        length = (((data[1] & FIFO_LENGTH_1_MASK) << 8) | data[0]);
+    }
+    
+    return rtnVal;
+}
+
+
+//*****************************************************************************
+int32_t BMI160::getFifoFrames(uint8_t frameSize, uint16_t maxFrames, 
+                              uint16_t &numFrames)
+{
+    uint16_t length;
+    int32_t rtnVal = getFifoLength(length);
+    
+    numFrames = 0;
+    if(rtnVal == RTN_NO_ERROR)
+    {
+        //No room for one more frame: the FIFO overwrote at least one
+        if(length > (FIFO_SIZE - frameSize))
+        {
+            PERF_COUNT(PERF_DROPPED, 1);
+        }
+        numFrames = (length / frameSize);
+        if(numFrames > maxFrames)
+        {
+            numFrames = maxFrames;
+        }
+    }
+    
+    return rtnVal;
+}
+
+
+//*****************************************************************************
+int32_t BMI160::getFifoAccXYZ(float *buffer, uint16_t maxFrames, 
+                              uint16_t &numFrames, AccRange range)
+{
+    uint16_t frames;
+    int32_t rtnVal = getFifoFrames(FIFO_ACC_FRAME_SIZE, maxFrames, frames);
+    
+    numFrames = 0;
+    if((rtnVal != RTN_NO_ERROR) || (frames == 0))
+    {
+        return rtnVal;
+    }
+    
+    //A frame is 6 raw bytes but 12 bytes once scaled, so the burst lands in 
+    //the upper half of the destination and is decoded upwards from the 
+    //bottom; the write position never overtakes the next unread frame.
+    uint8_t *raw = (reinterpret_cast<uint8_t *>(buffer) + 
+                    (frames * FIFO_ACC_FRAME_SIZE));
+    rtnVal = readBurst(FIFO_DATA, raw, (frames * FIFO_ACC_FRAME_SIZE));
+    if(rtnVal != RTN_NO_ERROR)
+    {
+        return rtnVal;
+    }
+    
+    scaleFifoAccFrames(raw, buffer, frames, getAccScale(range));
+    
+    numFrames = frames;
+    
+    return rtnVal;
+}
+
+
+//*****************************************************************************
+int32_t BMI160::getFifoAccXYZ(int16_t *buffer, uint16_t maxFrames, 
+                              uint16_t &numFrames)
+{
+    uint16_t frames;
+    int32_t rtnVal = getFifoFrames(FIFO_ACC_FRAME_SIZE, maxFrames, frames);
+    
+    numFrames = 0;
+    if((rtnVal != RTN_NO_ERROR) || (frames == 0))
+    {
+        return rtnVal;
+    }
+    
+    //Frames are little endian int16 triples already, the burst lands in 
+    //place and each value is only reassembled for the MCU byte order.
+    uint8_t *raw = reinterpret_cast<uint8_t *>(buffer);
+    rtnVal = readBurst(FIFO_DATA, raw, (frames * FIFO_ACC_FRAME_SIZE));
+    if(rtnVal != RTN_NO_ERROR)
+    {
+        return rtnVal;
+    }
+    
+    for(uint32_t idx = 0; idx < (3 * frames); idx++)
+    {
+        buffer[idx] = ((raw[(2 * idx) + 1] << 8) | raw[(2 * idx)]);
+    }
+    
+    numFrames = frames;
+    
+    return rtnVal;
+}
+
+
+//*****************************************************************************
+int32_t BMI160::getFifoGyroAccXYZ(float *buffer, uint16_t maxFrames, 
+                                  uint16_t &numFrames, AccRange accRange, 
+                                  GyroRange gyroRange)
+{
+    uint16_t frames;
+    int32_t rtnVal = getFifoFrames(FIFO_GYRO_ACC_FRAME_SIZE, maxFrames, frames);
+    
+    numFrames = 0;
+    if((rtnVal != RTN_NO_ERROR) || (frames == 0))
+    {
+        return rtnVal;
+    }
+    
+    //12 raw bytes per frame, 24 once scaled: same upper half trick as 
+    //getFifoAccXYZ
+    uint8_t *raw = (reinterpret_cast<uint8_t *>(buffer) + 
+                    (frames * FIFO_GYRO_ACC_FRAME_SIZE));
+    rtnVal = readBurst(FIFO_DATA, raw, (frames * FIFO_GYRO_ACC_FRAME_SIZE));
+    if(rtnVal != RTN_NO_ERROR)
+    {
+        return rtnVal;
+    }
+    
+    scaleFifoGyroAccFrames(raw, buffer, frames, getAccScale(accRange), 
+                           getGyroScale(gyroRange));
+    
+    numFrames = frames;
+    
+    return rtnVal;
+}
+
+
+//*****************************************************************************
+int32_t BMI160::getFifoGyroAccXYZ(int16_t *buffer, uint16_t maxFrames, 
+                                  uint16_t &numFrames)
+{
+    uint16_t frames;
+    int32_t rtnVal = getFifoFrames(FIFO_GYRO_ACC_FRAME_SIZE, maxFrames, frames);
+    
+    numFrames = 0;
+    if((rtnVal != RTN_NO_ERROR) || (frames == 0))
+    {
+        return rtnVal;
+    }
+    
+    uint8_t *raw = reinterpret_cast<uint8_t *>(buffer);
+    rtnVal = readBurst(FIFO_DATA, raw, (frames * FIFO_GYRO_ACC_FRAME_SIZE));
+    if(rtnVal != RTN_NO_ERROR)
+    {
+        return rtnVal;
+    }
+    
+    //In place, one frame at a time: gyroscope then accelerometer becomes 
+    //accelerometer then gyroscope
+    for(uint16_t idx = 0; idx < frames; idx++)
+    {
+        const uint8_t *frame = (raw + (idx * FIFO_GYRO_ACC_FRAME_SIZE));
+        int16_t values[6];
+        for(uint8_t axis = 0; axis < 6; axis++)
+        {
+            values[axis] = ((frame[(2 * axis) + 1] << 8) | frame[(2 * axis)]);
+        }
+        for(uint8_t axis = 0; axis < 3; axis++)
+        {
+            buffer[(6 * idx) + axis] = values[axis + 3];
+            buffer[(6 * idx) + axis + 3] = values[axis];
+        }
+    }
+    
+    numFrames = frames;
+    
+    return rtnVal;
+}
+
+
+//*****************************************************************************
+int32_t BMI160::setInterruptPinConfig(InterruptPin pin, 
+                                      const IntPinConfig &config)
+{
+    uint8_t data = ((config.edgeTrigger << INT_EDGE_CTRL_POS) | 
+                    (config.activeHigh << INT_LVL_POS) | 
+                    (config.openDrain << INT_OD_POS) | 
+                    (config.outputEnable << INT_OUTPUT_EN_POS));
+    
+    if(pin == INT1)
+    {
+        return updateRegister(INT_OUT_CTRL, INT1_OUT_CTRL_MASK, 
+                              (data << INT1_OUT_CTRL_POS));
+    }
+    
+    return updateRegister(INT_OUT_CTRL, INT2_OUT_CTRL_MASK, 
+                          (data << INT2_OUT_CTRL_POS));
+}
+
+
+//*****************************************************************************
+int32_t BMI160::setInterruptLatch(InterruptLatch latch)
+{
+    return updateRegister(INT_LATCH, INT_LATCH_MASK, (latch << INT_LATCH_POS));
+}
+
+
+//*****************************************************************************
+int32_t BMI160::enableDataInterrupt(DataInterrupt source, InterruptPin pin)
+{
+    uint8_t int1Map;
+    uint8_t int2Map;
+    
+    switch(source)
+    {
+        case DRDY_INT:
+            int1Map = INT1_MAP_DRDY_MASK;
+            int2Map = INT2_MAP_DRDY_MASK;
+        break;
+        
+        case FWM_INT:
+            int1Map = INT1_MAP_FWM_MASK;
+            int2Map = INT2_MAP_FWM_MASK;
+        break;
+        
+        case FFULL_INT:
+            int1Map = INT1_MAP_FFULL_MASK;
+            int2Map = INT2_MAP_FFULL_MASK;
+        break;
+        
+        default:
+            return -1;
+    }
+    
+    int32_t rtnVal = updateRegister(INT_MAP_1, (int1Map | int2Map), 
+                                    ((pin == INT1) ? int1Map : int2Map));
+    if(rtnVal == RTN_NO_ERROR)
+    {
+        rtnVal = updateRegister(INT_EN_1, source, source);
+    }
+    
+    return rtnVal;
+}
+
+
+//*****************************************************************************
+int32_t BMI160::disableDataInterrupt(DataInterrupt source)
+{
+    uint8_t mapMask;
+    
+    switch(source)
+    {
+        case DRDY_INT:
+            mapMask = (INT1_MAP_DRDY_MASK | INT2_MAP_DRDY_MASK);
+        break;
+        
+        case FWM_INT:
+            mapMask = (INT1_MAP_FWM_MASK | INT2_MAP_FWM_MASK);
+        break;
+        
+        case FFULL_INT:
+            mapMask = (INT1_MAP_FFULL_MASK | INT2_MAP_FFULL_MASK);
+        break;
+        
+        default:
+            return -1;
+    }
+    
+    int32_t rtnVal = updateRegister(INT_EN_1, source, 0);
+    if(rtnVal == RTN_NO_ERROR)
+    {
+        rtnVal = updateRegister(INT_MAP_1, mapMask, 0);
+    }
+    
+    return rtnVal;
+}
+
+
+//*****************************************************************************
+int32_t BMI160::setAnyMotionConfig(const AnyMotionConfig &config, 
+                                   AccRange range)
+{
+    uint8_t samples = config.samples;
+    if(samples < 1)
+    {
+        samples = 1;
+    }
+    else if(samples > 4)
+    {
+        samples = 4;
+    }
+    
+    int32_t rtnVal = updateRegister(INT_MOTION_0, ANYMO_DUR_MASK, 
+                                    ((samples - 1) << ANYMO_DUR_POS));
+    if(rtnVal == RTN_NO_ERROR)
+    {
+        rtnVal = writeRegister(INT_MOTION_1, thresholdReg(config.threshold, 
+                               (getAccScale(range) * ANYMO_TH_LSB)));
+    }
+    
+    return rtnVal;
+}
+
+
+//*****************************************************************************
+int32_t BMI160::setHighGConfig(const HighGConfig &config, AccRange range)
+{
+    float scale = getAccScale(range);
+    uint8_t hysteresis = thresholdReg(config.hysteresis, 
+                                      (scale * HIGHG_HY_LSB));
+    if(hysteresis > (HIGHG_HY_MASK >> HIGHG_HY_POS))
+    {
+        hysteresis = (HIGHG_HY_MASK >> HIGHG_HY_POS);
+    }
+    
+    //duration is (INT_LOWHIGH_3 + 1) * 2.5ms
+    uint8_t duration = thresholdReg(config.duration, HIGHG_DUR_LSB_MS);
+    if(duration > 0)
+    {
+        duration--;
+    }
+    
+    int32_t rtnVal = updateRegister(INT_LOWHIGH_2, HIGHG_HY_MASK, 
+                                    (hysteresis << HIGHG_HY_POS));
+    if(rtnVal == RTN_NO_ERROR)
+    {
+        uint8_t data[2];
+        data[0] = duration;
+        data[1] = thresholdReg(config.threshold, (scale * HIGHG_TH_LSB));
+        rtnVal = writeBlock(INT_LOWHIGH_3, INT_LOWHIGH_4, data);
+    }
+    
+    return rtnVal;
+}
+
+
+//*****************************************************************************
+int32_t BMI160::enableMotionInterrupt(MotionInterrupt source, InterruptPin pin)
+{
+    Registers enReg;
+    uint8_t enMask;
+    uint8_t mapMask;
+    
+    switch(source)
+    {
+        case ANY_MOTION_INT:
+            enReg = INT_EN_0;
+            enMask = ANYMO_EN_MASK;
+            mapMask = MAP_ANYMO_MASK;
+        break;
+        
+        case HIGH_G_INT:
+            enReg = INT_EN_1;
+            enMask = HIGHG_EN_MASK;
+            mapMask = MAP_HIGHG_MASK;
+        break;
+        
+        default:
+            return -1;
+    }
+    
+    int32_t rtnVal = updateRegister(((pin == INT1) ? INT_MAP_0 : INT_MAP_2), 
+                                    mapMask, mapMask);
+    if(rtnVal == RTN_NO_ERROR)
+    {
+        rtnVal = updateRegister(enReg, enMask, enMask);
+    }
+    
+    return rtnVal;
+}
+
+
+//*****************************************************************************
+int32_t BMI160::disableMotionInterrupt(MotionInterrupt source)
+{
+    Registers enReg;
+    uint8_t enMask;
+    uint8_t mapMask;
+    
+    switch(source)
+    {
+        case ANY_MOTION_INT:
+            enReg = INT_EN_0;
+            enMask = ANYMO_EN_MASK;
+            mapMask = MAP_ANYMO_MASK;
+        break;
+        
+        case HIGH_G_INT:
+            enReg = INT_EN_1;
+            enMask = HIGHG_EN_MASK;
+            mapMask = MAP_HIGHG_MASK;
+        break;
+        
+        default:
+            return -1;
+    }
+    
+    int32_t rtnVal = updateRegister(enReg, enMask, 0);
+    if(rtnVal == RTN_NO_ERROR)
+    {
+        rtnVal = updateRegister(INT_MAP_0, mapMask, 0);
+    }
+    if(rtnVal == RTN_NO_ERROR)
+    {
+        rtnVal = updateRegister(INT_MAP_2, mapMask, 0);
+    }
+    
+    return rtnVal;
+}
+
+
+//*****************************************************************************
+int32_t BMI160::getInterruptStatus(uint32_t &status)
+{
+    uint8_t data[4];
+    int32_t rtnVal = readBlock(INT_STATUS_0, INT_STATUS_3, data);
+    
+    if(rtnVal == RTN_NO_ERROR)
+    {
+        status = ((data[3] << 24) | (data[2] << 16) | (data[1] << 8) | 
+                   data[0]);
+    }
+    
+    return rtnVal;
+}
+
+
+//*****************************************************************************
+int32_t BMI160::resetInterrupts()
+{
+    return writeRegister(CMD, INT_RESET);
+}
+
+
+//***************************************************************************** 
+int32_t BMI160::getSensorTime(SensorTime &sensorTime)
+{
+    uint8_t localData[3];
+    int32_t rtnVal = readBlock(SENSORTIME_0, SENSORTIME_2, localData);
+    
+    if(rtnVal == RTN_NO_ERROR)
+    {
+        sensorTime.raw = ((localData[2] << 16) | (localData[1] << 8) | 
+                           localData[0]);
+        sensorTime.seconds = (sensorTime.raw * SENSOR_TIME_LSB);
+    }
+    
+    return rtnVal;
+}
+
+
+//*****************************************************************************
+int32_t BMI160::getSensorTimeAndFifoLength(SensorTime &sensorTime, 
+                                           uint16_t &length)
+{
+    uint8_t localData[12];
+    int32_t rtnVal = readBlock(SENSORTIME_0, FIFO_LENGTH_1, localData);
+    
+    if(rtnVal == RTN_NO_ERROR)
+    {
+        sensorTime.raw = ((localData[2] << 16) | (localData[1] << 8) | 
+                           localData[0]);
+        sensorTime.seconds = (sensorTime.raw * SENSOR_TIME_LSB);
+        length = (((localData[11] & FIFO_LENGTH_1_MASK) << 8) | 
+                  localData[10]);
+    }
+    
+    return rtnVal;
+}
+
+
+//*****************************************************************************
+int32_t BMI160::getTemperature(float *temp)
+{
+    uint8_t data[2];
+    uint16_t rawTemp;
+    
+    int32_t rtnVal = readBlock(TEMPERATURE_0, TEMPERATURE_1, data);
+    if(rtnVal == RTN_NO_ERROR)
+    {
+        rawTemp = ((data[1] << 8) | data[0]);
+        if(rawTemp & 0x8000)
+        {
+            *temp = (23.0F - ((0x10000 - rawTemp)/512.0F));
+        }
+        else
+        {
+            *temp = ((rawTemp/512.0F) + 23.0F);
+        }
+    }
+    
+    return rtnVal;
+}
+
+
+//*****************************************************************************
+int32_t BMI160::updateRegister(Registers reg, uint8_t mask, uint8_t data)
+{
+    uint8_t value;
+    int32_t rtnVal = readRegister(reg, &value);
+    
+    if(rtnVal == RTN_NO_ERROR)
+    {
+        value = ((value & ~mask) | (data & mask));
+        rtnVal = writeRegister(reg, value);
+    }
+    
+    return rtnVal;
+}
@@ -32,6 +32,7 @@
 
 
 #include "bmi160.h"
+#include "perf_stats.h"
 
 
 //*****************************************************************************
@@ -48,6 +49,9 @@ int32_t BMI160_I2C::readRegister(Registers reg, uint8_t *data)
     int32_t rtnVal = -1;
     char packet[] = {static_cast<char>(reg)};
     
+    PERF_COUNT(PERF_BUS_TRANSFERS, 1);
+    PERF_COUNT(PERF_BUS_BYTES, 1);
+    
     if(m_i2cBus.write(m_Wadrs, packet, 1) == 0)
     {
         rtnVal = m_i2cBus.read(m_Radrs, reinterpret_cast<char *>(data), 1);
@@ -62,6 +66,9 @@ int32_t BMI160_I2C::writeRegister(Registers reg, const uint8_t data)
 {
     char packet[] = {static_cast<char>(reg), static_cast<char>(data)};
     
+    PERF_COUNT(PERF_BUS_TRANSFERS, 1);
+    PERF_COUNT(PERF_BUS_BYTES, 1);
+    
     return m_i2cBus.write(m_Wadrs, packet, sizeof(packet));
 }
 
@@ -74,6 +81,9 @@ uint8_t *data)
     int32_t numBytes = ((stopReg - startReg) + 1);
     char packet[] = {static_cast<char>(startReg)};
     
+    PERF_COUNT(PERF_BUS_TRANSFERS, 1);
+    PERF_COUNT(PERF_BUS_BYTES, numBytes);
+    
     if(m_i2cBus.write(m_Wadrs, packet, 1) == 0)
     {
         rtnVal = m_i2cBus.read(m_Radrs, reinterpret_cast<char *>(data), numBytes);
@@ -90,9 +100,30 @@ const uint8_t *data)
     int32_t numBytes = ((stopReg - startReg) + 1);
     char packet[32];
     
+    PERF_COUNT(PERF_BUS_TRANSFERS, 1);
+    PERF_COUNT(PERF_BUS_BYTES, numBytes);
+    
     packet[0] = static_cast<char>(startReg);
     
     memcpy(packet + 1, data, numBytes);
     
     return m_i2cBus.write(m_Wadrs, packet, (numBytes+1) * sizeof(char));
 }
+
+
+//*****************************************************************************
+int32_t BMI160_I2C::readBurst(Registers reg, uint8_t *data, uint32_t numBytes)
+{
+    int32_t rtnVal = -1;
+    char packet[] = {static_cast<char>(reg)};
+    
+    PERF_COUNT(PERF_BUS_TRANSFERS, 1);
+    PERF_COUNT(PERF_BUS_BYTES, numBytes);
+    
+    if(m_i2cBus.write(m_Wadrs, packet, 1) == 0)
+    {
+        rtnVal = m_i2cBus.read(m_Radrs, reinterpret_cast<char *>(data), numBytes);
+    }
+    
+    return rtnVal;
+}
@@ -0,0 +1,177 @@
+/**********************************************************************
+* Copyright (C) 2016 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+**********************************************************************/
+
+
+#include "bmi160.h"
+#include "perf_stats.h"
+
+
+//*****************************************************************************
+BMI160_SPI::BMI160_SPI(SPI &spiBus, DigitalOut &cs)
+:m_spiBus(spiBus), m_cs(cs), m_spiMode(false)
+{
+    m_cs = 1;
+}
+
+
+//*****************************************************************************   
+int32_t BMI160_SPI::readRegister(Registers reg, uint8_t *data)
+{
+    PERF_COUNT(PERF_BUS_BYTES, 1);
+    select(SPI_READ | reg);
+    *data = m_spiBus.write(0x00);
+    deselect();
+    
+    return RTN_NO_ERROR;
+}
+
+
+//*****************************************************************************
+int32_t BMI160_SPI::writeRegister(Registers reg, const uint8_t data)
+{
+    PERF_COUNT(PERF_BUS_BYTES, 1);
+    select(reg & SPI_ADRS_MASK);
+    m_spiBus.write(data);
+    deselect();
+    
+    return RTN_NO_ERROR;
+}
+
+
+//*****************************************************************************
+int32_t BMI160_SPI::readBlock(Registers startReg, Registers stopReg, 
+uint8_t *data)
+{
+    //The register address auto increments during a burst read
+    return readBurst(startReg, data, ((stopReg - startReg) + 1));
+}
+
+
+//*****************************************************************************
+int32_t BMI160_SPI::writeBlock(Registers startReg, Registers stopReg, 
+const uint8_t *data)
+{
+    int32_t numBytes = ((stopReg - startReg) + 1);
+    
+    PERF_COUNT(PERF_BUS_BYTES, numBytes);
+    select(startReg & SPI_ADRS_MASK);
+    m_spiBus.write(reinterpret_cast<const char *>(data), numBytes, NULL, 0);
+    deselect();
+    
+    return RTN_NO_ERROR;
+}
+
+
+//*****************************************************************************
+int32_t BMI160_SPI::readBurst(Registers reg, uint8_t *data, uint32_t numBytes)
+{
+    PERF_COUNT(PERF_BUS_BYTES, numBytes);
+    select(SPI_READ | reg);
+    int32_t rtnVal = receive(data, numBytes);
+    deselect();
+    
+    return rtnVal;
+}
+
+
+//*****************************************************************************
+void BMI160_SPI::select(uint8_t adrs)
+{
+    PERF_COUNT(PERF_BUS_TRANSFERS, 1);
+    m_spiBus.lock();
+    
+    if(!m_spiMode)
+    {
+        //Rising edge on CSB after power up latches the SPI interface
+        m_cs = 0;
+        m_spiBus.write(SPI_READ | SPI_DUMMY_ADRS);
+        m_spiBus.write(0x00);
+        m_cs = 1;
+        m_spiMode = true;
+    }
+    
+    m_cs = 0;
+    m_spiBus.write(adrs);
+}
+
+
+//*****************************************************************************
+void BMI160_SPI::deselect()
+{
+    m_cs = 1;
+    m_spiBus.unlock();
+}
+
+
+//*****************************************************************************
+int32_t BMI160_SPI::receive(uint8_t *data, uint32_t numBytes)
+{
+#if DEVICE_SPI_ASYNCH
+    if(numBytes >= SPI_ASYNCH_MIN_BYTES)
+    {
+        m_transferDone = false;
+        m_transferEvent = 0;
+        if(m_spiBus.transfer<uint8_t>(NULL, 0, data, numBytes, 
+                                      callback(this, &BMI160_SPI::transferDone), 
+                                      (SPI_EVENT_COMPLETE | SPI_EVENT_ERROR)) == 0)
+        {
+            //Masked so the completion can not land between check and sleep
+            core_util_critical_section_enter();
+            while(!m_transferDone)
+            {
+                __WFI();
+                core_util_critical_section_exit();
+                core_util_critical_section_enter();
+            }
+            core_util_critical_section_exit();
+            
+            return ((m_transferEvent & SPI_EVENT_ERROR) ? -1 : RTN_NO_ERROR);
+        }
+        
+        //Transfer not started, read in blocking mode instead
+    }
+#endif
+    
+    m_spiBus.write(NULL, 0, reinterpret_cast<char *>(data), numBytes);
+    
+    return RTN_NO_ERROR;
+}
+
+
+#if DEVICE_SPI_ASYNCH
+//*****************************************************************************
+void BMI160_SPI::transferDone(int event)
+{
+    m_transferEvent = event;
+    m_transferDone = true;
+}
+#endif
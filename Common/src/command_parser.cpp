@@ -0,0 +1,190 @@
+/**
+*******************************************************************************
+* @file   command_parser.cpp
+* @brief  Line commands received on a serial port
+*******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "command_parser.h"
+
+/* Functions definition ------------------------------------------------------*/
+static bool keyword_is(const char *keyword, uint8_t length, const char *name)
+{
+	uint8_t i = 0;
+	for (; i < length; i++) {
+		if (name[i] != keyword[i]) {
+			return false;
+		}
+	}
+	return (name[i] == '\0');
+}
+
+CommandParser::CommandParser()
+{
+	reset();
+}
+
+void CommandParser::reset()
+{
+	m_state = IDLE;
+	m_keywordLength = 0;
+	m_hasValue = false;
+	m_negative = false;
+	m_value = 0;
+	m_fractionDigits = 0;
+}
+
+bool CommandParser::feed(char byte, Command &command)
+{
+	if ((byte == '\r') || (byte == '\n')) {
+		if (m_state == IDLE) {
+			return false;
+		}
+		return finish(command);
+	}
+
+	bool blank = ((byte == ' ') || (byte == '\t'));
+	bool digit = ((byte >= '0') && (byte <= '9'));
+	if ((byte >= 'a') && (byte <= 'z')) {
+		byte -= 'a' - 'A';
+	}
+	bool letter = ((byte >= 'A') && (byte <= 'Z'));
+
+	switch (m_state) {
+	case IDLE:
+	case KEYWORD:
+		if (letter && (m_keywordLength < COMMAND_KEYWORD_SIZE)) {
+			m_keyword[m_keywordLength++] = byte;
+			m_state = KEYWORD;
+		} else if (blank) {
+			m_state = (m_state == IDLE) ? IDLE : GAP;
+		} else if (digit || (byte == '+') || (byte == '-')) {
+			/* "B+1" as well as "B +1" */
+			m_state = (m_state == IDLE) ? INVALID : GAP;
+			if (m_state == GAP) {
+				return feed(byte, command);
+			}
+		} else {
+			m_state = INVALID;
+		}
+		break;
+
+	case GAP:
+		if (blank) {
+			break;
+		}
+		m_hasValue = true;
+		if ((byte == '+') || (byte == '-')) {
+			m_negative = (byte == '-');
+			m_state = SIGN;
+		} else if (digit) {
+			m_value = byte - '0';
+			m_state = INTEGER;
+		} else {
+			m_state = INVALID;
+		}
+		break;
+
+	case SIGN:
+	case INTEGER:
+		if (digit) {
+			m_value = m_value * 10 + (byte - '0');
+			m_state = (m_value > COMMAND_VALUE_MAX) ? INVALID : INTEGER;
+		} else if ((byte == '.') && (m_state == INTEGER)) {
+			m_state = FRACTION;
+		} else if (blank && (m_state == INTEGER)) {
+			m_state = TRAILING;
+		} else {
+			m_state = INVALID;
+		}
+		break;
+
+	case FRACTION:
+		if (digit && (m_fractionDigits < COMMAND_FRACTION_DIGITS)) {
+			m_value = m_value * 10 + (byte - '0');
+			m_fractionDigits++;
+			m_state = (m_value > COMMAND_VALUE_MAX) ? INVALID : FRACTION;
+		} else if (blank) {
+			m_state = TRAILING;
+		} else {
+			m_state = INVALID;
+		}
+		break;
+
+	case TRAILING:
+		if (!blank) {
+			m_state = INVALID;
+		}
+		break;
+
+	case INVALID:
+		break;
+	}
+	return false;
+}
+
+bool CommandParser::finish(Command &command)
+{
+	bool integer = m_hasValue && (m_state == INTEGER || m_state == TRAILING) && (m_fractionDigits == 0);
+	bool number = m_hasValue && (m_state == INTEGER || m_state == FRACTION || m_state == TRAILING);
+	int32_t value = m_negative ? -m_value : m_value;
+
+	command.type = CMD_ERROR;
+	command.target = 0;
+	command.value = 0;
+	if ((m_state == INVALID) || (m_state == SIGN)) {
+		/* Error */
+	} else if ((m_keywordLength == 1) && ((m_keyword[0] == 'B') || (m_keyword[0] == 'R')) && integer) {
+		command.type = CMD_SCORE;
+		command.target = m_keyword[0];
+		command.value = value;
+	} else if (keyword_is(m_keyword, m_keywordLength, "RESET") && !m_hasValue) {
+		command.type = CMD_RESET;
+	} else if (keyword_is(m_keyword, m_keywordLength, "SENS") && number && !m_negative) {
+		/* Thousandths whatever the number of fraction digits */
+		for (uint8_t i = m_fractionDigits; i < COMMAND_FRACTION_DIGITS; i++) {
+			value *= 10;
+		}
+		command.type = CMD_SENSITIVITY;
+		command.value = value;
+	} else if (keyword_is(m_keyword, m_keywordLength, "MODE") && integer && !m_negative) {
+		command.type = CMD_MODE;
+		command.value = value;
+	} else if (keyword_is(m_keyword, m_keywordLength, "STATS") && !m_hasValue) {
+		command.type = CMD_STATS;
+	}
+	reset();
+	return true;
+}
+
+CommandQueue::CommandQueue()
+: m_pushed(0), m_popped(0), m_dropped(0)
+{
+}
+
+bool CommandQueue::push(const Command &command)
+{
+	if ((m_pushed - m_popped) >= SLOTS) {
+		m_dropped++;
+		return false;
+	}
+	m_commands[m_pushed % SLOTS] = command;
+	/* Command complete before the consumer can see the slot */
+	__DMB();
+	m_pushed++;
+	return true;
+}
+
+bool CommandQueue::pop(Command &command)
+{
+	if (m_popped == m_pushed) {
+		return false;
+	}
+	__DMB();
+	command = m_commands[m_popped % SLOTS];
+	/* Done with the slot before the producer can reuse it */
+	__DMB();
+	m_popped++;
+	return true;
+}
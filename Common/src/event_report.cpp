@@ -0,0 +1,70 @@
+/**
+*******************************************************************************
+* @file   event_report.cpp
+* @brief  Non-blocking event messages on one or two serial ports
+*******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "event_report.h"
+#include <stdarg.h>
+#include <stdio.h>
+
+/* Defines -------------------------------------------------------------------*/
+#define REPORT_QUEUED_FLAG 0x01
+
+/* Functions definition ------------------------------------------------------*/
+EventReport::EventReport(RawSerial &port)
+: m_port(&port), m_mirror(NULL), m_queued(0), m_sent(0), m_dropped(0), m_truncated(0),
+  m_thread(osPriorityBelowNormal)
+{
+}
+
+EventReport::EventReport(RawSerial &port, RawSerial &mirror)
+: m_port(&port), m_mirror(&mirror), m_queued(0), m_sent(0), m_dropped(0), m_truncated(0),
+  m_thread(osPriorityBelowNormal)
+{
+}
+
+void EventReport::start()
+{
+	m_thread.start(callback(this, &EventReport::run));
+}
+
+bool EventReport::printf(const char *format, ...)
+{
+	if ((m_queued - m_sent) >= SLOTS) {
+		m_dropped++;
+		return false;
+	}
+	va_list args;
+	va_start(args, format);
+	int length = vsnprintf(m_messages[m_queued % SLOTS], MESSAGE_SIZE, format, args);
+	va_end(args);
+	if (length >= MESSAGE_SIZE) {
+		m_truncated++;
+	}
+	/* Message complete before the writer can see the slot */
+	__DMB();
+	m_queued++;
+	m_flags.set(REPORT_QUEUED_FLAG);
+	return true;
+}
+
+void EventReport::run()
+{
+	while (true) {
+		m_flags.wait_any(REPORT_QUEUED_FLAG);
+		while (m_sent != m_queued) {
+			__DMB();
+			const char *message = m_messages[m_sent % SLOTS];
+			m_port->puts(message);
+			if (m_mirror != NULL) {
+				m_mirror->puts(message);
+			}
+			/* Done with the slot before the producer can reuse it */
+			__DMB();
+			m_sent++;
+		}
+	}
+}
@@ -0,0 +1,98 @@
+/**
+*******************************************************************************
+* @file   learn_phase.cpp
+* @brief  Learning phase with early stop on convergence
+*******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "learn_phase.h"
+
+/* Functions definition ------------------------------------------------------*/
+LearnPhase::LearnPhase(const Config &config)
+: m_config(config)
+{
+	if (m_config.checkEvery == 0) {
+		m_config.checkEvery = 1;
+	}
+	if (m_config.stableChecks == 0) {
+		m_config.stableChecks = 1;
+	}
+	if (m_config.stableChecks > CHECKS) {
+		m_config.stableChecks = CHECKS;
+	}
+	reset();
+}
+
+void LearnPhase::reset()
+{
+	m_state = (m_config.maxWindows > 0) ? LEARNING : LIMIT;
+	m_windows = 0;
+	m_sinceCheck = 0;
+	m_checks = 0;
+	for (uint8_t i = 0; i < CHECKS; i++) {
+		m_scores[i] = 0;
+	}
+}
+
+bool LearnPhase::scoreNext() const
+{
+	/* Nothing to score against before the first window is learned */
+	return (m_state == LEARNING) && (m_windows > 0) && (m_sinceCheck >= m_config.checkEvery);
+}
+
+bool LearnPhase::scored(uint8_t score)
+{
+	m_scores[m_checks % CHECKS] = score;
+	m_checks++;
+	m_sinceCheck = 0;
+	if ((m_state != LEARNING) || (m_windows < m_config.minWindows) || (m_checks < m_config.stableChecks)
+	    || (spread() > m_config.tolerance)) {
+		return false;
+	}
+	for (uint8_t i = 1; i <= m_config.stableChecks; i++) {
+		if (m_scores[(m_checks - i) % CHECKS] < m_config.minSimilarity) {
+			return false;
+		}
+	}
+	m_state = CONVERGED;
+	return true;
+}
+
+void LearnPhase::learned()
+{
+	m_windows++;
+	m_sinceCheck++;
+	if ((m_state == LEARNING) && (m_windows >= m_config.maxWindows)) {
+		m_state = LIMIT;
+	}
+}
+
+uint8_t LearnPhase::similarity() const
+{
+	return (m_checks > 0) ? m_scores[(m_checks - 1) % CHECKS] : 0;
+}
+
+uint8_t LearnPhase::spread() const
+{
+	uint32_t count = (m_checks < m_config.stableChecks) ? m_checks : m_config.stableChecks;
+	if (count == 0) {
+		return 0;
+	}
+	uint8_t low = 100;
+	uint8_t high = 0;
+	for (uint32_t i = 1; i <= count; i++) {
+		uint8_t score = m_scores[(m_checks - i) % CHECKS];
+		low = (score < low) ? score : low;
+		high = (score > high) ? score : high;
+	}
+	return (high > low) ? high - low : 0;
+}
+
+uint8_t LearnPhase::progress() const
+{
+	if (done()) {
+		return 100;
+	}
+	return (uint8_t)((uint32_t)m_windows * 100 / m_config.maxWindows);
+}
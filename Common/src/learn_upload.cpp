@@ -0,0 +1,220 @@
+/**
+*******************************************************************************
+* @file   learn_upload.cpp
+* @brief  Binary upload of learning windows from a host
+*******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "learn_upload.h"
+#include "neai_stream.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define CRC16_POLY 0x1021
+#define CRC16_INIT 0xFFFF
+#define LEARN_UPLOAD_FLAG 0x01 /* Frame stored or reply queued */
+
+/* Functions definition ------------------------------------------------------*/
+static uint16_t crc16_update(uint16_t crc, uint8_t byte)
+{
+	crc ^= (uint16_t)byte << 8;
+	for (uint8_t bit = 0; bit < 8; bit++) {
+		crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ CRC16_POLY) : (uint16_t)(crc << 1);
+	}
+	return crc;
+}
+
+LearnUpload::LearnUpload(RawSerial &port, int16_t *storage, uint16_t samples, uint8_t axes)
+: m_port(&port), m_storage(storage), m_samples(samples), m_axes(axes),
+  m_state(SYNC_0), m_count(0), m_length(0), m_crc(CRC16_INIT), m_low(0), m_write(NULL),
+  m_room(false), m_expected(0), m_nakArmed(true),
+  m_pushed(0), m_popped(0), m_naks(0), m_nakSequence(0), m_repeats(0), m_errors(0),
+  m_naksSent(0), m_repeatsSent(0), m_ackPending(false), m_ackSequence(0), m_windows(0),
+  m_finished(false)
+{
+}
+
+void LearnUpload::receive(uint8_t byte)
+{
+	switch (m_state) {
+	case SYNC_0:
+		if (byte == NEAI_STREAM_SYNC_0) {
+			m_state = SYNC_1;
+		}
+		break;
+	case SYNC_1:
+		if (byte == NEAI_STREAM_SYNC_1) {
+			/* Sync bytes are not covered by the CRC */
+			m_crc = CRC16_INIT;
+			m_count = 0;
+			m_state = HEADER;
+		} else if (byte != NEAI_STREAM_SYNC_0) {
+			m_state = SYNC_0;
+		}
+		break;
+	case HEADER:
+		if ((m_count == 0) && (byte != NEAI_STREAM_VERSION)) {
+			/* False sync, e.g. inside noise: keep hunting from this byte */
+			m_state = (byte == NEAI_STREAM_SYNC_0) ? SYNC_1 : SYNC_0;
+			break;
+		}
+		m_crc = crc16_update(m_crc, byte);
+		m_frame[m_count++] = byte;
+		if (m_count == HEADER_SIZE) {
+			startPayload();
+		}
+		break;
+	case PAYLOAD:
+		m_crc = crc16_update(m_crc, byte);
+		if (m_write) {
+			if (m_count & 1) {
+				m_write[m_count >> 1] = (int16_t)(m_low | ((uint16_t)byte << 8));
+			} else {
+				m_low = byte;
+			}
+		}
+		if (++m_count == m_length) {
+			m_count = 0;
+			m_state = CHECK;
+		}
+		break;
+	case CHECK:
+		m_frame[HEADER_SIZE + m_count++] = byte;
+		if (m_count == 2) {
+			endFrame();
+			m_state = SYNC_0;
+		}
+		break;
+	}
+}
+
+void LearnUpload::startPayload()
+{
+	uint8_t axes = m_frame[5];
+	uint16_t samples = m_frame[6] | ((uint16_t)m_frame[7] << 8);
+	if ((axes != m_axes) || ((samples != m_samples) && (samples != 0))) {
+		/* Not a learning frame, or a false sync inside a payload */
+		m_state = SYNC_0;
+		return;
+	}
+	m_room = ((m_pushed - m_popped) < SLOTS);
+	m_write = (m_room && samples) ? &m_storage[(m_pushed % SLOTS) * m_samples * m_axes] : NULL;
+	m_length = 2UL * samples * axes;
+	m_count = 0;
+	m_state = m_length ? PAYLOAD : CHECK;
+}
+
+void LearnUpload::endFrame()
+{
+	uint16_t crc = m_frame[HEADER_SIZE] | ((uint16_t)m_frame[HEADER_SIZE + 1] << 8);
+	if (crc != m_crc) {
+		m_errors++;
+		nak();
+		return;
+	}
+	uint16_t sequence = m_frame[1] | ((uint16_t)m_frame[2] << 8);
+	if (sequence == 0) {
+		/* New upload */
+		m_expected = 0;
+		m_nakArmed = true;
+	}
+	int16_t ahead = (int16_t)(sequence - m_expected);
+	if (ahead < 0) {
+		/* Resent after a lost ACK: acknowledge again, do not learn twice */
+		m_repeats++;
+		wake();
+		return;
+	}
+	if ((ahead > 0) || !m_room) {
+		/* A frame before it was lost, or the host sent more than SLOTS frames */
+		nak();
+		return;
+	}
+	Slot &slot = m_slots[m_pushed % SLOTS];
+	slot.sequence = sequence;
+	slot.range = m_frame[3];
+	slot.end = (m_length == 0);
+	/* Window complete before the consumer can see the slot */
+	__DMB();
+	m_pushed++;
+	m_expected++;
+	m_nakArmed = true;
+	wake();
+}
+
+void LearnUpload::nak()
+{
+	/* One NAK per lost frame, the host times out if the resent frame is lost too */
+	if (!m_nakArmed) {
+		return;
+	}
+	m_nakArmed = false;
+	m_nakSequence = m_expected;
+	__DMB();
+	m_naks++;
+	wake();
+}
+
+const int16_t *LearnUpload::window(uint8_t &range)
+{
+	poll();
+	while (m_popped != m_pushed) {
+		__DMB();
+		const Slot &slot = m_slots[m_popped % SLOTS];
+		if (!slot.end) {
+			range = slot.range;
+			return &m_storage[(m_popped % SLOTS) * m_samples * m_axes];
+		}
+		/* End frame, every window before it has been learned */
+		m_finished = true;
+		release();
+	}
+	return NULL;
+}
+
+void LearnUpload::release()
+{
+	const Slot &slot = m_slots[m_popped % SLOTS];
+	if (!slot.end) {
+		m_windows++;
+	}
+	m_ackSequence = slot.sequence + 1;
+	m_ackPending = true;
+	/* Done with the slot before the producer can reuse it */
+	__DMB();
+	m_popped++;
+	poll();
+}
+
+void LearnUpload::poll()
+{
+	uint32_t naks = m_naks;
+	if (naks != m_naksSent) {
+		__DMB();
+		m_naksSent = naks;
+		reply(LEARN_UPLOAD_NAK, m_nakSequence);
+	}
+	uint32_t repeats = m_repeats;
+	if (m_ackPending || (repeats != m_repeatsSent)) {
+		m_repeatsSent = repeats;
+		m_ackPending = false;
+		reply(LEARN_UPLOAD_ACK, m_ackSequence);
+	}
+}
+
+void LearnUpload::wait()
+{
+	m_flags.wait_any(LEARN_UPLOAD_FLAG);
+}
+
+void LearnUpload::wake()
+{
+	m_flags.set(LEARN_UPLOAD_FLAG);
+}
+
+void LearnUpload::reply(uint8_t code, uint16_t sequence)
+{
+	m_port->putc(code);
+	m_port->putc(sequence & 0xFF);
+	m_port->putc(sequence >> 8);
+}
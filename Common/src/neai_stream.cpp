@@ -0,0 +1,92 @@
+/**
+*******************************************************************************
+* @file   neai_stream.cpp
+* @brief  Binary framed streaming of accelerometer windows
+*******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "neai_stream.h"
+#include <math.h>
+
+/* Defines -------------------------------------------------------------------*/
+#define CRC16_POLY 0x1021
+#define CRC16_INIT 0xFFFF
+
+/* Functions definition ------------------------------------------------------*/
+NeaiStream::NeaiStream(RawSerial &port)
+: m_port(&port), m_mirror(NULL), m_sequence(0), m_crc(CRC16_INIT)
+{
+}
+
+NeaiStream::NeaiStream(RawSerial &port, RawSerial &mirror)
+: m_port(&port), m_mirror(&mirror), m_sequence(0), m_crc(CRC16_INIT)
+{
+}
+
+void NeaiStream::writeWindow(const float *buffer, uint16_t samples, uint8_t axes,
+                             const BMI160::AccConfig &config)
+{
+	float scale = BMI160::getAccScale(config.range);
+	float lsb_per_g = (scale > 0.F) ? (1.F / scale) : (1.F / BMI160::getAccScale(BMI160::SENS_2G));
+
+	beginFrame(samples, axes, config);
+	for (uint32_t i = 0; i < (uint32_t)samples * axes; i++) {
+		long raw = lrintf(buffer[i] * lsb_per_g);
+		if (raw > INT16_MAX) {
+			raw = INT16_MAX;
+		} else if (raw < INT16_MIN) {
+			raw = INT16_MIN;
+		}
+		putWord((uint16_t)(int16_t)raw);
+	}
+	endFrame();
+}
+
+void NeaiStream::writeWindow(const int16_t *buffer, uint16_t samples, uint8_t axes,
+                             const BMI160::AccConfig &config)
+{
+	beginFrame(samples, axes, config);
+	for (uint32_t i = 0; i < (uint32_t)samples * axes; i++) {
+		putWord((uint16_t)buffer[i]);
+	}
+	endFrame();
+}
+
+void NeaiStream::beginFrame(uint16_t samples, uint8_t axes, const BMI160::AccConfig &config)
+{
+	/* Sync bytes are not covered by the CRC */
+	putByte(NEAI_STREAM_SYNC_0);
+	putByte(NEAI_STREAM_SYNC_1);
+	m_crc = CRC16_INIT;
+	putByte(NEAI_STREAM_VERSION);
+	putWord(m_sequence++);
+	putByte(config.range);
+	putByte(config.odr);
+	putByte(axes);
+	putWord(samples);
+}
+
+void NeaiStream::endFrame()
+{
+	uint16_t crc = m_crc;
+	putWord(crc);
+}
+
+void NeaiStream::putByte(uint8_t byte)
+{
+	m_crc ^= (uint16_t)byte << 8;
+	for (uint8_t bit = 0; bit < 8; bit++) {
+		m_crc = (m_crc & 0x8000) ? (uint16_t)((m_crc << 1) ^ CRC16_POLY) : (uint16_t)(m_crc << 1);
+	}
+	m_port->putc(byte);
+	if (m_mirror) {
+		m_mirror->putc(byte);
+	}
+}
+
+void NeaiStream::putWord(uint16_t word)
+{
+	putByte(word & 0xFF);
+	putByte(word >> 8);
+}
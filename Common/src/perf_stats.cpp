@@ -0,0 +1,138 @@
+/**
+*******************************************************************************
+* @file   perf_stats.cpp
+* @brief  Timing and event counters of the acquire, learn and detect loops
+*******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "perf_stats.h"
+#include <stdio.h>
+#ifdef MBED_HOST_H
+#include <chrono>
+#endif
+
+#ifdef PERF_STATS
+
+/* Variables -----------------------------------------------------------------*/
+static const char *const timer_names[PERF_TIMERS] = {
+	"acc_sample", "window", "fifo_drain", "learn", "detect", "report"
+};
+
+PerfTimerStats PerfStats::s_timers[PERF_TIMERS];
+uint32_t PerfStats::s_counters[PERF_COUNTERS];
+
+/* Functions definition ------------------------------------------------------*/
+static void put_line(RawSerial &port, const char *line)
+{
+	while (*line != '\0') {
+		port.putc(*line++);
+	}
+}
+
+void PerfStats::start()
+{
+#if !defined(MBED_HOST_H) && defined(DWT_CTRL_CYCCNTENA_Msk)
+	/* Trace enable, then the cycle counter */
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+	reset();
+}
+
+void PerfStats::reset()
+{
+	memset(s_timers, 0, sizeof(s_timers));
+	memset(s_counters, 0, sizeof(s_counters));
+	for (uint8_t i = 0; i < PERF_TIMERS; i++) {
+		s_timers[i].min = UINT32_MAX;
+	}
+}
+
+#ifdef MBED_HOST_H
+uint32_t PerfStats::ticks()
+{
+	return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+uint32_t PerfStats::clockHz()
+{
+	return 1000000000UL;
+}
+#elif defined(DWT_CTRL_CYCCNTENA_Msk)
+uint32_t PerfStats::clockHz()
+{
+	return SystemCoreClock;
+}
+#else
+uint32_t PerfStats::ticks()
+{
+	/* No cycle counter on this core */
+	return us_ticker_read();
+}
+
+uint32_t PerfStats::clockHz()
+{
+	return 1000000UL;
+}
+#endif
+
+void PerfStats::record(PerfTimer timer, uint32_t ticks)
+{
+	PerfTimerStats &stats = s_timers[timer];
+	stats.count++;
+	stats.total += ticks;
+	if (ticks < stats.min) {
+		stats.min = ticks;
+	}
+	if (ticks > stats.max) {
+		stats.max = ticks;
+	}
+	/* log2 buckets: one count leading zeros instruction on Cortex-M3 and up */
+	uint32_t high = ticks >> PERF_HISTOGRAM_SHIFT;
+	uint32_t bucket = high ? 32 - __builtin_clz(high) : 0;
+	stats.histogram[(bucket < PERF_BUCKETS) ? bucket : PERF_BUCKETS - 1]++;
+}
+
+void PerfStats::dump(RawSerial &port)
+{
+	char line[128];
+	float us = 1e6F / clockHz();
+
+	put_line(port, "timer          count      min us      avg us      max us\n");
+	for (uint8_t i = 0; i < PERF_TIMERS; i++) {
+		const PerfTimerStats &stats = s_timers[i];
+		if (stats.count == 0) {
+			continue;
+		}
+		snprintf(line, sizeof(line), "%-10s %9lu %11.1f %11.1f %11.1f\n", timer_names[i],
+		         (unsigned long)stats.count, stats.min * us, (float)stats.total / stats.count * us,
+		         stats.max * us);
+		put_line(port, line);
+		/* Histogram: upper bound of each non empty bucket, us, and its count */
+		put_line(port, "  <us:n");
+		for (uint8_t b = 0; b < PERF_BUCKETS; b++) {
+			if (stats.histogram[b] == 0) {
+				continue;
+			}
+			if (b == PERF_BUCKETS - 1) {
+				snprintf(line, sizeof(line), " more:%lu", (unsigned long)stats.histogram[b]);
+			} else {
+				snprintf(line, sizeof(line), " %.2f:%lu", (float)(1UL << (b + PERF_HISTOGRAM_SHIFT)) * us,
+				         (unsigned long)stats.histogram[b]);
+			}
+			put_line(port, line);
+		}
+		put_line(port, "\n");
+	}
+	snprintf(line, sizeof(line),
+	         "bus %lu transfers %lu bytes, spins %lu, dropped %lu, duplicates %lu, resampled %lu\n",
+	         (unsigned long)s_counters[PERF_BUS_TRANSFERS], (unsigned long)s_counters[PERF_BUS_BYTES],
+	         (unsigned long)s_counters[PERF_SPINS], (unsigned long)s_counters[PERF_DROPPED],
+	         (unsigned long)s_counters[PERF_DUPLICATES], (unsigned long)s_counters[PERF_RESAMPLED]);
+	put_line(port, line);
+}
+
+#endif /* PERF_STATS */
@@ -0,0 +1,190 @@
+/**
+*******************************************************************************
+* @file   sample_clock.cpp
+* @brief  Sample timestamps from the BMI160 sensor time
+*******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "sample_clock.h"
+#include "bmi160.h"
+#include <math.h>
+#include <string.h>
+
+/* Defines -------------------------------------------------------------------*/
+#define SENSOR_TIME_MASK 0x00FFFFFFUL /* 24 bit counter */
+
+/* Functions definition ------------------------------------------------------*/
+#ifdef WINDOW_INT16
+static int16_t interpolate(int16_t from, int16_t to, float weight)
+{
+	return (int16_t)lrintf(from + (to - from) * weight);
+}
+#else
+static float interpolate(float from, float to, float weight)
+{
+	return from + (to - from) * weight;
+}
+#endif
+
+SampleClock::SampleClock(uint32_t period)
+: m_period(period)
+{
+	reset();
+}
+
+void SampleClock::reset()
+{
+	m_samples = 0;
+	m_count = 0;
+	m_raw = 0;
+	m_time = 0;
+}
+
+void SampleClock::addRun(uint32_t time, uint16_t lost)
+{
+	Run &run = m_runs[m_count % SAMPLE_CLOCK_RUNS];
+	run.sample = m_samples;
+	run.time = time;
+	run.lost = lost;
+	m_count++;
+}
+
+void SampleClock::addFrames(uint16_t frames, uint32_t time, uint16_t pending)
+{
+	if (frames == 0) {
+		return;
+	}
+	m_time = (m_count == 0) ? time : m_time + ((time - m_raw) & SENSOR_TIME_MASK);
+	m_raw = time;
+	/* Newest frame on the last grid point, the first one drained before it */
+	uint32_t newest = m_time - (m_time % m_period);
+	uint32_t first = newest - (uint32_t)(pending + frames - 1) * m_period;
+	if (m_count == 0) {
+		addRun(first, 0);
+	} else {
+		const Run &last = run(m_count - 1);
+		int32_t late = (int32_t)(first - (last.time + (m_samples - last.sample) * m_period));
+		if (late != 0) {
+			/* Later than the grid: samples lost. Earlier: the FIFO was read out of step */
+			uint32_t lost = (late > 0) ? (uint32_t)late / m_period : 0;
+			addRun(first, (lost > UINT16_MAX) ? UINT16_MAX : lost);
+		}
+	}
+	m_samples += frames;
+}
+
+bool SampleClock::window(uint16_t samples, WindowTiming &timing) const
+{
+	memset(&timing, 0, sizeof(timing));
+	timing.period = m_period;
+	if ((samples == 0) || (samples > m_samples) || (m_count == 0)) {
+		return false;
+	}
+	uint32_t start = m_samples - samples;
+	uint32_t oldest = (m_count > SAMPLE_CLOCK_RUNS) ? m_count - SAMPLE_CLOCK_RUNS : 0;
+	const Run &newest = run(m_count - 1);
+	timing.last = newest.time + (m_samples - 1 - newest.sample) * m_period;
+
+	/* Newest run first, back to the one holding the first sample */
+	float steps[SAMPLE_CLOCK_RUNS];
+	uint8_t numSteps = 0;
+	uint32_t n = m_count - 1;
+	while (run(n).sample > start) {
+		if (n == oldest) {
+			return false;
+		}
+		/* Interval between the last sample of the previous run and this run */
+		const Run &current = run(n);
+		const Run &previous = run(n - 1);
+		uint32_t before = previous.time + (current.sample - 1 - previous.sample) * m_period;
+		steps[numSteps++] = (float)(int32_t)(current.time - before);
+		if (current.lost > 0) {
+			timing.missing += current.lost;
+			if (timing.gaps < SAMPLE_CLOCK_GAPS) {
+				timing.gapAt[timing.gaps] = current.sample - start;
+				timing.gapLength[timing.gaps] = current.lost;
+			}
+			if (timing.gaps < UINT8_MAX) {
+				timing.gaps++;
+			}
+		}
+		n--;
+	}
+	timing.first = run(n).time + (start - run(n).sample) * m_period;
+	timing.valid = true;
+
+	/* Gaps listed oldest first */
+	uint8_t listed = (timing.gaps < SAMPLE_CLOCK_GAPS) ? timing.gaps : SAMPLE_CLOCK_GAPS;
+	for (uint8_t i = 0; i < listed / 2; i++) {
+		uint16_t at = timing.gapAt[i];
+		uint16_t length = timing.gapLength[i];
+		timing.gapAt[i] = timing.gapAt[listed - 1 - i];
+		timing.gapLength[i] = timing.gapLength[listed - 1 - i];
+		timing.gapAt[listed - 1 - i] = at;
+		timing.gapLength[listed - 1 - i] = length;
+	}
+
+	uint32_t span = timing.last - timing.first;
+	if ((samples < 2) || (span == 0)) {
+		timing.odr = (float)BMI160::SENSOR_TIME_HZ / m_period;
+		return true;
+	}
+	/* Every interval is one period but those between runs */
+	uint16_t intervals = samples - 1;
+	float mean = (float)span / intervals;
+	float deviation = (float)m_period - mean;
+	float sum = (intervals - numSteps) * deviation * deviation;
+	for (uint8_t i = 0; i < numSteps; i++) {
+		deviation = steps[i] - mean;
+		sum += deviation * deviation;
+	}
+	timing.odr = (float)BMI160::SENSOR_TIME_HZ / mean;
+	timing.jitter = sqrtf(sum / intervals) * 1e6F / BMI160::SENSOR_TIME_HZ;
+	return true;
+}
+
+bool SampleClock::resample(const WindowTiming &timing, acc_sample_t *window, uint16_t samples, uint8_t axes)
+{
+	if (!timing.valid || (timing.missing == 0) || (timing.gaps > SAMPLE_CLOCK_GAPS)) {
+		return false;
+	}
+	/*
+	 * Positions in periods from the first sample: sample j is at j plus the
+	 * samples lost before it, output k at k + missing. The input sample at or
+	 * before an output position is never before it in the window, so the
+	 * window can be overwritten from its start.
+	 */
+	uint16_t j = 0;
+	uint32_t lost = 0;
+	uint8_t gap = 0;
+	for (uint16_t k = 0; k < samples; k++) {
+		uint32_t target = k + timing.missing;
+		uint32_t next = 0;
+		while (j + 1 < samples) {
+			uint32_t nextLost = lost;
+			if ((gap < timing.gaps) && (timing.gapAt[gap] == j + 1)) {
+				nextLost += timing.gapLength[gap];
+			}
+			next = j + 1 + nextLost;
+			if (next > target) {
+				break;
+			}
+			if (nextLost != lost) {
+				gap++;
+			}
+			lost = nextLost;
+			j++;
+		}
+		uint32_t position = j + lost;
+		if ((position == target) || (j + 1 == samples)) {
+			memmove(&window[k * axes], &window[j * axes], axes * sizeof(acc_sample_t));
+			continue;
+		}
+		float weight = (float)(target - position) / (next - position);
+		for (uint8_t a = 0; a < axes; a++) {
+			window[k * axes + a] = interpolate(window[j * axes + a], window[(j + 1) * axes + a], weight);
+		}
+	}
+	return true;
+}
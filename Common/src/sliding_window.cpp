@@ -0,0 +1,66 @@
+/**
+*******************************************************************************
+* @file   sliding_window.cpp
+* @brief  Overlapping windows over a continuous sample stream
+*******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "sliding_window.h"
+#include <string.h>
+
+/* Functions definition ------------------------------------------------------*/
+SlidingWindow::SlidingWindow(acc_sample_t *storage, uint16_t samples, uint8_t axes, uint16_t hop)
+: m_storage(storage), m_samples(samples), m_axes(axes), m_hop(hop), m_head(0), m_remaining(samples)
+{
+}
+
+void SlidingWindow::reset()
+{
+	m_head = 0;
+	m_remaining = m_samples;
+}
+
+acc_sample_t *SlidingWindow::writeBuffer(uint16_t &room)
+{
+	room = m_samples - m_head;
+	if (room > m_remaining) {
+		room = m_remaining;
+	}
+	return &m_storage[m_head * m_axes];
+}
+
+bool SlidingWindow::commitSamples(uint16_t samples)
+{
+	/* Mirror the new samples one window further */
+	memcpy(&m_storage[(m_head + m_samples) * m_axes], &m_storage[m_head * m_axes],
+		samples * m_axes * sizeof(acc_sample_t));
+	m_head += samples;
+	if (m_head == m_samples) {
+		m_head = 0;
+	}
+	m_remaining -= samples;
+	if (m_remaining > 0) {
+		return false;
+	}
+	m_remaining = m_hop;
+	return true;
+}
+
+bool SlidingWindow::push(const acc_sample_t *data, uint16_t samples)
+{
+	uint16_t room;
+	while (samples > 0) {
+		acc_sample_t *buffer = writeBuffer(room);
+		if (room > samples) {
+			room = samples;
+		}
+		memcpy(buffer, data, room * m_axes * sizeof(acc_sample_t));
+		data += room * m_axes;
+		samples -= room;
+		if (commitSamples(room)) {
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,141 @@
+/**
+*******************************************************************************
+* @file   step_detector.cpp
+* @brief  Streaming step counter, O(1) per sample
+*******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "step_detector.h"
+
+/* Variables -----------------------------------------------------------------*/
+const StepDetector::Config StepDetector::DEFAULT_CONFIG = {1, 25, 0.15F, 0.2F};
+
+/* Functions definition ------------------------------------------------------*/
+StepDetector::StepDetector(const Config &config)
+: m_config(config)
+{
+	if (m_config.decimation == 0) {
+		m_config.decimation = 1;
+	}
+	reset();
+}
+
+void StepDetector::reset()
+{
+	for (uint8_t axis = 0; axis < 3; axis++) {
+		m_max[axis].front = m_max[axis].count = 0;
+		m_min[axis].front = m_min[axis].count = 0;
+		m_sum[axis] = 0.F;
+	}
+	m_summed = 0;
+	m_index = 0;
+	m_filled = 0;
+	m_sinceStep = m_config.minInterval;
+	m_armed = false;
+	m_steps = 0;
+}
+
+bool StepDetector::addSample(float x, float y, float z)
+{
+	m_sum[0] += x;
+	m_sum[1] += y;
+	m_sum[2] += z;
+	if (++m_summed < m_config.decimation) {
+		return false;
+	}
+
+	/* New decimated sample */
+	m_index++;
+	for (uint8_t axis = 0; axis < 3; axis++) {
+		/* The slot is reused, expire its sample first */
+		expire(m_max[axis]);
+		expire(m_min[axis]);
+		m_history[axis][m_index % WINDOW] = m_sum[axis] / m_summed;
+		m_sum[axis] = 0.F;
+		push(m_max[axis], m_history[axis], true);
+		push(m_min[axis], m_history[axis], false);
+	}
+	m_summed = 0;
+	if (m_filled < WINDOW) {
+		m_filled++;
+	}
+	if (m_sinceStep < 0xFFFF) {
+		m_sinceStep++;
+	}
+	return detect();
+}
+
+uint16_t StepDetector::addSamples(const acc_sample_t *xyz, uint16_t samples, float scale)
+{
+	uint16_t steps = 0;
+	for (uint16_t i = 0; i < samples; i++, xyz += 3) {
+		if (addSample(acc_sample_to_g(xyz[0], scale), acc_sample_to_g(xyz[1], scale),
+		              acc_sample_to_g(xyz[2], scale))) {
+			steps++;
+		}
+	}
+	return steps;
+}
+
+void StepDetector::push(Deque &deque, const float *history, bool isMax)
+{
+	float value = history[m_index % WINDOW];
+	/* Drop the samples the new one dominates until the end of their life */
+	while (deque.count > 0) {
+		uint16_t back = deque.index[(deque.front + deque.count - 1) % WINDOW];
+		float other = history[back % WINDOW];
+		if (isMax ? (other > value) : (other < value)) {
+			break;
+		}
+		deque.count--;
+	}
+	deque.index[(deque.front + deque.count) % WINDOW] = m_index;
+	deque.count++;
+}
+
+void StepDetector::expire(Deque &deque)
+{
+	/* Drop the front once it leaves the window */
+	if (deque.count > 0 && (uint16_t)(m_index - deque.index[deque.front]) >= WINDOW) {
+		deque.front = (deque.front + 1) % WINDOW;
+		deque.count--;
+	}
+}
+
+bool StepDetector::detect()
+{
+	/* Half a window of history before the threshold means anything */
+	if (m_filled < WINDOW / 2) {
+		return false;
+	}
+
+	uint8_t dominant = 0;
+	float range = -1.F;
+	for (uint8_t axis = 0; axis < 3; axis++) {
+		float axis_range = m_history[axis][m_max[axis].index[m_max[axis].front] % WINDOW]
+		                 - m_history[axis][m_min[axis].index[m_min[axis].front] % WINDOW];
+		if (axis_range > range) {
+			range = axis_range;
+			dominant = axis;
+		}
+	}
+	if (range < m_config.minRange) {
+		m_armed = false;
+		return false;
+	}
+
+	float high = m_history[dominant][m_max[dominant].index[m_max[dominant].front] % WINDOW];
+	float middle = high - range / 2.F;
+	float band = m_config.hysteresis * range;
+	float value = m_history[dominant][m_index % WINDOW];
+	if (value < middle - band) {
+		m_armed = true;
+	} else if (m_armed && value > middle + band && m_sinceStep >= m_config.minInterval) {
+		m_armed = false;
+		m_sinceStep = 0;
+		m_steps++;
+		return true;
+	}
+	return false;
+}
@@ -0,0 +1,76 @@
+/**
+*******************************************************************************
+* @file   trigger_window.cpp
+* @brief  Window around an event from a continuously filled ring
+*******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "trigger_window.h"
+#include <string.h>
+
+/* Functions definition ------------------------------------------------------*/
+TriggerWindow::TriggerWindow(acc_sample_t *storage, uint16_t samples, uint16_t slack, uint8_t axes,
+                             uint16_t preTrigger)
+: m_storage(storage), m_samples(samples), m_slack(slack), m_capacity(samples + slack), m_axes(axes),
+  m_preTrigger(preTrigger)
+{
+	reset();
+}
+
+void TriggerWindow::reset()
+{
+	m_head = 0;
+	m_count = 0;
+	m_triggered = false;
+	m_event = 0;
+	m_start = 0;
+	m_pending = 0;
+}
+
+acc_sample_t *TriggerWindow::writeBuffer(uint16_t &room)
+{
+	room = m_capacity - m_head;
+	if (m_triggered) {
+		/* Stop at the end of the window, its oldest samples must stay */
+		if (room > m_pending) {
+			room = m_pending;
+		}
+	} else if (room > m_slack) {
+		room = m_slack;
+	}
+	return &m_storage[m_head * m_axes];
+}
+
+bool TriggerWindow::commitSamples(uint16_t samples)
+{
+	/* Mirror the new samples one ring further */
+	memcpy(&m_storage[(m_head + m_capacity) * m_axes], &m_storage[m_head * m_axes],
+		samples * m_axes * sizeof(acc_sample_t));
+	m_head += samples;
+	if (m_head == m_capacity) {
+		m_head = 0;
+	}
+	m_count += samples;
+	if (m_count > m_capacity) {
+		m_count = m_capacity;
+	}
+	if (m_triggered) {
+		m_pending -= samples;
+	}
+	return ready();
+}
+
+bool TriggerWindow::trigger(uint16_t age)
+{
+	if ((uint32_t)age + 1 + m_preTrigger > m_count) {
+		return false;
+	}
+	uint16_t post = m_samples - m_preTrigger; /* Event included */
+	m_event = (m_head + m_capacity - 1 - age) % m_capacity;
+	m_start = (m_event + m_capacity - m_preTrigger) % m_capacity;
+	/* 0 if the event was seen late: the window ends before the latest sample */
+	m_pending = (age + 1 < post) ? post - (age + 1) : 0;
+	m_triggered = true;
+	return true;
+}
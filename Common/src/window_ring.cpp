@@ -0,0 +1,69 @@
+/**
+*******************************************************************************
+* @file   window_ring.cpp
+* @brief  N-slot ring of sample windows shared by a producer and a consumer
+*******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "window_ring.h"
+
+/* Functions definition ------------------------------------------------------*/
+WindowRing::WindowRing(acc_sample_t *storage, uint8_t slots, uint16_t samples, uint8_t axes)
+: m_storage(storage), m_slots(slots), m_samples(samples), m_axes(axes), m_fill(0),
+  m_dropping(false), m_written(0), m_released(0), m_overruns(0), m_dropped(0)
+{
+}
+
+acc_sample_t *WindowRing::writeBuffer(uint16_t &room)
+{
+	if ((m_written - m_released) >= m_slots) {
+		room = 0;
+		return NULL;
+	}
+	m_dropping = false;
+	room = m_samples - m_fill;
+	return &m_storage[((m_written % m_slots) * m_samples + m_fill) * m_axes];
+}
+
+bool WindowRing::commitSamples(uint16_t samples)
+{
+	m_fill += samples;
+	if (m_fill < m_samples) {
+		return false;
+	}
+	m_fill = 0;
+	/* Window content must be visible before the consumer can see the slot */
+	__DMB();
+	m_written++;
+	return true;
+}
+
+void WindowRing::dropSamples(uint32_t samples)
+{
+	/* A full ring with nothing to write is not an overrun */
+	if (samples == 0) {
+		return;
+	}
+	if (!m_dropping) {
+		m_dropping = true;
+		m_overruns++;
+	}
+	m_dropped += samples;
+}
+
+acc_sample_t *WindowRing::readBuffer()
+{
+	if (m_released == m_written) {
+		return NULL;
+	}
+	__DMB();
+	return &m_storage[(m_released % m_slots) * m_samples * m_axes];
+}
+
+void WindowRing::release()
+{
+	/* Done with the window before the producer can reuse the slot */
+	__DMB();
+	m_released++;
+}
@@ -0,0 +1,141 @@
+import argparse
+import struct
+import sys
+import time
+
+# Frame layout, see Common/inc/neai_stream.h, replies see Common/inc/learn_upload.h
+SYNC = b"\xa5\x5a"
+VERSION = 1
+HEADER = struct.Struct("<BHBBBH")
+CRC = struct.Struct("<H")
+ACK = 0x06
+NAK = 0x15
+SLOTS = 2
+
+# Full scale in g -> ACC_RANGE register value, LSB per g
+RANGES = {2: (0x03, 16384.0), 4: (0x05, 8192.0), 8: (0x08, 4096.0), 16: (0x0C, 2048.0)}
+ODR_1600HZ = 0x0C
+
+# Functions
+# Read arguments
+def define_args():
+    parser = argparse.ArgumentParser(description="Upload learning windows to a NanoEdge AI application as binary frames")
+    parser.add_argument('--port', type=str, required=True, help="serial port of the board")
+    parser.add_argument('--baud', type=int, default=9600)
+    parser.add_argument('--input', type=str, required=True, help="text file, one window of values in g per line (e.g. learning_data.txt)")
+    parser.add_argument('--axes', type=int, default=3)
+    parser.add_argument('--samples', type=int, default=128)
+    parser.add_argument('--range', type=int, default=2, choices=sorted(RANGES), help="accelerometer full scale, g")
+    parser.add_argument('--count', type=int, help="windows to send, all by default")
+    parser.add_argument('--timeout', type=float, default=3.0, help="seconds without a reply before resending")
+    parser.add_argument('--retries', type=int, default=5, help="timeouts in a row before giving up")
+    return parser.parse_args()
+
+# CRC-16/CCITT-FALSE
+def crc16(data, crc=0xFFFF):
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+# Read the windows of the text file, values in g
+def read_windows(path, size):
+    with open(path, "r") as text:
+        values = [float(token) for token in text.read().split()]
+    if len(values) % size:
+        sys.stderr.write("%d trailing values ignored\n" % (len(values) % size))
+    return [values[i:i + size] for i in range(0, len(values) - size + 1, size)]
+
+# Build the frame of a window, an empty window ends the upload
+def make_frame(seq, range_code, lsb, axes, values, stats):
+    counts = []
+    for value in values:
+        count = int(round(value * lsb))
+        if count > 32767 or count < -32768:
+            stats["clipped"] += 1
+            count = max(-32768, min(32767, count))
+        counts.append(count)
+    body = HEADER.pack(VERSION, seq & 0xFFFF, range_code, ODR_1600HZ, axes, len(counts) // axes)
+    body += struct.pack("<%dh" % len(counts), *counts)
+    return SYNC + body + CRC.pack(crc16(body))
+
+# Wait for the next ACK or NAK, other bytes (e.g. text) are skipped
+def read_reply(ser, pending, deadline):
+    while True:
+        for i in range(len(pending)):
+            if pending[i] in (ACK, NAK):
+                if len(pending) - i < 3:
+                    del pending[:i]
+                    break
+                code, seq = pending[i], pending[i + 1] | (pending[i + 2] << 8)
+                del pending[:i + 3]
+                return code, seq
+        else:
+            del pending[:]
+        remaining = deadline - time.time()
+        if remaining <= 0:
+            return None
+        ser.timeout = remaining
+        pending += ser.read(max(1, ser.in_waiting))
+
+# The application entry point
+def main():
+    args = define_args()
+    range_code, lsb = RANGES[args.range]
+    windows = read_windows(args.input, args.axes * args.samples)
+    if args.count is not None:
+        windows = windows[:args.count]
+    stats = {"clipped": 0, "resent": 0}
+    frames = [make_frame(seq, range_code, lsb, args.axes, values, stats) for seq, values in enumerate(windows)]
+    frames.append(make_frame(len(windows), range_code, lsb, args.axes, [], stats))
+    if stats["clipped"]:
+        sys.stderr.write("%d values clipped to the +-%dg range\n" % (stats["clipped"], args.range))
+
+    import serial
+    ser = serial.Serial(args.port, args.baud, timeout=args.timeout)
+    ser.reset_input_buffer()
+
+    # Go-back-N: at most SLOTS frames not acknowledged
+    base = 0
+    sent = 0
+    timeouts = 0
+    pending = bytearray()
+    start = time.time()
+    while base < len(frames):
+        while sent < len(frames) and sent - base < SLOTS:
+            ser.write(frames[sent])
+            sent += 1
+        reply = read_reply(ser, pending, time.time() + args.timeout)
+        if reply is None:
+            timeouts += 1
+            if timeouts > args.retries:
+                sys.stderr.write("\nNo reply from the board, %d windows learned\n" % min(base, len(windows)))
+                return 1
+            stats["resent"] += sent - base
+            sent = base
+            continue
+        code, seq = reply
+        index = base + ((seq - base) & 0xFFFF)
+        if code == ACK and base < index <= sent:
+            base = index
+            timeouts = 0
+            elapsed = time.time() - start
+            if base <= len(windows) and elapsed > 0:
+                sys.stderr.write("\r%d/%d windows, %.2f windows/s" % (base, len(windows), base / elapsed))
+        elif code == NAK and base <= index < sent:
+            stats["resent"] += sent - index
+            sent = index
+
+    elapsed = time.time() - start
+    # 10 bits per byte on the UART
+    link = args.baud / 10.0 / len(frames[0]) if windows else 0.0
+    sys.stderr.write("\n%d windows learned in %.1f s: %.2f windows/s, link limit %.2f windows/s, %d frames resent\n"
+                     % (len(windows), elapsed, len(windows) / elapsed if elapsed > 0 else 0.0, link, stats["resent"]))
+    return 0
+
+#-------------------------------------------------------------------------------
+# Execution from shell
+if __name__ == "__main__":
+    sys.exit(main())
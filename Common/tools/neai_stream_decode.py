@@ -0,0 +1,94 @@
+import argparse
+import struct
+import sys
+
+# Frame layout, see Common/inc/neai_stream.h
+SYNC = b"\xa5\x5a"
+VERSION = 1
+HEADER = struct.Struct("<BHBBBH")
+CRC = struct.Struct("<H")
+
+# ACC_RANGE register value -> LSB per g
+LSB_PER_G = {0x03: 16384.0, 0x05: 8192.0, 0x08: 4096.0, 0x0C: 2048.0}
+
+# Functions
+# Read arguments
+def define_args():
+    parser = argparse.ArgumentParser(description="Decode NanoEdge AI binary window frames into NanoEdge AI Studio text lines")
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument('--port', type=str, help="serial port to read from")
+    source.add_argument('--input', type=str, help="file holding a raw capture")
+    parser.add_argument('--baud', type=int, default=115200)
+    parser.add_argument('--output', type=str, help="output file, stdout by default")
+    return parser.parse_args()
+
+# CRC-16/CCITT-FALSE
+def crc16(data, crc=0xFFFF):
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+# Rebuild the "%.4f " text line of a window
+def window_to_line(range_code, values):
+    lsb = LSB_PER_G.get(range_code, 16384.0)
+    return " ".join("%.4f" % (value / lsb) for value in values)
+
+# Extract every complete frame from buf, return the unconsumed tail
+def parse(buf, on_window):
+    while True:
+        start = buf.find(SYNC)
+        if start < 0:
+            return buf[-1:]
+        if start + 2 + HEADER.size > len(buf):
+            return buf[start:]
+        version, seq, range_code, odr, axes, samples = HEADER.unpack_from(buf, start + 2)
+        length = 2 + HEADER.size + 2 * axes * samples + CRC.size
+        if version != VERSION:
+            buf = buf[start + 1:]
+            continue
+        if start + length > len(buf):
+            return buf[start:]
+        body = buf[start + 2:start + length - CRC.size]
+        (crc,) = CRC.unpack_from(buf, start + length - CRC.size)
+        if crc16(body) != crc:
+            buf = buf[start + 1:]
+            continue
+        values = struct.unpack_from("<%dh" % (axes * samples), body, HEADER.size)
+        on_window(seq, range_code, odr, values)
+        buf = buf[start + length:]
+
+# The application entry point
+def main():
+    args = define_args()
+    out = open(args.output, "w") if args.output else sys.stdout
+    state = {"last": None, "windows": 0, "lost": 0}
+
+    def on_window(seq, range_code, odr, values):
+        if state["last"] is not None:
+            state["lost"] += (seq - state["last"] - 1) & 0xFFFF
+        state["last"] = seq
+        state["windows"] += 1
+        out.write(window_to_line(range_code, values) + "\n")
+        out.flush()
+
+    buf = b""
+    try:
+        if args.input:
+            with open(args.input, "rb") as capture:
+                parse(capture.read(), on_window)
+        else:
+            import serial
+            ser = serial.Serial(args.port, args.baud, timeout=1)
+            while True:
+                buf = parse(buf + ser.read(max(1, ser.in_waiting)), on_window)
+    except KeyboardInterrupt:
+        pass
+    sys.stderr.write("%d windows decoded, %d lost\n" % (state["windows"], state["lost"]))
+
+#-------------------------------------------------------------------------------
+# Execution from shell
+if __name__ == "__main__":
+    sys.exit(main())
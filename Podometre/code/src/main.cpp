@@ -1,8 +1,17 @@
 /* Includes ------------------------------------------------------------------*/
 #include "mbed.h"
 #include "bmi160.h"
+#include "acc_acquisition.h"
+#include "window.h"
+#ifdef NEAI_LIB
+#include "event_report.h"
+#endif
 #ifndef DATA_LOGGING
 #include "NanoEdgeAI.h"
+#include "learn_phase.h"
+#endif
+#ifdef LOG_BINARY
+#include "neai_stream.h"
 #endif
 #include <math.h>
 
@@ -11,37 +20,51 @@
 #define DATA_LOGGING
 #endif
 #ifdef DATA_LOGGING
-#define DATA_INPUT_USER 128
-#define AXIS_NUMBER 3
 #define LOG_NUMBER 50
 #else
-#define LEARNING_NUMBER 20 /* Number of learning signals */
+#define LEARN_HOLDOFF_MS 1000 /* No new learning shock right after a window, from the window end */
+#endif
+
+/* Types ---------------------------------------------------------------------*/
+/* Samples and axes of every window, logged, learned or scored */
+typedef Window<256, 3, float> AccWindow;
+#ifndef DATA_LOGGING
+NEAI_WINDOW_CHECK(AccWindow);
 #endif
 
 /* Objects -------------------------------------------------------------------*/
-Serial pc(USBTX, USBRX);
-Serial bt(D5, D4, 9600);
+RawSerial pc(USBTX, USBRX);
+RawSerial bt(D5, D4, 9600);
 Ticker toggle_led_ticker;
 DigitalOut myled(LED2);
 I2C i2c(D0, D1);
 BMI160_I2C imu(i2c, BMI160_I2C::I2C_ADRS_SDO_HI);
+InterruptIn imu_int(D2); /* BMI160 INT1 */
+AccAcquisition acq(imu, imu_int);
 BMI160::AccConfig accConfig;
+BMI160::FifoConfig fifoConfig;
 BMI160::SensorData accData;
+#ifdef LOG_BINARY
+NeaiStream log_stream(pc, bt);
+#endif
+#ifdef NEAI_LIB
+EventReport report(pc, bt); /* Game messages, detection never waits for the UARTs */
+Timer learn_timer;
+#endif
 
 /* Variables -----------------------------------------------------------------*/
 float acc_x = 0.F;
 float acc_y = 0.F;
 float acc_z = 0.F;
-float last_acc_x = 0.F;
-float last_acc_y = 0.F;
-float last_acc_z = 0.F;
 #ifndef DATA_LOGGING
 uint8_t similarity = 0;
-uint16_t learn_cpt = 0;
+/* 8 to 20 shocks, a shock scored every 2, stop on 3 scores over the play threshold within 10 points */
+const LearnPhase::Config learn_config = {8, 20, 2, 3, 10, 90};
 #endif
 
 /* Buffer with accelerometer values for x-, y- and z-axis --------------------*/
-float acc_buffer[DATA_INPUT_USER * AXIS_NUMBER] = {0.F};
+AccWindow acc_window;
+float *const acc_buffer = acc_window.values;
 
 
 /* Functions prototypes ------------------------------------------------------*/
@@ -121,7 +144,9 @@ void neai_library_test_mode()
 {
 	float start = 0;
 	/* Learning process */
-	while (learn_cpt < LEARNING_NUMBER)
+	/* Shocks learned until the similarity of the shocks not learned yet is stable (see learn_phase.h) */
+	LearnPhase learn_phase(learn_config);
+	while (!learn_phase.done())
 	{
 		get_acc_values();
 		start = fabs(acc_x)+fabs(acc_y)+fabs(acc_z);
@@ -134,18 +159,34 @@ void neai_library_test_mode()
 			
 			/* Logging process */
 			fill_acc_buffer();
+			learn_timer.reset();
+			learn_timer.start();
+			/* Scored before it is learned: the model has never seen this shock */
+			if (learn_phase.scoreNext())
+			{
+				learn_phase.scored(NanoEdgeAI_detect(acc_buffer));
+				report.printf("LEARN %u shocks, similarity %u, spread %u\n", learn_phase.windows(),
+				              learn_phase.similarity(), learn_phase.spread());
+			}
 			NanoEdgeAI_learn(acc_buffer);
-			pc.printf("%d percent \n", (int)(learn_cpt * 100) / LEARNING_NUMBER);
-			bt.printf("%d percent \n", (int)(learn_cpt * 100) / LEARNING_NUMBER);
-			learn_cpt ++;
+			learn_phase.learned();
+			report.printf("%u percent \n", learn_phase.progress());
 
-			wait_ms(1000);
+			/* Learning ran during the hold-off */
+			int holdoff = LEARN_HOLDOFF_MS - learn_timer.read_ms();
+			if (holdoff > 0)
+			{
+				wait_ms(holdoff);
+			}
 
 			/* Stop blink LED (end of logging process) */
 			toggle_led_ticker.detach();
 			myled = 0;
 		}
 	}
+	report.printf("LEARN %s after %u shocks\n",
+	              (learn_phase.state() == LearnPhase::CONVERGED) ? "converged" : "stopped",
+	              learn_phase.windows());
 		
 	/* Detection process */
 	/* LED off: no movement */
@@ -167,15 +208,13 @@ void neai_library_test_mode()
 			{
 				myled = 1;
 				points ++;
-				pc.printf("Points : %d\n", points);
-				bt.printf("Points : %d\n", points);
+				report.printf("Points : %d\n", points);
 				wait_ms(2000);
 				myled = 0;
 			}
 			if (points >= 10)
 			{
-				pc.printf("End of the game\n");
-				bt.printf("End of the game\n");
+				report.printf("End of the game\n");
 				points = 0;
 			}
 
@@ -190,6 +229,7 @@ void init()
 	init_bmi160();
 	#ifdef NEAI_LIB
 		NanoEdgeAI_initialize();
+		report.start();
 	#endif
 }
 
@@ -202,6 +242,10 @@ void init_bmi160()
 	accConfig.bwp = BMI160::ACC_BWP_2;
 	accConfig.odr = BMI160::ACC_ODR_12; /* Accelerometer output data rate < 800Hz */
 	imu.setSensorConfig(accConfig);
+	fifoConfig = BMI160::DEFAULT_FIFO_CONFIG; /* Headerless accelerometer frames */
+	imu.setFifoConfig(fifoConfig);
+	/* Data ready interrupt on INT1, one pulse per new sample */
+	acq.start(accConfig.range, BMI160::INT1);
 	wait_ms(100);
 }
 
@@ -214,40 +258,33 @@ void toggle_led()
 
 void fill_acc_buffer()
 {
-	for (uint16_t i = 0; i < DATA_INPUT_USER; i++)
-	{
-		get_acc_values();
-		acc_buffer[AXIS_NUMBER * i] = acc_x;
-		acc_buffer[AXIS_NUMBER * i + 1] = acc_y;
-		acc_buffer[AXIS_NUMBER * i + 2] = acc_z;
-	}
+	/* FIFO method: drain whole bursts of samples straight into the buffer */
+	acq.fillWindow(acc_buffer, AccWindow::SAMPLES);
 }
 
 void fill_acc_buffer_print()
 {
-	for (uint16_t isample = 0; isample < AXIS_NUMBER * DATA_INPUT_USER - 1; isample++)
+#ifdef LOG_BINARY
+	/* One binary frame per window, decoded by Common/tools/neai_stream_decode.py */
+	log_stream.writeWindow(acc_buffer, AccWindow::SAMPLES, AccWindow::AXES, accConfig);
+#else
+	for (uint16_t isample = 0; isample < AccWindow::VALUES - 1; isample++)
 	{
 		pc.printf("%.4f ", acc_buffer[isample]);
 		bt.printf("%.4f ", acc_buffer[isample]);
 	}
-	pc.printf("%.4f\n", acc_buffer[AXIS_NUMBER * DATA_INPUT_USER - 1]);
-	bt.printf("%.4f\n", acc_buffer[AXIS_NUMBER * DATA_INPUT_USER - 1]);
+	pc.printf("%.4f\n", acc_buffer[AccWindow::VALUES - 1]);
+	bt.printf("%.4f\n", acc_buffer[AccWindow::VALUES - 1]);
+#endif
 }
 
 void get_acc_values()
 {
-	/* Polling method to get a complete buffer */
-	do {
-		imu.getSensorXYZ(accData, accConfig.range);
-		acc_x = accData.xAxis.scaled;
-		acc_y = accData.yAxis.scaled;
-		acc_z = accData.zAxis.scaled;
-	}
-	while (acc_x == last_acc_x && acc_y == last_acc_y && acc_z == last_acc_z);
-	
-	last_acc_x = acc_x;
-	last_acc_y = acc_y;
-	last_acc_z = acc_z;
+	/* Interrupt method: sleep until the next sample is ready */
+	acq.readSample(accData);
+	acc_x = accData.xAxis.scaled;
+	acc_y = accData.yAxis.scaled;
+	acc_z = accData.zAxis.scaled;
 }
 
 /* END CODE-------------------------------------------------------------------*/
\ No newline at end of file
@@ -8,6 +8,15 @@
 * Compiler Flags
 * -DDATA_LOGGING : data logging mode for collecting data
 * -DNEAI_LIB     : test mode with NanoEdge AI Library
+* -DLOG_BINARY   : binary framed windows instead of text (see neai_stream.h)
+* -DNEAI_HOP=<n> : new samples between two detections, dividing the
+*                  window, a whole window by default (no overlap)
+* -DWINDOW_INT16 : windows stored as raw int16 counts, half the RAM
+* -DPERF_STATS   : timing statistics, dumped by STATS on the USB port
+*                  during detection (see perf_stats.h)
+* -DWINDOW_TIMING: sensor time stamps of the windows, a window with lost
+*                  samples is resampled onto the nominal grid before use
+*                  (see sample_clock.h)
 *
 * @note   if no compiler flag then data logging mode by default
 *******************************************************************************
@@ -16,8 +25,22 @@
 /* Includes ------------------------------------------------------------------*/
 #include "mbed.h"
 #include "bmi160.h"
+#include "acc_acquisition.h"
+#include "perf_stats.h"
+#include "window.h"
+#ifdef PERF_STATS
+#include "command_parser.h"
+#endif
+#ifdef NEAI_LIB
+#include "step_detector.h"
+#include "event_report.h"
+#endif
 #ifndef DATA_LOGGING
 #include "NanoEdgeAI.h"
+#include "learn_phase.h"
+#endif
+#ifdef LOG_BINARY
+#include "neai_stream.h"
 #endif
 #include <math.h>
 
@@ -26,40 +49,72 @@
 #define DATA_LOGGING
 #endif
 #ifdef DATA_LOGGING
-#define DATA_INPUT_USER 256
-#define AXIS_NUMBER 3
 #define LOG_NUMBER 50
-#else
-#define LEARNING_NUMBER 70 /* Number of learning signals */
+#endif
+#ifndef NEAI_HOP
+#define NEAI_HOP AccWindow::SAMPLES /* Detection on back-to-back windows */
 #endif
 
+/* Types ---------------------------------------------------------------------*/
+/* Samples and axes of every window, logged, learned or scored */
+typedef Window<256, 3> AccWindow;
+#ifndef DATA_LOGGING
+NEAI_WINDOW_CHECK(AccWindow);
+#endif
+SLIDING_HOP_CHECK(AccWindow, NEAI_HOP);
+
 /* Objects -------------------------------------------------------------------*/
-Serial pc(USBTX, USBRX);
-Serial bt(D5, D4, 9600);
+RawSerial pc(USBTX, USBRX); /* Read in the RX interrupt: no mutex, unlike Serial */
+RawSerial bt(D5, D4, 9600);
 Ticker toggle_led_ticker;
 DigitalOut myled(LED2);
 I2C i2c(D0, D1);
 BMI160_I2C imu(i2c, BMI160_I2C::I2C_ADRS_SDO_HI);
+InterruptIn imu_int(D2); /* BMI160 INT1 */
+AccAcquisition acq(imu, imu_int);
 BMI160::AccConfig accConfig;
+BMI160::FifoConfig fifoConfig;
 BMI160::SensorData accData;
+#ifdef LOG_BINARY
+NeaiStream log_stream(pc, bt);
+#endif
+#ifdef NEAI_LIB
+EventReport report(pc, bt); /* Step messages, detection never waits for the UARTs */
+#endif
+#ifdef PERF_STATS
+CommandParser stats_parser; /* STATS on the USB port */
+#endif
 
 /* Variables -----------------------------------------------------------------*/
 float acc_x = 0.F;
 float acc_y = 0.F;
 float acc_z = 0.F;
-float last_acc_x = 0.F;
-float last_acc_y = 0.F;
-float last_acc_z = 0.F;
 #ifndef DATA_LOGGING
 uint8_t similarity = 0;
-uint16_t learn_cpt = 0;
+/* 20 to 70 walking windows, a window scored every 5, stop on 4 scores >= 90% within 5 points */
+const LearnPhase::Config learn_config = {20, 70, 5, 4, 5, 90};
+#endif
+#ifdef PERF_STATS
+volatile bool stats_requested = false;
 #endif
 
 /* Buffer with accelerometer values for x-, y- and z-axis --------------------*/
-float acc_buffer[DATA_INPUT_USER * AXIS_NUMBER] = {0.F};
-float acc_buffer_x[DATA_INPUT_USER] = {0.F};
-float acc_buffer_y[DATA_INPUT_USER] = {0.F};
-float acc_buffer_z[DATA_INPUT_USER] = {0.F};
+acc_sample_t acc_window[2 * AccWindow::VALUES] = {0};
+SlidingWindow acc_sliding(acc_window, AccWindow::SAMPLES, AccWindow::AXES, NEAI_HOP);
+acc_sample_t *acc_buffer = acc_window; /* Latest window in acc_window */
+float acc_scale = 0.F; /* g per LSB of the accelerometer range */
+#if defined(WINDOW_INT16) && defined(NEAI_LIB)
+AccWindow::Of<float> neai_buffer; /* acc_buffer in g for NanoEdge AI */
+#endif
+#ifdef WINDOW_TIMING
+/* Latest window on the nominal grid after lost samples, acc_sliding keeps them as read */
+AccWindow acc_resampled;
+#endif
+#ifdef NEAI_LIB
+/* 800Hz decimated to 100Hz, at least 0.25s between steps, 0.15g swing */
+const StepDetector::Config step_config = {8, 25, 0.15F, 0.2F};
+StepDetector step_detector(step_config);
+#endif
 
 
 /* Functions prototypes ------------------------------------------------------*/
@@ -75,6 +130,18 @@ void toggle_led(void);
 void fill_acc_buffer(void);
 void get_acc_values(void);
 void fill_acc_buffer_2(void);
+void fill_acc_buffer_fifo(void);
+void slide_acc_buffer(void);
+#ifdef WINDOW_TIMING
+void resample_acc_buffer(void);
+#endif
+#ifdef NEAI_LIB
+float *neai_window(void);
+#endif
+#ifdef PERF_STATS
+void stats_command(void);
+void stats_dump(void);
+#endif
 /* BEGIN CODE-----------------------------------------------------------------*/
 
 int main()
@@ -143,114 +210,80 @@ void neai_library_test_mode()
 	/* Make a little pressure to start the learning process */
 
 	/* Waiting for a little preasure*/
-	while (learn_cpt < LEARNING_NUMBER) {
-
-		int start = 0;
-		while (not start){
-			get_acc_values();
-			if (fabs(acc_x)+fabs(acc_y)+fabs(acc_z) >= 4.0) {
-				start = 1;
-				wait_ms(3000);
-			}
+	int start = 0;
+	while (not start){
+		get_acc_values();
+		if (fabs(acc_x)+fabs(acc_y)+fabs(acc_z) >= 4.0) {
+			start = 1;
+			wait_ms(3000); /* Time to start walking */
 		}
+	}
 
-		/* Blink LED  during logging process */
-		toggle_led_ticker.attach(&toggle_led, 0.1);
-
-		/* Wait one seconds before starting learning process */
-		wait_ms(1000);
+	/* Blink LED  during logging process */
+	toggle_led_ticker.attach(&toggle_led, 0.1);
 
-		/* Learning process */
-		for (uint16_t i = 0; i < LEARNING_NUMBER; i++) {
-			fill_acc_buffer_2();
-			NanoEdgeAI_learn(acc_buffer);
-			pc.printf("%d percent \n", (int)(learn_cpt * 100) / LEARNING_NUMBER);
-			bt.printf("%d percent \n", (int)(learn_cpt * 100) / LEARNING_NUMBER);
-			learn_cpt++;
-		
+	/* Learning process */
+	/* Walking windows learned as fast as they are captured, until the
+	 * similarity of the windows not learned yet is stable (see learn_phase.h) */
+	LearnPhase learn_phase(learn_config);
+	while (!learn_phase.done()) {
+		fill_acc_buffer_2();
+		float *window = neai_window();
+		if (learn_phase.scoreNext()) {
+			PERF_TIME(PERF_DETECT, learn_phase.scored(NanoEdgeAI_detect(window)));
+			PERF_TIME(PERF_REPORT, report.printf("LEARN %u windows, similarity %u, spread %u\n",
+			                                     learn_phase.windows(), learn_phase.similarity(),
+			                                     learn_phase.spread()));
 		}
-
-		/* Stop blink LED (end of logging process) */
-		toggle_led_ticker.detach();
-		myled = 0;
+		PERF_TIME(PERF_LEARN, NanoEdgeAI_learn(window));
+		learn_phase.learned();
+		PERF_TIME(PERF_REPORT, report.printf("%u percent \n", learn_phase.progress()));
 	}
+	report.printf("LEARN %s after %u windows\n",
+	              (learn_phase.state() == LearnPhase::CONVERGED) ? "converged" : "stopped",
+	              learn_phase.windows());
+
+	/* Stop blink LED (end of logging process) */
+	toggle_led_ticker.detach();
+	myled = 0;
 		
 	/* Detection process */
 	/* LED off: no movement */
 	/* LED on: one more step */
+	/* Steps are counted sample by sample, every step of a window counts */
 	int nb_pas = 0;
-	int first = 1;
-	float threshold;
-	float threshold_2;
-	char var;
+	uint16_t fresh = AccWindow::SAMPLES; /* New samples at the end of the window */
+	bool walking = false;
+	fill_acc_buffer_2();
+	step_detector.reset();
 	while(1) {
 		myled = 0;
-		fill_acc_buffer_2();
-		similarity = NanoEdgeAI_detect(acc_buffer);
-		if (similarity >= 90 && first) {
-			bt.printf("MARCHE_0\n");
-			float max_x = -100.0; float max_y = -100.0; float max_z = -100.0;
-			float min_x = 100.0; float min_y = 100.0; float min_z = 100.0;
-			for (uint16_t i = 0; i < DATA_INPUT_USER; i++) {
-				//bt.printf("%d\n", i);
-				if (acc_buffer_x[i] > max_x) {max_x = acc_buffer_x[i];}
-				else if (acc_buffer_x[i] < min_x) {min_x = acc_buffer_x[i];}
-				if (acc_buffer_y[i] > max_y) {max_y = acc_buffer_y[i];}
-				else if (acc_buffer_y[i] < min_y) {min_y = acc_buffer_y[i];}
-				if (acc_buffer_z[i] > max_z) {max_z = acc_buffer_z[i];}
-				else if (acc_buffer_z[i] < min_z) {min_z = acc_buffer_z[i];}
-			}
-			//bt.printf("Milieu\n");
-			if (fabs(max_x - min_x) >= fabs(max_y - min_y) && fabs(max_x - min_x) >= fabs(max_z - min_z)) {threshold = (max_x + min_x)/2 ;var ='x';}
-			else if (fabs(max_y - min_y) >= fabs(max_x - min_x) && fabs(max_y - min_y) >= fabs(max_z - min_z)) {threshold = (max_y + min_y)/2;var='y';}
-			else {threshold = (max_z + min_z)/2;var='z';}
-			first = 0;
-			// nb_pas ++;
-			myled = 1;
-			pc.printf("Steps : %d\n", nb_pas);
-			bt.printf("Steps : %d\n", nb_pas);
-			//bt.printf("End\n");
-			//wait_ms(300);
-
-		} 
-		else if (similarity >= 90){
-			bt.printf("MARCHE_1\n");
-			float max_x = -100.0; float max_y = -100.0; float max_z = -100.0;
-			float min_x = 100.0; float min_y = 100.0; float min_z = 100.0;
-			if (var == 'x') {
-				for (uint16_t i = 0; i < DATA_INPUT_USER ; i++) {
-					if (acc_buffer_x[i] > max_x) {max_x = acc_buffer_x[i];}
-					else if (acc_buffer_x[i] < min_x) {min_x = acc_buffer_x[i];}
-				}
-				threshold_2 = (max_x+min_x)/2;
-			}
-			else if (var == 'y') {
-				for (uint16_t i = 0; i < DATA_INPUT_USER; i++) {
-					if (acc_buffer_y[i] > max_y) {max_y = acc_buffer_y[i];}
-					else if (acc_buffer_y[i] < min_y) {min_y = acc_buffer_y[i];}
-				}
-				threshold_2 = (max_y+min_y)/2;
-			}
-			else {
-				for (uint16_t i = 0; i < DATA_INPUT_USER; i++) {
-					if (acc_buffer_z[i] > max_z) {max_z = acc_buffer_z[i];}
-					else if (acc_buffer_z[i] < min_z) {min_z = acc_buffer_z[i];}
-				}
-				threshold_2 = (max_z+min_z)/2;
+#ifdef PERF_STATS
+		stats_dump();
+#endif
+		PERF_TIME(PERF_DETECT, similarity = NanoEdgeAI_detect(neai_window()));
+		/* The detector follows the signal even when not walking */
+		uint16_t steps = step_detector.addSamples(acc_buffer + (AccWindow::SAMPLES - fresh) * AccWindow::AXES,
+		                                          fresh, acc_scale);
+		/* Walking state reported on changes only, the queue holds SLOTS messages */
+		if (similarity >= 90) {
+			if (!walking) {
+				report.printf("MARCHE\n");
+				walking = true;
 			}
-			if (threshold_2 > 1.1*threshold){
-				nb_pas++;
-				pc.printf("Steps : %d\n", nb_pas);
-				bt.printf("Steps : %d\n", nb_pas);
+			if (steps > 0) {
+				nb_pas += steps;
+				PERF_TIME(PERF_REPORT, report.printf("Steps : %d\n", nb_pas));
 				myled = 1;
-				//wait_ms(300);
 			}
-			threshold = threshold_2;
 		}
-		else {
-			bt.printf("MARCHE PAS\n");
-			first = 1;
+		else if (walking) {
+			report.printf("MARCHE PAS\n");
+			walking = false;
 		}
+		/* Next window: NEAI_HOP new samples, the FIFO kept sampling meanwhile */
+		slide_acc_buffer();
+		fresh = NEAI_HOP;
 	}
 }
 #endif
@@ -259,9 +292,14 @@ void neai_library_test_mode()
 void init()
 {
 	pc.baud(115200);
+#ifdef PERF_STATS
+	PerfStats::start();
+	pc.attach(&stats_command);
+#endif
 	init_bmi160();
 #ifdef NEAI_LIB
 	NanoEdgeAI_initialize();
+	report.start();
 #endif
 }
 
@@ -275,6 +313,19 @@ void init_bmi160()
 	accConfig.bwp = BMI160::ACC_BWP_2;
 	accConfig.odr = BMI160::ACC_ODR_11; /* Accelerometer output data rate < 800Hz */
 	imu.setSensorConfig(accConfig);
+	acc_scale = BMI160::getAccScale(accConfig.range);
+	fifoConfig = BMI160::DEFAULT_FIFO_CONFIG; /* Headerless accelerometer frames */
+#ifdef DATA_LOGGING
+	fifoConfig.accDowns = BMI160::FIFO_DOWNS_8; /* Logging at 100Hz */
+#endif
+	imu.setFifoConfig(fifoConfig);
+#ifdef WINDOW_TIMING
+	/* Every FIFO drain stamped with the sensor time, at the FIFO frame rate */
+	static SampleClock acc_clock(BMI160::getFifoFramePeriod(accConfig.odr, fifoConfig.accDowns));
+	acq.setClock(&acc_clock);
+#endif
+	/* Data ready interrupt on INT1, one pulse per new sample */
+	acq.start(accConfig.range, BMI160::INT1);
 	wait_ms(100);
 }
 
@@ -287,57 +338,119 @@ void toggle_led(void)
 
 void fill_acc_buffer()
 {
-	for (uint16_t i = 0; i < DATA_INPUT_USER; i++) {
-		get_acc_values();
-		acc_buffer[AXIS_NUMBER * i] = acc_x;
-		acc_buffer[AXIS_NUMBER * i + 1] = acc_y;
-		acc_buffer[AXIS_NUMBER * i + 2] = acc_z;
-		acc_buffer_x[i] = acc_x;
-		acc_buffer_y[i] = acc_y;
-		acc_buffer_z[i] = acc_z;
-		wait_ms(10);
-	}
+	fill_acc_buffer_fifo();
 
 #ifndef NEAI_LIB
 	/* Print accelerometer buffer for data logging and neai emulator test modes */
-	for (uint16_t isample = 0; isample < AXIS_NUMBER * DATA_INPUT_USER - 1; isample++) {
-		pc.printf("%.4f ", acc_buffer[isample]);
-		bt.printf("%.4f ", acc_buffer[isample]);
+#ifdef LOG_BINARY
+	log_stream.writeWindow(acc_buffer, AccWindow::SAMPLES, AccWindow::AXES, accConfig);
+#else
+	for (uint16_t isample = 0; isample < AccWindow::VALUES - 1; isample++) {
+		pc.printf("%.4f ", acc_sample_to_g(acc_buffer[isample], acc_scale));
+		bt.printf("%.4f ", acc_sample_to_g(acc_buffer[isample], acc_scale));
 	}
-	pc.printf("%.4f\n", acc_buffer[AXIS_NUMBER * DATA_INPUT_USER - 1]);
-	bt.printf("%.4f\n", acc_buffer[AXIS_NUMBER * DATA_INPUT_USER - 1]);
+	pc.printf("%.4f\n", acc_sample_to_g(acc_buffer[AccWindow::VALUES - 1], acc_scale));
+	bt.printf("%.4f\n", acc_sample_to_g(acc_buffer[AccWindow::VALUES - 1], acc_scale));
+#endif
 	wait_ms(100);
 #endif	
 }
 
 void fill_acc_buffer_2()
 {
-	for (uint16_t i = 0; i < DATA_INPUT_USER; i++) {
-		get_acc_values();
-		acc_buffer[AXIS_NUMBER * i] = acc_x;
-		acc_buffer[AXIS_NUMBER * i + 1] = acc_y;
-		acc_buffer[AXIS_NUMBER * i + 2] = acc_z;
-		acc_buffer_x[i] = acc_x;
-		acc_buffer_y[i] = acc_y;
-		acc_buffer_z[i] = acc_z;
-		wait_ms(0.05);
+	fill_acc_buffer_fifo();
+}
+
+
+void fill_acc_buffer_fifo()
+{
+	/* Fresh window: drop older samples and fill a whole window */
+	acq.flushFifo();
+	acc_sliding.reset();
+	slide_acc_buffer();
+}
+
+
+void slide_acc_buffer()
+{
+	/* FIFO method: drain whole bursts of samples straight into the window */
+	/* The sample rate is set by the FIFO down sampling (see init_bmi160) */
+	acq.slideWindow(acc_sliding);
+	acc_buffer = acc_sliding.window();
+#ifdef WINDOW_TIMING
+	resample_acc_buffer();
+#endif
+}
+
+
+#ifdef WINDOW_TIMING
+
+void resample_acc_buffer()
+{
+	/* Samples lost by the FIFO: the window is put back on the nominal grid */
+	WindowTiming timing;
+	if (!acq.windowTiming(AccWindow::SAMPLES, timing) || (timing.missing == 0)) {
+		return;
+	}
+	AccWindow::copy(acc_resampled.values, acc_buffer);
+	if (SampleClock::resample(timing, acc_resampled.values, AccWindow::SAMPLES, AccWindow::AXES)) {
+		acc_buffer = acc_resampled.values;
+		PERF_COUNT(PERF_RESAMPLED, timing.missing);
+	}
+#ifdef NEAI_LIB
+	report.printf("GAP %lu samples, %.1f Hz\n", (unsigned long)timing.missing, timing.odr);
+#endif
+}
+#endif
+
+
+#ifdef NEAI_LIB
+
+float *neai_window()
+{
+	/* With WINDOW_INT16 the raw counts are scaled here only, for NanoEdge AI */
+#ifdef WINDOW_INT16
+	AccWindow::toG(neai_buffer.values, acc_buffer, acc_scale);
+	return neai_buffer.values;
+#else
+	return acc_buffer;
+#endif
+}
+#endif
+
+
+#ifdef PERF_STATS
+void stats_command()
+{
+	/* RX interrupt: O(1) per byte, the main loop dumps the statistics */
+	Command command;
+	while (pc.readable()) {
+		if (stats_parser.feed(pc.getc(), command) && (command.type == CMD_STATS)) {
+			stats_requested = true;
+		}
 	}
 }
 
 
-void get_acc_values()
+void stats_dump()
 {
-	/* Polling method to get a complete buffer */
-	do {
-		imu.getSensorXYZ(accData, accConfig.range);
-		acc_x = accData.xAxis.scaled;
-		acc_y = accData.yAxis.scaled;
-		acc_z = accData.zAxis.scaled;
+	if (stats_requested) {
+		stats_requested = false;
+		/* Statistics since the previous STATS, then a new period */
+		PerfStats::dump(pc);
+		PerfStats::reset();
 	}
-	while (acc_x == last_acc_x && acc_y == last_acc_y && acc_z == last_acc_z);
-	
-	last_acc_x = acc_x;
-	last_acc_y = acc_y;
-	last_acc_z = acc_z;
 }
+#endif
+
+
+void get_acc_values()
+{
+	/* Interrupt method: sleep until the next sample is ready */
+	acq.readSample(accData);
+	acc_x = accData.xAxis.scaled;
+	acc_y = accData.yAxis.scaled;
+	acc_z = accData.zAxis.scaled;
+}
+
 /* END CODE-------------------------------------------------------------------*/
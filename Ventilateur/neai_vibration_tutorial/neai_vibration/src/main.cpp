@@ -9,6 +9,18 @@
 * -DDATA_LOGGING : data logging mode for collecting data
 * -DNEAI_EMU     : test mode with NanoEdge AI Emulator 
 * -DNEAI_LIB     : test mode with NanoEdge AI Library
+* -DIMU_SPI      : BMI160 on SPI instead of I2C
+* -DLOG_BINARY   : binary framed windows instead of text (see neai_stream.h)
+* -DNEAI_HOP=<n> : overlapping windows, n new samples between two windows,
+*                  n dividing the window
+* -DWINDOW_INT16 : windows stored as raw int16 counts, half the RAM
+* -DPERF_STATS   : timing statistics, dumped by STATS on the USB port
+*                  during detection (see perf_stats.h)
+* -DWINDOW_TIMING: sensor time stamps of the captured windows, a window with
+*                  lost samples is resampled onto the nominal grid before use
+*                  (see sample_clock.h)
+* -DIMU_GYRO     : 6 values per sample, accelerometer then gyroscope, both
+*                  from the same FIFO frames (text output, float windows)
 *
 * @note   if no compiler flag then data logging mode by default
 *******************************************************************************
@@ -17,8 +29,24 @@
 /* Includes ------------------------------------------------------------------*/
 #include "mbed.h"
 #include "bmi160.h"
-#ifndef DATA_LOGGING
-#include "NanoEdgeAI.h"
+#include "acc_capture.h"
+#include "perf_stats.h"
+#include "window.h"
+#ifdef PERF_STATS
+#include "command_parser.h"
+#endif
+#ifdef NEAI_HOP
+#include "sliding_window.h"
+#endif
+#if !defined(DATA_LOGGING) && (defined(NEAI_EMU) || defined(NEAI_LIB))
+#include "NanoEdgeAI.h" /* Not in the default data logging mode */
+#include "learn_phase.h"
+#endif
+#ifdef NEAI_LIB
+#include "event_report.h"
+#endif
+#ifdef LOG_BINARY
+#include "neai_stream.h"
 #endif
 
 /* Defines -------------------------------------------------------------------*/
@@ -26,36 +54,84 @@
 #define DATA_LOGGING
 #endif
 #ifdef DATA_LOGGING
-#define DATA_INPUT_USER 512
-#define AXIS_NUMBER 3
 #define LOG_NUMBER 100
+#endif
+#if defined(IMU_GYRO) && (defined(WINDOW_INT16) || defined(LOG_BINARY))
+#error "IMU_GYRO windows are float and printed as text"
+#endif
+#define CAPTURE_SLOTS 2 /* Ping-pong: one window captured while the other is used */
+#ifdef NEAI_HOP
+#define CAPTURE_SAMPLES NEAI_HOP /* Captured hop by hop, windows built by acc_sliding */
 #else
-#define LEARNING_NUMBER 90 /* Number of learning signals */
+#define CAPTURE_SAMPLES AccWindow::SAMPLES
+#endif
+
+/* Types ---------------------------------------------------------------------*/
+/* Samples and axes of every window, logged, learned or scored */
+#ifdef IMU_GYRO
+typedef Window<512, 6> AccWindow; /* Accelerometer then gyroscope */
+#else
+typedef Window<512, 3> AccWindow;
+#endif
+#ifndef DATA_LOGGING
+NEAI_WINDOW_CHECK(AccWindow);
+#endif
+CAPTURE_SLOTS_CHECK(CAPTURE_SLOTS);
+#ifdef NEAI_HOP
+SLIDING_HOP_CHECK(AccWindow, NEAI_HOP);
 #endif
 
 /* Objects -------------------------------------------------------------------*/
-Serial pc(USBTX, USBRX);
+RawSerial pc(USBTX, USBRX); /* Read in the RX interrupt: no mutex, unlike Serial */
 Ticker toggle_led_ticker;
 DigitalOut myled(LED2);
+#ifdef IMU_SPI
+SPI spi(A6, A5, A4); /* MOSI, MISO, SCK */
+DigitalOut imu_cs(A3);
+BMI160_SPI imu(spi, imu_cs);
+#else
 I2C i2c(D0, D1);
 BMI160_I2C imu(i2c, BMI160_I2C::I2C_ADRS_SDO_HI);
+#endif
 BMI160::AccConfig accConfig;
-BMI160::SensorData accData;
+#ifdef IMU_GYRO
+BMI160::GyroConfig gyroConfig;
+#endif
+BMI160::FifoConfig fifoConfig;
+InterruptIn imu_int(D2); /* BMI160 INT1: FIFO watermark */
+#ifdef LOG_BINARY
+NeaiStream log_stream(pc);
+#endif
+#ifdef NEAI_LIB
+EventReport report(pc); /* Learning progress and similarity, never waiting for the UART */
+#endif
+#ifdef PERF_STATS
+CommandParser stats_parser; /* STATS on the USB port */
+#endif
 
 /* Variables -----------------------------------------------------------------*/
-float acc_x = 0.F;
-float acc_y = 0.F;
-float acc_z = 0.F;
-float last_acc_x = 0.F;
-float last_acc_y = 0.F;
-float last_acc_z = 0.F;
 #ifndef DATA_LOGGING
 uint8_t similarity = 0;
-uint16_t learn_cpt = 0;
+/* 30 to 90 windows, a window scored every 5, stop on 4 scores >= 90% within 5 points */
+const LearnPhase::Config learn_config = {30, 90, 5, 4, 5, 90};
+#endif
+#ifdef PERF_STATS
+volatile bool stats_requested = false;
 #endif
 
 /* Buffer with accelerometer values for x-, y- and z-axis --------------------*/
-float acc_buffer[DATA_INPUT_USER * AXIS_NUMBER] = {0.F};
+acc_sample_t acc_storage[CAPTURE_SLOTS * CAPTURE_SAMPLES * AccWindow::AXES] = {0};
+WindowRing acc_ring(acc_storage, CAPTURE_SLOTS, CAPTURE_SAMPLES, AccWindow::AXES);
+AccCapture acc_capture(imu, imu_int, acc_ring);
+#ifdef NEAI_HOP
+acc_sample_t acc_window[2 * AccWindow::VALUES] = {0};
+SlidingWindow acc_sliding(acc_window, AccWindow::SAMPLES, AccWindow::AXES, NEAI_HOP);
+#endif
+acc_sample_t *acc_buffer = NULL; /* Current window, owned until the next fill_acc_buffer() */
+float acc_scale = 0.F; /* g per LSB of the accelerometer range */
+#if defined(WINDOW_INT16) && defined(NEAI_LIB)
+AccWindow::Of<float> neai_buffer; /* acc_buffer in g for NanoEdge AI */
+#endif
 
 /* Functions prototypes ------------------------------------------------------*/
 #ifdef DATA_LOGGING
@@ -71,7 +147,16 @@ void init(void);
 void init_bmi160(void);
 void toggle_led(void);
 void fill_acc_buffer(void);
-void get_acc_values(void);
+#ifdef WINDOW_TIMING
+acc_sample_t *timed_window(void);
+#endif
+#ifdef NEAI_LIB
+float *neai_window(void);
+#endif
+#ifdef PERF_STATS
+void stats_command(void);
+void stats_dump(void);
+#endif
 
 /* BEGIN CODE-----------------------------------------------------------------*/
 /**
@@ -149,7 +234,7 @@ void neai_emulator_test_mode()
 	/* Press user button to start */
 	while(1) {
 			
-			pc.printf("%d\n", LEARNING_NUMBER);
+			pc.printf("%d\n", learn_config.maxWindows);
 			while(1) {
 				fill_acc_buffer();
 			
@@ -168,30 +253,33 @@ void neai_emulator_test_mode()
 void neai_library_test_mode()
 {
 	/* Learning process */
-	/* Press user button to start the learning process */
-	while (learn_cpt < LEARNING_NUMBER) {
-		
-			/* Wait one seconds before starting learning process */
-			wait_ms(1000);
-
-			/* Learning process for one speed */
-			for (uint16_t i = 0; i < LEARNING_NUMBER; i++) {
-				fill_acc_buffer();
-				NanoEdgeAI_learn(acc_buffer);
-				pc.printf("%d\n", (int)(learn_cpt * 100) / LEARNING_NUMBER);
-				learn_cpt++;
-			
+	/* Windows learned as fast as they are captured, until the similarity of
+	 * the windows not learned yet is stable (see learn_phase.h) */
+	LearnPhase learn_phase(learn_config);
+	while (!learn_phase.done()) {
+		fill_acc_buffer();
+		float *window = neai_window();
+		if (learn_phase.scoreNext()) {
+			PERF_TIME(PERF_DETECT, learn_phase.scored(NanoEdgeAI_detect(window)));
 		}
+		PERF_TIME(PERF_LEARN, NanoEdgeAI_learn(window));
+		learn_phase.learned();
+		/* At most 99: the demo reads 100 and more as similarity + 100 */
+		int progress = (learn_phase.progress() < 100) ? learn_phase.progress() : 99;
+		PERF_TIME(PERF_REPORT, report.printf("%d\n", progress));
 	}
-		
+	
 	/* Detection process */
 	/* LED off: nominal signal */
 	/* LED on: anomaly is detected */
 	myled = 0;
 	while(1) {
+#ifdef PERF_STATS
+		stats_dump();
+#endif
 		fill_acc_buffer();
-		similarity = NanoEdgeAI_detect(acc_buffer);
-		pc.printf("%d\n", similarity + 100);
+		PERF_TIME(PERF_DETECT, similarity = NanoEdgeAI_detect(neai_window()));
+		PERF_TIME(PERF_REPORT, report.printf("%d\n", similarity + 100));
 		if (similarity < 90) {
 			myled = 1; /* Anomaly: turn on LED */
 		} else {
@@ -210,9 +298,14 @@ void neai_library_test_mode()
 void init()
 {
 	pc.baud(115200);
+#ifdef PERF_STATS
+	PerfStats::start();
+	pc.attach(&stats_command);
+#endif
 	init_bmi160();
 #ifdef NEAI_LIB
 	NanoEdgeAI_initialize();
+	report.start();
 #endif
 }
 
@@ -224,6 +317,12 @@ void init()
  */
 void init_bmi160()
 {
+#ifdef IMU_SPI
+	spi.format(8, 3);
+	spi.frequency(10000000); /* BMI160 SPI clock up to 10MHz */
+#else
+	i2c.frequency(400000); /* Fast mode: a watermark burst must drain well within a window */
+#endif
 	imu.setSensorPowerMode(BMI160::ACC, BMI160::NORMAL);
 	wait_ms(10);
 	accConfig.range = BMI160::SENS_2G; /* Accelerometer range +-2G */
@@ -231,7 +330,27 @@ void init_bmi160()
 	accConfig.bwp = BMI160::ACC_BWP_2;
 	accConfig.odr = BMI160::ACC_ODR_11; /* Accelerometer output data rate < 800Hz */
 	imu.setSensorConfig(accConfig);
+	acc_scale = BMI160::getAccScale(accConfig.range);
+	fifoConfig = BMI160::DEFAULT_FIFO_CONFIG; /* Headerless accelerometer frames */
+#ifdef IMU_GYRO
+	imu.setSensorPowerMode(BMI160::GYRO, BMI160::NORMAL);
+	wait_ms(80); /* Gyroscope start-up time */
+	gyroConfig.range = BMI160::DPS_2000;
+	gyroConfig.bwp = BMI160::GYRO_BWP_2;
+	gyroConfig.odr = BMI160::GYRO_ODR_11; /* Same rate as the accelerometer: one frame holds both */
+	imu.setSensorConfig(gyroConfig);
+	fifoConfig.gyroEnable = true;
+	acc_capture.enableGyro(gyroConfig.range);
+#endif
+	imu.setFifoConfig(fifoConfig);
+#ifdef WINDOW_TIMING
+	/* Every FIFO drain stamped with the sensor time, at the FIFO frame rate */
+	static SampleClock acc_clock(BMI160::getFifoFramePeriod(accConfig.odr, fifoConfig.accDowns));
+	acc_capture.setClock(&acc_clock);
+#endif
 	wait_ms(100);
+	/* Continuous capture from now on, windows are taken by fill_acc_buffer() */
+	acc_capture.start(accConfig.range, BMI160::INT1);
 }
 
 /**
@@ -248,46 +367,124 @@ void toggle_led(void)
 /**
  * @brief  Fill accelerometer buffer
  * acc_buffer[] = [ax0, ay0, az0, ax1, ay1, az1, ...]
+ * With IMU_GYRO: [ax0, ay0, az0, gx0, gy0, gz0, ax1, ...], gyroscope in dps
+ * The previous window is handed back to the capture thread, which keeps
+ * filling the other slot while this one is learned, scored or printed.
+ * With NEAI_HOP, each captured hop slides acc_buffer instead.
  *
  * @param  None
  * @retval None
  */
 void fill_acc_buffer()
 {
-	for (uint16_t i = 0; i < DATA_INPUT_USER; i++) {
-		get_acc_values();
-		acc_buffer[AXIS_NUMBER * i] = acc_x;
-		acc_buffer[AXIS_NUMBER * i + 1] = acc_y;
-		acc_buffer[AXIS_NUMBER * i + 2] = acc_z;
+#ifdef NEAI_HOP
+	bool due = false;
+	while (!due) {
+#ifdef WINDOW_TIMING
+		due = acc_sliding.push(timed_window(), NEAI_HOP);
+#else
+		due = acc_sliding.push(acc_capture.waitWindow(), NEAI_HOP);
+#endif
+		acc_capture.releaseWindow();
+	}
+	acc_buffer = acc_sliding.window();
+#else
+	if (acc_buffer != NULL) {
+		acc_capture.releaseWindow();
 	}
+#ifdef WINDOW_TIMING
+	acc_buffer = timed_window();
+#else
+	acc_buffer = acc_capture.waitWindow();
+#endif
+#endif
 #ifndef NEAI_LIB
 	/* Print accelerometer buffer for data logging and neai emulator test modes */
-	for (uint16_t isample = 0; isample < AXIS_NUMBER * DATA_INPUT_USER - 1; isample++) {
-		pc.printf("%.4f ", acc_buffer[isample]);
+#ifdef LOG_BINARY
+	log_stream.writeWindow(acc_buffer, AccWindow::SAMPLES, AccWindow::AXES, accConfig);
+#else
+	for (uint16_t isample = 0; isample < AccWindow::VALUES - 1; isample++) {
+		pc.printf("%.4f ", acc_sample_to_g(acc_buffer[isample], acc_scale));
 	}
-	pc.printf("%.4f\n", acc_buffer[AXIS_NUMBER * DATA_INPUT_USER - 1]);
+	pc.printf("%.4f\n", acc_sample_to_g(acc_buffer[AccWindow::VALUES - 1], acc_scale));
+#endif
 #endif	
 }
 
+#ifdef WINDOW_TIMING
 /**
- * @brief  Get accelerometer values (x-, y- and z-axis)
+ * @brief  Wait for the next captured window and put it back on the nominal
+ * grid if the FIFO lost samples inside it
+ * The window belongs to the application until releaseWindow(), so it is
+ * resampled in place.
+ *
+ * @param  None
+ * @retval Window, valid until releaseWindow()
+ */
+acc_sample_t *timed_window()
+{
+	acc_sample_t *window = acc_capture.waitWindow();
+	WindowTiming timing;
+	/* Counted, not printed: the library mode output stays numeric */
+	if (acc_capture.windowTiming(timing) && (timing.missing > 0)
+	    && SampleClock::resample(timing, window, CAPTURE_SAMPLES, AccWindow::AXES)) {
+		PERF_COUNT(PERF_RESAMPLED, timing.missing);
+	}
+	return window;
+}
+#endif
+#ifdef PERF_STATS
+/**
+ * @brief  STATS command on the USB port, RX interrupt
+ * O(1) per byte, the statistics are dumped by the main loop.
  *
  * @param  None
  * @retval None
  */
-void get_acc_values()
+void stats_command()
 {
-	/* Polling method to get a complete buffer */
-	do {
-		imu.getSensorXYZ(accData, accConfig.range);
-		acc_x = accData.xAxis.scaled;
-		acc_y = accData.yAxis.scaled;
-		acc_z = accData.zAxis.scaled;
+	Command command;
+	while (pc.readable()) {
+		if (stats_parser.feed(pc.getc(), command) && (command.type == CMD_STATS)) {
+			stats_requested = true;
+		}
 	}
-	while (acc_x == last_acc_x && acc_y == last_acc_y && acc_z == last_acc_z);
-	
-	last_acc_x = acc_x;
-	last_acc_y = acc_y;
-	last_acc_z = acc_z;
 }
+
+/**
+ * @brief  Dump the statistics since the previous STATS, then start a new period
+ *
+ * @param  None
+ * @retval None
+ */
+void stats_dump()
+{
+	if (stats_requested) {
+		stats_requested = false;
+		PerfStats::dump(pc);
+		PerfStats::reset();
+	}
+}
+#endif
+
+#ifdef NEAI_LIB
+/**
+ * @brief  Current window in the float layout NanoEdge AI expects
+ * With WINDOW_INT16, the raw counts are scaled into neai_buffer here and
+ * nowhere else.
+ *
+ * @param  None
+ * @retval Window in g
+ */
+float *neai_window()
+{
+#ifdef WINDOW_INT16
+	AccWindow::toG(neai_buffer.values, acc_buffer, acc_scale);
+	return neai_buffer.values;
+#else
+	return acc_buffer;
+#endif
+}
+#endif
+
 /* END CODE-------------------------------------------------------------------*/